@@ -1,3 +1,5 @@
+using System.IO;
+using System.Text;
 using Xunit;
 
 namespace Veldrid.SPIRV.Tests
@@ -80,6 +82,30 @@ namespace Veldrid.SPIRV.Tests
             Assert.NotNull(result.FragmentShader);
         }
 
+        [Fact]
+        public void FreezeSpecializations_RemovesSpecializationConstants()
+        {
+            byte[] vsBytes = TestUtil.LoadBytes("instance.vert.spv");
+            byte[] fsBytes = TestUtil.LoadBytes("instance.frag.spv");
+            SpecializationConstant[] specializations =
+            {
+                new SpecializationConstant(100, 8u),
+                new SpecializationConstant(101, true),
+                new SpecializationConstant(102, 0.5f),
+            };
+            CrossCompileOptions options = new CrossCompileOptions(false, false, specializations)
+            {
+                Optimization = SpirvOptimization.FreezeSpecializations
+            };
+            VertexFragmentCompilationResult result = SpirvCompilation.CompileVertexFragment(
+                vsBytes,
+                fsBytes,
+                CrossCompileTarget.GLSL,
+                options);
+            Assert.DoesNotContain("SPIRV_CROSS_CONSTANT_ID", result.VertexShader);
+            Assert.DoesNotContain("SPIRV_CROSS_CONSTANT_ID", result.FragmentShader);
+        }
+
         [Theory]
         [InlineData("simple.comp", CrossCompileTarget.HLSL)]
         [InlineData("simple.comp", CrossCompileTarget.GLSL)]
@@ -100,6 +126,203 @@ namespace Veldrid.SPIRV.Tests
             Assert.NotNull(result.ComputeShader);
         }
 
+        [Fact]
+        public void VertexFragmentFiles_MatchesInMemoryCompilation()
+        {
+            byte[] vsBytes = TestUtil.LoadBytes("planet.vert.spv");
+            byte[] fsBytes = TestUtil.LoadBytes("planet.frag.spv");
+            string directory = Path.Combine(Path.GetTempPath(), "veldrid-spirv-\u00e9\u4e2d-" + Path.GetRandomFileName());
+            Directory.CreateDirectory(directory);
+            try
+            {
+                string vsPath = Path.Combine(directory, "plan\u00e8te.vert.spv");
+                string fsPath = Path.Combine(directory, "plan\u00e8te.frag.spv");
+                File.WriteAllBytes(vsPath, vsBytes);
+                File.WriteAllBytes(fsPath, fsBytes);
+                CrossCompileOptions options = new CrossCompileOptions(false, false, new SpecializationConstant(100, 125u));
+
+                VertexFragmentCompilationResult fromFiles = SpirvCompilation.CompileVertexFragmentFiles(
+                    vsPath,
+                    fsPath,
+                    CrossCompileTarget.GLSL,
+                    options);
+                VertexFragmentCompilationResult fromMemory = SpirvCompilation.CompileVertexFragment(
+                    vsBytes,
+                    fsBytes,
+                    CrossCompileTarget.GLSL,
+                    options);
+
+                Assert.Equal(fromMemory.VertexShader, fromFiles.VertexShader);
+                Assert.Equal(fromMemory.FragmentShader, fromFiles.FragmentShader);
+            }
+            finally
+            {
+                Directory.Delete(directory, true);
+            }
+        }
+
+        [Fact]
+        public void VertexFragmentToStreams_MatchesReturnedText()
+        {
+            byte[] vsBytes = TestUtil.LoadBytes("planet.vert.spv");
+            byte[] fsBytes = TestUtil.LoadBytes("planet.frag.spv");
+            CrossCompileOptions options = new CrossCompileOptions(false, true);
+            using (MemoryStream vertexOutput = new MemoryStream())
+            using (MemoryStream fragmentOutput = new MemoryStream())
+            {
+                SpirvReflection reflection = SpirvCompilation.CompileVertexFragmentToStreams(
+                    vsBytes,
+                    fsBytes,
+                    CrossCompileTarget.MSL,
+                    options,
+                    vertexOutput,
+                    fragmentOutput);
+                VertexFragmentCompilationResult expected = SpirvCompilation.CompileVertexFragment(
+                    vsBytes,
+                    fsBytes,
+                    CrossCompileTarget.MSL,
+                    options);
+
+                Assert.Equal(expected.VertexShader, Encoding.UTF8.GetString(vertexOutput.ToArray()));
+                Assert.Equal(expected.FragmentShader, Encoding.UTF8.GetString(fragmentOutput.ToArray()));
+                Assert.Equal(expected.Reflection.ResourceLayouts.Length, reflection.ResourceLayouts.Length);
+            }
+        }
+
+        [Fact]
+        public void MultiTarget_MatchesSingleTargetCompilations()
+        {
+            byte[] vsBytes = TestUtil.LoadBytes("planet.vert.spv");
+            byte[] fsBytes = TestUtil.LoadBytes("planet.frag.spv");
+            CrossCompileTarget[] targets =
+            {
+                CrossCompileTarget.HLSL,
+                CrossCompileTarget.GLSL,
+                CrossCompileTarget.ESSL,
+                CrossCompileTarget.MSL,
+            };
+            CrossCompileOptions options = new CrossCompileOptions(true, true);
+
+            VertexFragmentCompilationResult[] results = SpirvCompilation.CompileVertexFragment(
+                vsBytes,
+                fsBytes,
+                targets,
+                options);
+
+            Assert.Equal(targets.Length, results.Length);
+            for (int i = 0; i < targets.Length; i++)
+            {
+                VertexFragmentCompilationResult single = SpirvCompilation.CompileVertexFragment(
+                    vsBytes,
+                    fsBytes,
+                    targets[i],
+                    options);
+                Assert.Equal(single.VertexShader, results[i].VertexShader);
+                Assert.Equal(single.FragmentShader, results[i].FragmentShader);
+            }
+        }
+
+        [Fact]
+        public void VertexFragmentBatch_MatchesSingleCompilations()
+        {
+            byte[][] vsBytes = { TestUtil.LoadBytes("planet.vert.spv"), TestUtil.LoadBytes("instance.vert.spv") };
+            byte[][] fsBytes = { TestUtil.LoadBytes("planet.frag.spv"), TestUtil.LoadBytes("instance.frag.spv") };
+            CrossCompileOptions options = new CrossCompileOptions(false, false, new SpecializationConstant(100, 125u));
+
+            VertexFragmentCompilationResult[] results = SpirvCompilation.CompileVertexFragmentBatch(
+                vsBytes,
+                fsBytes,
+                CrossCompileTarget.HLSL,
+                options);
+
+            Assert.Equal(2, results.Length);
+            for (int i = 0; i < results.Length; i++)
+            {
+                VertexFragmentCompilationResult single = SpirvCompilation.CompileVertexFragment(
+                    vsBytes[i],
+                    fsBytes[i],
+                    CrossCompileTarget.HLSL,
+                    options);
+                Assert.Equal(single.VertexShader, results[i].VertexShader);
+                Assert.Equal(single.FragmentShader, results[i].FragmentShader);
+            }
+        }
+
+        [Fact]
+        public void ComputeSpecializations_EmitsEachSet()
+        {
+            byte[] csBytes = TestUtil.LoadBytes("spec-constants.comp");
+            SpecializationConstant[][] sets =
+            {
+                new[] { new SpecializationConstant(0, 1234u), new SpecializationConstant(1, 5678u) },
+                new[] { new SpecializationConstant(0, 4321u), new SpecializationConstant(1, 8765u) },
+            };
+            ComputeCompilationResult[] results = SpirvCompilation.CompileComputeSpecializations(
+                csBytes,
+                CrossCompileTarget.GLSL,
+                new CrossCompileOptions(),
+                sets);
+
+            Assert.Equal(2, results.Length);
+            Assert.NotEqual(results[0].ComputeShader, results[1].ComputeShader);
+            Assert.Contains("1234", results[0].ComputeShader);
+            Assert.Contains("5678", results[0].ComputeShader);
+            Assert.Contains("4321", results[1].ComputeShader);
+            Assert.Contains("8765", results[1].ComputeShader);
+        }
+
+        [Fact]
+        public void CrossCompileCache_ServesRepeatedCompilations()
+        {
+            byte[] vsBytes = TestUtil.LoadBytes("planet.vert.spv");
+            byte[] fsBytes = TestUtil.LoadBytes("planet.frag.spv");
+            SpirvCompilation.SetCrossCompileCacheCapacity(16);
+            try
+            {
+                VertexFragmentCompilationResult first = SpirvCompilation.CompileVertexFragment(
+                    vsBytes, fsBytes, CrossCompileTarget.MSL, new CrossCompileOptions(true, true));
+                CrossCompileCacheStatistics before = SpirvCompilation.GetCrossCompileCacheStatistics();
+                VertexFragmentCompilationResult second = SpirvCompilation.CompileVertexFragment(
+                    vsBytes, fsBytes, CrossCompileTarget.MSL, new CrossCompileOptions(true, true));
+                CrossCompileCacheStatistics after = SpirvCompilation.GetCrossCompileCacheStatistics();
+
+                Assert.Equal(first.VertexShader, second.VertexShader);
+                Assert.Equal(first.FragmentShader, second.FragmentShader);
+                Assert.True(after.Hits > before.Hits);
+                Assert.True(after.EntryCount <= after.Capacity);
+            }
+            finally
+            {
+                SpirvCompilation.SetCrossCompileCacheCapacity(0);
+            }
+        }
+
+        [Fact]
+        public void CompileTrace_RecordsPhases()
+        {
+            byte[] vsBytes = TestUtil.LoadBytes("planet.vert.spv");
+            byte[] fsBytes = TestUtil.LoadBytes("planet.frag.spv");
+            string tracePath = System.IO.Path.GetTempFileName();
+            try
+            {
+                SpirvCompilation.ResetCompileStatistics();
+                SpirvCompilation.BeginCompileTrace();
+                SpirvCompilation.CompileVertexFragment(vsBytes, fsBytes, CrossCompileTarget.GLSL);
+                SpirvCompilation.EndCompileTrace(tracePath);
+
+                CompileStatistics stats = SpirvCompilation.GetCompileStatistics();
+                Assert.True(stats.CallCount > 0);
+                Assert.True(stats[CompilePhase.Parse].Bytes >= (ulong)(vsBytes.Length + fsBytes.Length));
+                Assert.True(stats[CompilePhase.Emit].Calls >= 2);
+                Assert.Contains("\"name\":\"emit\"", System.IO.File.ReadAllText(tracePath));
+            }
+            finally
+            {
+                SpirvCompilation.SetCompileInstrumentation(false);
+                System.IO.File.Delete(tracePath);
+            }
+        }
+
         [Theory]
         [InlineData("overlapping-resources.vert.spv", "overlapping-resources.frag.spv", CrossCompileTarget.HLSL)]
         [InlineData("overlapping-resources.vert", "overlapping-resources.frag.spv", CrossCompileTarget.HLSL)]
@@ -142,5 +365,459 @@ namespace Veldrid.SPIRV.Tests
             Assert.True(result.SpirvBytes.Length > 4);
             Assert.True(result.SpirvBytes.Length % 4 == 0);
         }
+
+        [Fact]
+        public void GlslToSpirv_ResolvesSpacedIncludeAndReloadsRewrittenFile()
+        {
+            string directory = Path.Combine(Path.GetTempPath(), Path.GetRandomFileName());
+            Directory.CreateDirectory(directory);
+            try
+            {
+                string includePath = Path.Combine(directory, "value.glsl");
+                string source = string.Join("\n",
+                    "#version 450",
+                    "layout(local_size_x = 1) in;",
+                    "layout(set = 0, binding = 0) buffer Data { vec4 Values[]; };",
+                    "#  include \"value.glsl\"",
+                    "void main() { Values[0] = GetValue(); }",
+                    "");
+                GlslCompileOptions options = new GlslCompileOptions { IncludeDirectories = new[] { directory } };
+
+                File.WriteAllText(includePath, "vec4 GetValue() { return vec4(1.0); }\n");
+                SpirvCompilationResult first = SpirvCompilation.CompileGlslToSpirv(
+                    source, "spaced.comp", ShaderStages.Compute, options);
+                Assert.Single(first.IncludedFiles);
+
+                // Rewritten right away with the same size, so only a fine-grained modification time tells them apart.
+                File.WriteAllText(includePath, "vec4 GetValue() { return vec4(2.0); }\n");
+                SpirvCompilationResult second = SpirvCompilation.CompileGlslToSpirv(
+                    source, "spaced.comp", ShaderStages.Compute, options);
+                Assert.NotEqual(first.SpirvBytes, second.SpirvBytes);
+            }
+            finally
+            {
+                Directory.Delete(directory, true);
+            }
+        }
+
+        [Fact]
+        public void GlslCompileCache_HitsAndInvalidates()
+        {
+            string directory = Path.Combine(Path.GetTempPath(), Path.GetRandomFileName());
+            Directory.CreateDirectory(directory);
+            SpirvCompilation.SetGlslCompileCacheDirectory(directory);
+            try
+            {
+                string source = string.Join("\n",
+                    "#version 450",
+                    "layout(location = 0) in vec2 Position;",
+                    "void main()",
+                    "{",
+                    "#ifdef FLIP",
+                    "    gl_Position = vec4(-Position, 0, 1);",
+                    "#else",
+                    "    gl_Position = vec4(Position, 0, 1);",
+                    "#endif",
+                    "}",
+                    "");
+
+                // A miss compiles the shader and stores its module.
+                SpirvCompilationResult first = SpirvCompilation.CompileGlslToSpirv(
+                    source, "cached.vert", ShaderStages.Vertex, new GlslCompileOptions(false));
+                string cachedPath = Assert.Single(Directory.GetFiles(directory, "*.spv"));
+                Assert.Equal(first.SpirvBytes, File.ReadAllBytes(cachedPath));
+
+                // A hit is served from the stored module, so a planted module comes back unchanged.
+                byte[] planted = TestUtil.LoadBytes("simple.comp.spv");
+                File.WriteAllBytes(cachedPath, planted);
+                SpirvCompilationResult second = SpirvCompilation.CompileGlslToSpirv(
+                    source, "cached.vert", ShaderStages.Vertex, new GlslCompileOptions(false));
+                Assert.Equal(planted, second.SpirvBytes);
+
+                // Different options or macros produce different keys.
+                SpirvCompilationResult debug = SpirvCompilation.CompileGlslToSpirv(
+                    source, "cached.vert", ShaderStages.Vertex, new GlslCompileOptions(true));
+                SpirvCompilationResult flipped = SpirvCompilation.CompileGlslToSpirv(
+                    source, "cached.vert", ShaderStages.Vertex, new GlslCompileOptions(false, new MacroDefinition("FLIP")));
+                Assert.NotEqual(planted, debug.SpirvBytes);
+                Assert.NotEqual(planted, flipped.SpirvBytes);
+                Assert.Equal(3, Directory.GetFiles(directory, "*.spv").Length);
+            }
+            finally
+            {
+                SpirvCompilation.SetGlslCompileCacheDirectory(null);
+                Directory.Delete(directory, true);
+            }
+        }
+
+        [Fact]
+        public void VariantMatrix_CollapsesIdenticalPermutations()
+        {
+            VariantMatrixDescription description = new VariantMatrixDescription
+            {
+                Stages = new[]
+                {
+                    new VariantMatrixStage(ShaderStages.Vertex, TestUtil.LoadShaderText("planet.vert"), "planet.vert"),
+                    new VariantMatrixStage(ShaderStages.Fragment, TestUtil.LoadShaderText("planet.frag"), "planet.frag"),
+                },
+                Axes = new[]
+                {
+                    new ShaderMacroAxis(null, new MacroDefinition("UNUSED_A")),
+                    new ShaderMacroAxis(new MacroDefinition("UNUSED_B", "0"), new MacroDefinition("UNUSED_B", "1")),
+                },
+                Targets = new[] { CrossCompileTarget.HLSL, CrossCompileTarget.MSL },
+            };
+
+            VariantMatrixResult result = SpirvCompilation.CompileVariantMatrix(description);
+
+            Assert.Equal(4, result.PermutationVariants.Length);
+            Assert.All(result.PermutationVariants, variant => Assert.Equal(0, variant));
+            CompiledShaderVariant compiled = Assert.Single(result.Variants);
+            Assert.Null(compiled.ErrorMessage);
+            Assert.Equal(2, compiled.SpirvBytes.Length);
+            Assert.Equal(2, compiled.TargetOutputs.Length);
+            Assert.All(compiled.TargetOutputs, outputs => Assert.All(outputs, text => Assert.False(string.IsNullOrEmpty(text))));
+        }
+
+        [Fact]
+        public void VariantMatrix_AppliesSpecializations()
+        {
+            VariantMatrixDescription description = new VariantMatrixDescription
+            {
+                Stages = new[]
+                {
+                    new VariantMatrixStage(
+                        ShaderStages.Compute,
+                        TestUtil.LoadShaderText("spec-constants.comp"),
+                        "spec-constants.comp"),
+                },
+                Targets = new[] { CrossCompileTarget.GLSL },
+                CrossCompileOptions = new CrossCompileOptions(
+                    false,
+                    false,
+                    new SpecializationConstant(0, 1234u),
+                    new SpecializationConstant(1, 5678u)),
+            };
+
+            VariantMatrixResult result = SpirvCompilation.CompileVariantMatrix(description);
+
+            CompiledShaderVariant compiled = Assert.Single(result.Variants);
+            Assert.Null(compiled.ErrorMessage);
+            Assert.Contains("1234", compiled.TargetOutputs[0][0]);
+            Assert.Contains("5678", compiled.TargetOutputs[0][0]);
+        }
+
+        [Fact]
+        public void VariantMatrix_ReportsIncludesOfMergedPermutations()
+        {
+            string directory = Path.Combine(Path.GetTempPath(), Path.GetRandomFileName());
+            Directory.CreateDirectory(directory);
+            try
+            {
+                string pathA = Path.Combine(directory, "a.glsl");
+                string pathB = Path.Combine(directory, "b.glsl");
+                File.WriteAllText(pathA, "vec4 GetValue() { return vec4(1.0); }\n");
+                File.WriteAllText(pathB, "vec4 GetValue() { return vec4(1.0); }\n");
+                string source = string.Join("\n",
+                    "#version 450",
+                    "layout(local_size_x = 1) in;",
+                    "layout(set = 0, binding = 0) buffer Data { vec4 Values[]; };",
+                    "#ifdef USE_B",
+                    "#include \"b.glsl\"",
+                    "#else",
+                    "#include \"a.glsl\"",
+                    "#endif",
+                    "void main() { Values[0] = GetValue(); }",
+                    "");
+
+                VariantMatrixDescription description = new VariantMatrixDescription
+                {
+                    Stages = new[]
+                    {
+                        new VariantMatrixStage(ShaderStages.Compute, source, Path.Combine(directory, "values.comp")),
+                    },
+                    Axes = new[] { new ShaderMacroAxis(null, new MacroDefinition("USE_B")) },
+                };
+
+                VariantMatrixResult result = SpirvCompilation.CompileVariantMatrix(description);
+
+                CompiledShaderVariant compiled = Assert.Single(result.Variants);
+                Assert.Null(compiled.ErrorMessage);
+                Assert.Equal(2, compiled.IncludedFiles.Length);
+                Assert.Contains(compiled.IncludedFiles, path => Path.GetFileName(path) == "a.glsl");
+                Assert.Contains(compiled.IncludedFiles, path => Path.GetFileName(path) == "b.glsl");
+            }
+            finally
+            {
+                Directory.Delete(directory, true);
+            }
+        }
+
+        [Fact]
+        public void VariantMatrix_FailedVariantReportsBrokenInclude()
+        {
+            string directory = Path.Combine(Path.GetTempPath(), Path.GetRandomFileName());
+            Directory.CreateDirectory(directory);
+            try
+            {
+                File.WriteAllText(Path.Combine(directory, "a.glsl"), "vec4 GetValue() { return vec4(1.0); }\n");
+                File.WriteAllText(Path.Combine(directory, "b.glsl"), "vec4 GetValue() { return vec4(1.0) }\n");
+                string source = string.Join("\n",
+                    "#version 450",
+                    "layout(local_size_x = 1) in;",
+                    "layout(set = 0, binding = 0) buffer Data { vec4 Values[]; };",
+                    "#ifdef USE_B",
+                    "#include \"b.glsl\"",
+                    "#else",
+                    "#include \"a.glsl\"",
+                    "#endif",
+                    "void main() { Values[0] = GetValue(); }",
+                    "");
+                string fileName = Path.Combine(directory, "values.comp");
+
+                VariantMatrixDescription description = new VariantMatrixDescription
+                {
+                    Stages = new[] { new VariantMatrixStage(ShaderStages.Compute, source, fileName) },
+                    Axes = new[] { new ShaderMacroAxis(null, new MacroDefinition("USE_B")) },
+                };
+
+                VariantMatrixResult result = SpirvCompilation.CompileVariantMatrix(description);
+
+                Assert.Equal(2, result.Variants.Length);
+                CompiledShaderVariant failed = Assert.Single(result.Variants, variant => variant.ErrorMessage != null);
+                string failedInclude = Assert.Single(failed.IncludedFiles);
+                Assert.Equal("b.glsl", Path.GetFileName(failedInclude));
+
+                GlslCompileOptions options = new GlslCompileOptions(false, new MacroDefinition("USE_B"));
+                SpirvCompilationException e = Assert.Throws<SpirvCompilationException>(
+                    () => SpirvCompilation.CompileGlslToSpirv(source, fileName, ShaderStages.Compute, options));
+                string thrownInclude = Assert.Single(e.IncludedFiles);
+                Assert.Equal("b.glsl", Path.GetFileName(thrownInclude));
+            }
+            finally
+            {
+                Directory.Delete(directory, true);
+            }
+        }
+
+        [Fact]
+        public void GlslCompilerSession_MatchesStatelessCompilation()
+        {
+            GlslCompileOptions options = new GlslCompileOptions(false, new MacroDefinition("Name0", "Value0"));
+            string source = TestUtil.LoadShaderText("planet.frag");
+            SpirvCompilationResult expected = SpirvCompilation.CompileGlslToSpirv(
+                source, "planet.frag", ShaderStages.Fragment, options);
+
+            using (GlslCompilerSession session = new GlslCompilerSession(options))
+            {
+                for (int i = 0; i < 3; i++)
+                {
+                    SpirvCompilationResult result = session.Compile(source, "planet.frag", ShaderStages.Fragment);
+                    Assert.Equal(expected.SpirvBytes, result.SpirvBytes);
+                }
+            }
+        }
+
+        [Theory]
+        [InlineData(CrossCompileTarget.HLSL)]
+        [InlineData(CrossCompileTarget.GLSL)]
+        [InlineData(CrossCompileTarget.ESSL)]
+        [InlineData(CrossCompileTarget.MSL)]
+        public void MinifyOutput_ShrinksShaderText(CrossCompileTarget target)
+        {
+            byte[] vsBytes = TestUtil.LoadBytes("planet.vert.spv");
+            byte[] fsBytes = TestUtil.LoadBytes("planet.frag.spv");
+            VertexFragmentCompilationResult regular = SpirvCompilation.CompileVertexFragment(
+                vsBytes, fsBytes, target, new CrossCompileOptions());
+            VertexFragmentCompilationResult minified = SpirvCompilation.CompileVertexFragment(
+                vsBytes, fsBytes, target, new CrossCompileOptions() { MinifyOutput = true });
+
+            Assert.True(minified.VertexShader.Length < regular.VertexShader.Length);
+            Assert.True(minified.FragmentShader.Length < regular.FragmentShader.Length);
+            Assert.DoesNotContain("    ", minified.VertexShader);
+            Assert.Equal(regular.Reflection.VertexElements, minified.Reflection.VertexElements);
+            foreach (VertexElementDescription element in minified.Reflection.VertexElements)
+            {
+                Assert.Contains(element.Name, minified.VertexShader);
+            }
+        }
+
+        [Fact]
+        public void PruneStageInterface_RemovesUnreadVertexOutputs()
+        {
+            string vs = @"#version 450
+layout(location = 0) in vec2 Position;
+layout(location = 0) out vec4 fsin_Unused;
+layout(location = 1) out vec4 fsin_Color;
+void main()
+{
+    fsin_Unused = vec4(Position * 2, 0, 1);
+    fsin_Color = vec4(Position, 1, 1);
+    gl_Position = vec4(Position, 0, 1);
+}";
+            string fs = @"#version 450
+layout(location = 1) in vec4 fsin_Color;
+layout(location = 0) out vec4 OutColor;
+void main()
+{
+    OutColor = fsin_Color;
+}";
+            VertexFragmentCompilationResult result = SpirvCompilation.CompileVertexFragment(
+                Encoding.ASCII.GetBytes(vs),
+                Encoding.ASCII.GetBytes(fs),
+                CrossCompileTarget.GLSL,
+                new CrossCompileOptions() { PruneStageInterface = true });
+
+            Assert.Contains("vdspv_fsin0", result.VertexShader);
+            Assert.DoesNotContain("vdspv_fsin1", result.VertexShader);
+            Assert.Contains("vdspv_fsin0", result.FragmentShader);
+            Assert.DoesNotContain("vdspv_fsin1", result.FragmentShader);
+            Assert.Single(result.Reflection.VertexElements);
+        }
+
+        [Fact]
+        public void BeginCompileVertexFragment_MatchesSynchronousCompile()
+        {
+            byte[] vsBytes = TestUtil.LoadBytes("planet.vert.spv");
+            byte[] fsBytes = TestUtil.LoadBytes("planet.frag.spv");
+            VertexFragmentCompilationResult expected = SpirvCompilation.CompileVertexFragment(
+                vsBytes, fsBytes, CrossCompileTarget.HLSL, new CrossCompileOptions());
+
+            using (CompileTask<VertexFragmentCompilationResult> task = SpirvCompilation.BeginCompileVertexFragment(
+                vsBytes, fsBytes, CrossCompileTarget.HLSL, new CrossCompileOptions()))
+            {
+                Assert.True(task.Wait(-1));
+                Assert.Equal(CompileTaskStatus.Completed, task.Status);
+                VertexFragmentCompilationResult result = task.GetResult();
+                Assert.Equal(expected.VertexShader, result.VertexShader);
+                Assert.Equal(expected.FragmentShader, result.FragmentShader);
+            }
+
+            using (CompileTask<VertexFragmentCompilationResult> task = SpirvCompilation.BeginCompileVertexFragment(
+                vsBytes, fsBytes, CrossCompileTarget.MSL, new CrossCompileOptions()))
+            {
+                task.Cancel();
+                Assert.True(task.Wait(-1));
+                if (task.Status == CompileTaskStatus.Cancelled)
+                {
+                    Assert.Throws<System.OperationCanceledException>(() => task.GetResult());
+                }
+            }
+        }
+
+        [Fact]
+        public void SetWorkerThreadCount_WhileCompileTasksRun()
+        {
+            byte[] vsBytes = TestUtil.LoadBytes("planet.vert.spv");
+            byte[] fsBytes = TestUtil.LoadBytes("planet.frag.spv");
+            VertexFragmentCompilationResult expected = SpirvCompilation.CompileVertexFragment(
+                vsBytes, fsBytes, CrossCompileTarget.GLSL, new CrossCompileOptions());
+
+            CompileTask<VertexFragmentCompilationResult>[] tasks = new CompileTask<VertexFragmentCompilationResult>[16];
+            try
+            {
+                for (int i = 0; i < tasks.Length; i++)
+                {
+                    tasks[i] = SpirvCompilation.BeginCompileVertexFragment(
+                        vsBytes, fsBytes, CrossCompileTarget.GLSL, new CrossCompileOptions());
+                    // Replacing the pool drops its last global reference while tasks still run on it.
+                    SpirvCompilation.SetWorkerThreadCount((uint)(i % 3));
+                }
+
+                foreach (CompileTask<VertexFragmentCompilationResult> task in tasks)
+                {
+                    Assert.True(task.Wait(-1));
+                    Assert.Equal(expected.VertexShader, task.GetResult().VertexShader);
+                }
+            }
+            finally
+            {
+                foreach (CompileTask<VertexFragmentCompilationResult> task in tasks)
+                {
+                    task?.Dispose();
+                }
+                SpirvCompilation.SetWorkerThreadCount(0);
+            }
+        }
+
+        [Fact]
+        public void SetCompileServer_FallsBackToLocalCompilation()
+        {
+            byte[] vsBytes = TestUtil.LoadBytes("planet.vert.spv");
+            byte[] fsBytes = TestUtil.LoadBytes("planet.frag.spv");
+            VertexFragmentCompilationResult expected = SpirvCompilation.CompileVertexFragment(
+                vsBytes, fsBytes, CrossCompileTarget.GLSL, new CrossCompileOptions());
+
+            string socketPath = System.IO.Path.Combine(System.IO.Path.GetTempPath(), System.IO.Path.GetRandomFileName());
+            SpirvCompilation.SetCompileServer(socketPath);
+            try
+            {
+                VertexFragmentCompilationResult result = SpirvCompilation.CompileVertexFragment(
+                    vsBytes, fsBytes, CrossCompileTarget.GLSL, new CrossCompileOptions());
+                Assert.Equal(expected.VertexShader, result.VertexShader);
+                Assert.Equal(expected.FragmentShader, result.FragmentShader);
+            }
+            finally
+            {
+                SpirvCompilation.SetCompileServer(null);
+            }
+        }
+
+        [Fact]
+        public void ShaderBundle_RoundTripsVariants()
+        {
+            byte[] vsBytes = TestUtil.LoadBytes("planet.vert.spv");
+            byte[] fsBytes = TestUtil.LoadBytes("planet.frag.spv");
+            byte[] csBytes = TestUtil.LoadBytes("simple.comp.spv");
+            CrossCompileTarget[] targets = { CrossCompileTarget.GLSL, CrossCompileTarget.MSL };
+            string bundlePath = System.IO.Path.GetTempFileName();
+            try
+            {
+                using (ShaderBundleWriter writer = new ShaderBundleWriter(true))
+                {
+                    writer.AddVertexFragment("planet", vsBytes, fsBytes, targets, new CrossCompileOptions());
+                    writer.AddCompute("simple", csBytes, targets, new CrossCompileOptions());
+                    writer.Write(bundlePath);
+                }
+
+                using (ShaderBundle bundle = new ShaderBundle(bundlePath))
+                {
+                    Assert.Equal(2u, bundle.VariantCount);
+                    Assert.False(bundle.TryGetVariant("missing", out _));
+                    Assert.True(bundle.TryGetVariant("planet", out ShaderBundleVariant planet));
+
+                    VertexFragmentCompilationResult expected = SpirvCompilation.CompileVertexFragment(
+                        vsBytes, fsBytes, CrossCompileTarget.MSL);
+                    Assert.Equal(vsBytes, planet.GetSpirvBytes(ShaderStages.Vertex));
+                    Assert.Equal(expected.FragmentShader, planet.GetShaderText(CrossCompileTarget.MSL, ShaderStages.Fragment));
+                    Assert.Null(planet.GetShaderBytes(CrossCompileTarget.HLSL, ShaderStages.Vertex));
+                    Assert.Equal(expected.Reflection.VertexElements, planet.Reflection.VertexElements);
+                    Assert.Equal(expected.Reflection.ResourceLayouts.Length, planet.Reflection.ResourceLayouts.Length);
+
+                    Assert.True(bundle.TryGetVariant("simple", out ShaderBundleVariant simple));
+                    Assert.NotNull(simple.GetShaderText(CrossCompileTarget.GLSL, ShaderStages.Compute));
+                }
+            }
+            finally
+            {
+                System.IO.File.Delete(bundlePath);
+            }
+        }
+
+        [Fact]
+        public void SpirvFingerprint_IgnoresDebugInstructions()
+        {
+            GlslCompileOptions options = new GlslCompileOptions(true);
+            string source = TestUtil.LoadShaderText("planet.frag");
+            SpirvCompilationResult first = SpirvCompilation.CompileGlslToSpirv(
+                source, "planet.frag", ShaderStages.Fragment, options);
+            SpirvCompilationResult second = SpirvCompilation.CompileGlslToSpirv(
+                source, "renamed.frag", ShaderStages.Fragment, options);
+
+            Assert.NotEqual(first.SpirvBytes, second.SpirvBytes);
+            Assert.NotEqual(default(SpirvFingerprint), first.Fingerprint);
+            Assert.Equal(first.Fingerprint, second.Fingerprint);
+            Assert.Equal(first.Fingerprint, SpirvCompilation.GetSpirvFingerprint(first.SpirvBytes));
+        }
     }
 }
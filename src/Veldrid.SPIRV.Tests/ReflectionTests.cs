@@ -28,14 +28,75 @@ namespace Veldrid.SPIRV.Tests
                 CrossCompileTarget.HLSL,
                 new CrossCompileOptions(false, false, true));
 
-            VertexElementDescription[] reflectedVerts = result.Reflection.VertexElements;
+            AssertReflection(result.Reflection, verts, layouts);
+        }
+
+        [Theory]
+        [MemberData(nameof(ShaderSetsAndResources))]
+        public void ReflectionOnly_Succeeds(
+            string vertex, string fragment,
+            VertexElementDescription[] verts,
+            ResourceLayoutDescription[] layouts)
+        {
+            byte[] vsBytes = TestUtil.LoadBytes(vertex);
+            byte[] fsBytes = TestUtil.LoadBytes(fragment);
+            SpirvReflection reflection = SpirvCompilation.ReflectVertexFragment(
+                vsBytes,
+                fsBytes,
+                new CrossCompileOptions(false, false, true));
+
+            AssertReflection(reflection, verts, layouts);
+        }
+
+        [Theory]
+        [MemberData(nameof(ShaderSetsAndResources))]
+        public void SparseReflection_ListsUsedBindings(
+            string vertex, string fragment,
+            VertexElementDescription[] verts,
+            ResourceLayoutDescription[] layouts)
+        {
+            byte[] vsBytes = TestUtil.LoadBytes(vertex);
+            byte[] fsBytes = TestUtil.LoadBytes(fragment);
+            CrossCompileOptions options = new CrossCompileOptions(false, false, true);
+            options.SparseResourceLayouts = true;
+            SpirvReflection reflection = SpirvCompilation.ReflectVertexFragment(vsBytes, fsBytes, options);
+
+            Assert.Empty(reflection.ResourceLayouts);
+            List<SparseResourceBinding> expected = new List<SparseResourceBinding>();
+            for (uint set = 0; set < layouts.Length; set++)
+            {
+                for (uint binding = 0; binding < layouts[set].Elements.Length; binding++)
+                {
+                    ResourceLayoutElementDescription element = layouts[set].Elements[binding];
+                    if ((element.Options & (ResourceLayoutElementOptions)2) == 0)
+                    {
+                        expected.Add(new SparseResourceBinding(set, binding, element));
+                    }
+                }
+            }
+
+            Assert.Equal(expected.Count, reflection.SparseResourceBindings.Length);
+            for (int i = 0; i < expected.Count; i++)
+            {
+                Assert.Equal(expected[i].Set, reflection.SparseResourceBindings[i].Set);
+                Assert.Equal(expected[i].Binding, reflection.SparseResourceBindings[i].Binding);
+                AssertEqual(expected[i].Element, reflection.SparseResourceBindings[i].Element);
+            }
+        }
+
+        private void AssertReflection(
+            SpirvReflection reflection,
+            VertexElementDescription[] verts,
+            ResourceLayoutDescription[] layouts)
+        {
+            VertexElementDescription[] reflectedVerts = reflection.VertexElements;
             Assert.Equal(verts.Length, reflectedVerts.Length);
             for (int i = 0; i < verts.Length; i++)
             {
                 Assert.Equal(verts[i], reflectedVerts[i]);
             }
 
-            ResourceLayoutDescription[] reflectedLayouts = result.Reflection.ResourceLayouts;
+            ResourceLayoutDescription[] reflectedLayouts = reflection.ResourceLayouts;
             Assert.Equal(layouts.Length, reflectedLayouts.Length);
             for (int i = 0; i < layouts.Length; i++)
             {
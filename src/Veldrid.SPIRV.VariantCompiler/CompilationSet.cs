@@ -46,19 +46,36 @@ namespace Veldrid.SPIRV
     {
         private readonly List<string> _shaderSearchPaths = new List<string>();
         private readonly string _outputPath;
+        private readonly ShaderBundleWriter _bundleWriter;
 
         public VariantCompiler(List<string> shaderSearchPaths, string outputPath)
+            : this(shaderSearchPaths, outputPath, null)
+        {
+        }
+
+        public VariantCompiler(List<string> shaderSearchPaths, string outputPath, ShaderBundleWriter bundleWriter)
         {
             _shaderSearchPaths = shaderSearchPaths;
             _outputPath = outputPath;
+            _bundleWriter = bundleWriter;
         }
 
         public string[] Compile(ShaderVariantDescription variant)
+        {
+            return Compile(variant, null);
+        }
+
+        /// <summary>
+        /// Compiles a variant and adds the full paths of the files it was compiled from, including every file pulled in
+        /// through #include directives, to <paramref name="dependencies"/>. Files which were read before a compilation error
+        /// are added as well.
+        /// </summary>
+        public string[] Compile(ShaderVariantDescription variant, ICollection<string> dependencies)
         {
             if (variant.Shaders.Length == 1)
             {
-                if (variant.Shaders[0].Stage == ShaderStages.Vertex) { return CompileVertexFragment(variant); }
-                if (variant.Shaders[0].Stage == ShaderStages.Compute) { return CompileCompute(variant); }
+                if (variant.Shaders[0].Stage == ShaderStages.Vertex) { return CompileVertexFragment(variant, dependencies); }
+                if (variant.Shaders[0].Stage == ShaderStages.Compute) { return CompileCompute(variant, dependencies); }
             }
             if (variant.Shaders.Length == 2)
             {
@@ -79,7 +96,7 @@ namespace Veldrid.SPIRV
                     throw new SpirvCompilationException($"Variant \"{variant.Name}\" is missing a fragment shader.");
                 }
 
-                return CompileVertexFragment(variant);
+                return CompileVertexFragment(variant, dependencies);
             }
             else
             {
@@ -88,7 +105,7 @@ namespace Veldrid.SPIRV
             }
         }
 
-        private string[] CompileVertexFragment(ShaderVariantDescription variant)
+        private string[] CompileVertexFragment(ShaderVariantDescription variant, ICollection<string> dependencies)
         {
             List<string> generatedFiles = new List<string>();
             List<Exception> compilationExceptions = new List<Exception>();
@@ -100,10 +117,13 @@ namespace Veldrid.SPIRV
             {
                 try
                 {
-                    vsBytes = CompileToSpirv(variant, vertexFileName, ShaderStages.Vertex);
-                    string spvPath = Path.Combine(_outputPath, $"{variant.Name}_{ShaderStages.Vertex.ToString()}.spv");
-                    File.WriteAllBytes(spvPath, vsBytes);
-                    generatedFiles.Add(spvPath);
+                    vsBytes = CompileToSpirv(variant, vertexFileName, ShaderStages.Vertex, dependencies);
+                    if (_bundleWriter == null)
+                    {
+                        string spvPath = Path.Combine(_outputPath, $"{variant.Name}_{ShaderStages.Vertex.ToString()}.spv");
+                        File.WriteAllBytes(spvPath, vsBytes);
+                        generatedFiles.Add(spvPath);
+                    }
                 }
                 catch (Exception e)
                 {
@@ -116,10 +136,13 @@ namespace Veldrid.SPIRV
             {
                 try
                 {
-                    fsBytes = CompileToSpirv(variant, fragmentFileName, ShaderStages.Fragment);
-                    string spvPath = Path.Combine(_outputPath, $"{variant.Name}_{ShaderStages.Fragment.ToString()}.spv");
-                    File.WriteAllBytes(spvPath, fsBytes);
-                    generatedFiles.Add(spvPath);
+                    fsBytes = CompileToSpirv(variant, fragmentFileName, ShaderStages.Fragment, dependencies);
+                    if (_bundleWriter == null)
+                    {
+                        string spvPath = Path.Combine(_outputPath, $"{variant.Name}_{ShaderStages.Fragment.ToString()}.spv");
+                        File.WriteAllBytes(spvPath, fsBytes);
+                        generatedFiles.Add(spvPath);
+                    }
                 }
                 catch (Exception e)
                 {
@@ -134,6 +157,12 @@ namespace Veldrid.SPIRV
                     compilationExceptions);
             }
 
+            if (_bundleWriter != null)
+            {
+                _bundleWriter.AddVertexFragment(variant.Name, vsBytes, fsBytes, variant.Targets, variant.CrossCompileOptions);
+                return generatedFiles.ToArray();
+            }
+
             foreach (CrossCompileTarget target in variant.Targets)
             {
                 try
@@ -208,43 +237,77 @@ namespace Veldrid.SPIRV
         private byte[] CompileToSpirv(
             ShaderVariantDescription variant,
             string fileName,
-            ShaderStages stage)
+            ShaderStages stage,
+            ICollection<string> dependencies)
         {
             GlslCompileOptions glslOptions = GetOptions(variant);
-            string glsl = LoadGlsl(fileName);
-            SpirvCompilationResult result = SpirvCompilation.CompileGlslToSpirv(
-                glsl,
-                fileName,
-                stage,
-                glslOptions);
+            string fullPath = FindShaderFile(fileName);
+            dependencies?.Add(fullPath);
+            string glsl = File.ReadAllText(fullPath);
+
+            // The full path lets quoted #include directives resolve next to the shader file.
+            SpirvCompilationResult result;
+            try
+            {
+                result = SpirvCompilation.CompileGlslToSpirv(
+                    glsl,
+                    fullPath,
+                    stage,
+                    glslOptions);
+            }
+            catch (SpirvCompilationException e)
+            {
+                // A fix to a broken header must trigger a rebuild, so its includes are tracked even on failure.
+                AddIncludedFiles(e.IncludedFiles, dependencies);
+                throw;
+            }
+
+            AddIncludedFiles(result.IncludedFiles, dependencies);
             return result.SpirvBytes;
         }
 
-        private GlslCompileOptions GetOptions(ShaderVariantDescription variant)
+        private static void AddIncludedFiles(string[] includedFiles, ICollection<string> dependencies)
         {
-            return new GlslCompileOptions(false, variant.Macros);
+            if (dependencies != null)
+            {
+                foreach (string includedFile in includedFiles)
+                {
+                    dependencies.Add(Path.GetFullPath(includedFile));
+                }
+            }
         }
 
-        private string LoadGlsl(string fileName)
+        private GlslCompileOptions GetOptions(ShaderVariantDescription variant)
         {
-            if (fileName == null) { return null; }
+            GlslCompileOptions options = new GlslCompileOptions(false, variant.Macros);
+            options.IncludeDirectories = _shaderSearchPaths.Select(Path.GetFullPath).ToArray();
+            return options;
+        }
 
+        private string FindShaderFile(string fileName)
+        {
             foreach (string searchPath in _shaderSearchPaths)
             {
                 string fullPath = Path.Combine(searchPath, fileName);
                 if (File.Exists(fullPath))
                 {
-                    return File.ReadAllText(fullPath);
+                    return Path.GetFullPath(fullPath);
                 }
             }
 
             throw new FileNotFoundException($"Unable to find shader file \"{fileName}\".");
         }
 
-        private string[] CompileCompute(ShaderVariantDescription variant)
+        private string[] CompileCompute(ShaderVariantDescription variant, ICollection<string> dependencies)
         {
             List<string> generatedFiles = new List<string>();
-            byte[] csBytes = CompileToSpirv(variant, variant.Shaders[0].FileName, ShaderStages.Compute);
+            byte[] csBytes = CompileToSpirv(variant, variant.Shaders[0].FileName, ShaderStages.Compute, dependencies);
+            if (_bundleWriter != null)
+            {
+                _bundleWriter.AddCompute(variant.Name, csBytes, variant.Targets, variant.CrossCompileOptions);
+                return generatedFiles.ToArray();
+            }
+
             string spvPath = Path.Combine(_outputPath, $"{variant.Name}_{ShaderStages.Compute.ToString()}.spv");
             File.WriteAllBytes(spvPath, csBytes);
             generatedFiles.Add(spvPath);
@@ -2,8 +2,11 @@
 using Newtonsoft.Json;
 using Newtonsoft.Json.Converters;
 using System;
+using System.Collections.Concurrent;
 using System.Collections.Generic;
 using System.IO;
+using System.Linq;
+using System.Threading;
 
 namespace Veldrid.SPIRV
 {
@@ -23,6 +26,21 @@ namespace Veldrid.SPIRV
         [Option("--set", "The path to the JSON file containing shader variant definitions to compile.", CommandOptionType.SingleValue)]
         public string SetDefinitionPath { get; }
 
+        [Option("--bundle", "Writes every variant into a single shader bundle at the given path instead of separate files.", CommandOptionType.SingleValue)]
+        public string BundlePath { get; }
+
+        [Option("--compress", "Compresses the shaders stored in the shader bundle.", CommandOptionType.NoValue)]
+        public bool Compress { get; }
+
+        [Option("--depfile", "Writes a Makefile/Ninja depfile listing every shader source and included file of the set.", CommandOptionType.SingleValue)]
+        public string DepfilePath { get; }
+
+        [Option("--incremental", "Only recompiles the variants whose definition, sources or included files changed since the last run.", CommandOptionType.NoValue)]
+        public bool Incremental { get; }
+
+        [Option("--watch", "Keeps running and recompiles the variants affected by each change to their sources or included files.", CommandOptionType.NoValue)]
+        public bool Watch { get; }
+
         public void OnExecute()
         {
             if (!Directory.Exists(OutputPath))
@@ -30,7 +48,34 @@ namespace Veldrid.SPIRV
                 Directory.CreateDirectory(OutputPath);
             }
 
-            ShaderVariantDescription[] descs;
+            string graphPath = Path.Combine(OutputPath, "vspv_dependencies.json");
+            ShaderDependencyGraph graph = Incremental ? ShaderDependencyGraph.Load(graphPath) : new ShaderDependencyGraph();
+            ShaderVariantDescription[] descs = LoadDefinitions();
+
+            HashSet<string> variantsToCompile = null;
+            if (Incremental)
+            {
+                variantsToCompile = new HashSet<string>(
+                    descs.Where(d => !graph.IsUpToDate(d.Name, ShaderDependencyGraph.GetDefinitionHash(d))).Select(d => d.Name));
+            }
+
+            try
+            {
+                Build(descs, graph, variantsToCompile, Watch);
+            }
+            finally
+            {
+                graph.Save(graphPath);
+            }
+
+            if (Watch)
+            {
+                WatchForChanges(descs, graph, graphPath);
+            }
+        }
+
+        private ShaderVariantDescription[] LoadDefinitions()
+        {
             JsonSerializer serializer = new JsonSerializer();
             serializer.Formatting = Formatting.Indented;
             StringEnumConverter enumConverter = new StringEnumConverter();
@@ -38,24 +83,211 @@ namespace Veldrid.SPIRV
             using (StreamReader sr = File.OpenText(SetDefinitionPath))
             using (JsonTextReader jtr = new JsonTextReader(sr))
             {
-                descs = serializer.Deserialize<ShaderVariantDescription[]>(jtr);
+                return serializer.Deserialize<ShaderVariantDescription[]>(jtr);
             }
+        }
 
-            HashSet<string> generatedPaths = new HashSet<string>();
+        // Compiles the given variants, or all of them if variantsToCompile is null, and records what each was compiled
+        // from. The outputs of the other variants are taken from the graph. A bundle holds every variant, so it is
+        // either rewritten as a whole or, if no variant needs compiling, left alone.
+        private void Build(
+            ShaderVariantDescription[] descs,
+            ShaderDependencyGraph graph,
+            HashSet<string> variantsToCompile,
+            bool continueOnError)
+        {
+            string bundlePath = BundlePath != null ? Path.Combine(OutputPath, BundlePath) : null;
+            if (bundlePath != null && variantsToCompile != null)
+            {
+                variantsToCompile = variantsToCompile.Count > 0 || !File.Exists(bundlePath) ? null : variantsToCompile;
+            }
 
-            VariantCompiler compiler = new VariantCompiler(new List<string>(SearchPaths), OutputPath);
-            foreach (ShaderVariantDescription desc in descs)
+            graph.RemoveVariantsExcept(new HashSet<string>(descs.Select(d => d.Name)));
+            HashSet<string> generatedPaths = new HashSet<string>();
+            ShaderBundleWriter bundleWriter = bundlePath != null ? new ShaderBundleWriter(Compress) : null;
+            try
             {
-                string[] newPaths = compiler.Compile(desc);
-                foreach (string s in newPaths)
+                bool succeeded = true;
+                VariantCompiler compiler = new VariantCompiler(new List<string>(SearchPaths), OutputPath, bundleWriter);
+                foreach (ShaderVariantDescription desc in descs)
                 {
-                    generatedPaths.Add(s);
+                    if (variantsToCompile != null && !variantsToCompile.Contains(desc.Name))
+                    {
+                        generatedPaths.UnionWith(graph.GetOutputs(desc.Name));
+                        continue;
+                    }
+
+                    DateTime compileTime = DateTime.UtcNow;
+                    HashSet<string> dependencies = new HashSet<string>(ShaderDependencyGraph.PathComparer);
+                    try
+                    {
+                        string[] newPaths = compiler.Compile(desc, dependencies);
+                        graph.SetVariant(
+                            desc.Name,
+                            ShaderDependencyGraph.GetDefinitionHash(desc),
+                            compileTime,
+                            newPaths,
+                            dependencies);
+                        generatedPaths.UnionWith(newPaths);
+                    }
+                    catch (Exception e)
+                    {
+                        graph.SetVariant(desc.Name, null, compileTime, Array.Empty<string>(), dependencies);
+                        if (!continueOnError)
+                        {
+                            throw;
+                        }
+
+                        succeeded = false;
+                        Console.Error.WriteLine($"Variant \"{desc.Name}\": {e}");
+                    }
+                }
+
+                if (bundleWriter != null && succeeded)
+                {
+                    if (variantsToCompile == null)
+                    {
+                        bundleWriter.Write(bundlePath);
+                    }
+                    generatedPaths.Add(bundlePath);
                 }
             }
+            finally
+            {
+                bundleWriter?.Dispose();
+            }
 
             string generatedFilesListText = string.Join(Environment.NewLine, generatedPaths);
             string generatedFilesListPath = Path.Combine(OutputPath, "vspv_generated_files.txt");
             File.WriteAllText(generatedFilesListPath, generatedFilesListText);
+
+            if (DepfilePath != null)
+            {
+                graph.WriteDepfile(
+                    DepfilePath,
+                    new[] { generatedFilesListPath }.Concat(generatedPaths),
+                    new[] { Path.GetFullPath(SetDefinitionPath) });
+            }
+        }
+
+        // Watches the directories of every dependency and of the set definition. FileSystemWatcher is backed by inotify on
+        // Linux, so only the files actually touched are reported.
+        private void WatchForChanges(ShaderVariantDescription[] descs, ShaderDependencyGraph graph, string graphPath)
+        {
+            string setPath = Path.GetFullPath(SetDefinitionPath);
+            Dictionary<string, FileSystemWatcher> watchers =
+                new Dictionary<string, FileSystemWatcher>(ShaderDependencyGraph.PathComparer);
+            using (BlockingCollection<string> changes = new BlockingCollection<string>())
+            {
+                Console.CancelKeyPress += (sender, e) =>
+                {
+                    e.Cancel = true;
+                    changes.CompleteAdding();
+                };
+
+                try
+                {
+                    while (true)
+                    {
+                        UpdateWatchers(
+                            watchers,
+                            graph.GetDependencyDirectories().Append(Path.GetDirectoryName(setPath)),
+                            changes);
+                        Console.WriteLine("Watching for changes. Press Ctrl+C to stop.");
+
+                        if (!changes.TryTake(out string changedPath, Timeout.Infinite))
+                        {
+                            break;
+                        }
+
+                        // Editors often save a file in several steps, so changes arriving close together are handled at once.
+                        HashSet<string> changedPaths = new HashSet<string>(ShaderDependencyGraph.PathComparer) { changedPath };
+                        while (changes.TryTake(out changedPath, 100))
+                        {
+                            changedPaths.Add(changedPath);
+                        }
+
+                        HashSet<string> variantsToCompile = graph.GetAffectedVariants(changedPaths);
+                        if (changedPaths.Contains(setPath))
+                        {
+                            try
+                            {
+                                descs = LoadDefinitions();
+                            }
+                            catch (Exception e)
+                            {
+                                Console.Error.WriteLine($"Unable to load \"{SetDefinitionPath}\": {e.Message}");
+                                continue;
+                            }
+
+                            variantsToCompile.UnionWith(descs
+                                .Where(d => !graph.IsUpToDate(d.Name, ShaderDependencyGraph.GetDefinitionHash(d)))
+                                .Select(d => d.Name));
+                        }
+                        else if (variantsToCompile.Count == 0)
+                        {
+                            continue;
+                        }
+
+                        Console.WriteLine($"Recompiling {variantsToCompile.Count} variant(s).");
+                        try
+                        {
+                            Build(descs, graph, variantsToCompile, true);
+                        }
+                        catch (Exception e)
+                        {
+                            Console.Error.WriteLine(e);
+                        }
+                        graph.Save(graphPath);
+                    }
+                }
+                finally
+                {
+                    foreach (FileSystemWatcher watcher in watchers.Values)
+                    {
+                        watcher.Dispose();
+                    }
+                }
+            }
+        }
+
+        private static void UpdateWatchers(
+            Dictionary<string, FileSystemWatcher> watchers,
+            IEnumerable<string> directories,
+            BlockingCollection<string> changes)
+        {
+            void OnChanged(string path)
+            {
+                try
+                {
+                    changes.Add(Path.GetFullPath(path));
+                }
+                catch (InvalidOperationException)
+                {
+                    // Adding was completed because the watcher is shutting down.
+                }
+            }
+
+            foreach (string directory in directories)
+            {
+                if (watchers.ContainsKey(directory) || !Directory.Exists(directory))
+                {
+                    continue;
+                }
+
+                FileSystemWatcher watcher = new FileSystemWatcher(directory);
+                watcher.NotifyFilter = NotifyFilters.FileName | NotifyFilters.LastWrite | NotifyFilters.Size;
+                watcher.Changed += (sender, e) => OnChanged(e.FullPath);
+                watcher.Created += (sender, e) => OnChanged(e.FullPath);
+                watcher.Deleted += (sender, e) => OnChanged(e.FullPath);
+                watcher.Renamed += (sender, e) =>
+                {
+                    OnChanged(e.OldFullPath);
+                    OnChanged(e.FullPath);
+                };
+                watcher.EnableRaisingEvents = true;
+                watchers.Add(directory, watcher);
+            }
         }
     }
 }
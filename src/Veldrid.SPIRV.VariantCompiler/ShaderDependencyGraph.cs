@@ -0,0 +1,231 @@
+using Newtonsoft.Json;
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Security.Cryptography;
+using System.Text;
+
+namespace Veldrid.SPIRV
+{
+    /// <summary>
+    /// Records, for every compiled variant, the files it was compiled from and the files it produced. The graph maps a
+    /// changed file to the variants which depend on it, decides whether a variant is still up to date, and can be written
+    /// out as a Makefile/Ninja depfile.
+    /// </summary>
+    public class ShaderDependencyGraph
+    {
+        /// <summary>
+        /// Compares file paths the way the file system does.
+        /// </summary>
+        public static StringComparer PathComparer { get; } =
+            Path.DirectorySeparatorChar == '\\' ? StringComparer.OrdinalIgnoreCase : StringComparer.Ordinal;
+
+        // File systems with coarse timestamps may round a modification made during a compilation down to a time before
+        // it started, so anything modified shortly before a compilation is treated as newer than it.
+        private static readonly TimeSpan TimestampSlack = TimeSpan.FromSeconds(2);
+
+        private readonly Dictionary<string, VariantRecord> _variants;
+        private readonly Dictionary<string, HashSet<string>> _dependents = new Dictionary<string, HashSet<string>>(PathComparer);
+
+        public class VariantRecord
+        {
+            /// <summary>
+            /// A hash of the variant's definition, or null if its last compilation failed.
+            /// </summary>
+            public string Definition { get; set; }
+            public DateTime CompileTimeUtc { get; set; }
+            public string[] Outputs { get; set; }
+            public string[] Dependencies { get; set; }
+        }
+
+        public ShaderDependencyGraph()
+            : this(new Dictionary<string, VariantRecord>())
+        {
+        }
+
+        private ShaderDependencyGraph(Dictionary<string, VariantRecord> variants)
+        {
+            _variants = variants;
+            foreach (KeyValuePair<string, VariantRecord> pair in _variants)
+            {
+                AddDependents(pair.Key, pair.Value);
+            }
+        }
+
+        /// <summary>
+        /// Loads a graph saved by <see cref="Save(string)"/>. Returns an empty graph if the file does not exist or cannot be
+        /// read, so that every variant is compiled.
+        /// </summary>
+        public static ShaderDependencyGraph Load(string path)
+        {
+            if (File.Exists(path))
+            {
+                try
+                {
+                    Dictionary<string, VariantRecord> variants =
+                        JsonConvert.DeserializeObject<Dictionary<string, VariantRecord>>(File.ReadAllText(path));
+                    if (variants != null && variants.Values.All(v => v != null && v.Outputs != null && v.Dependencies != null))
+                    {
+                        return new ShaderDependencyGraph(variants);
+                    }
+                }
+                catch (JsonException)
+                {
+                }
+            }
+
+            return new ShaderDependencyGraph();
+        }
+
+        public void Save(string path)
+        {
+            File.WriteAllText(path, JsonConvert.SerializeObject(_variants, Formatting.Indented));
+        }
+
+        public static string GetDefinitionHash(ShaderVariantDescription variant)
+        {
+            byte[] json = Encoding.UTF8.GetBytes(JsonConvert.SerializeObject(variant));
+            using (SHA256 sha = SHA256.Create())
+            {
+                return BitConverter.ToString(sha.ComputeHash(json)).Replace("-", string.Empty);
+            }
+        }
+
+        /// <summary>
+        /// Replaces the record of a variant. Pass a null definition for a variant which failed to compile; its dependencies
+        /// are still tracked, but it is never up to date.
+        /// </summary>
+        public void SetVariant(
+            string name,
+            string definition,
+            DateTime compileTimeUtc,
+            IEnumerable<string> outputs,
+            IEnumerable<string> dependencies)
+        {
+            RemoveVariant(name);
+            VariantRecord record = new VariantRecord
+            {
+                Definition = definition,
+                CompileTimeUtc = compileTimeUtc,
+                Outputs = outputs.ToArray(),
+                Dependencies = dependencies.ToArray(),
+            };
+            _variants.Add(name, record);
+            AddDependents(name, record);
+        }
+
+        public void RemoveVariant(string name)
+        {
+            if (_variants.TryGetValue(name, out VariantRecord record))
+            {
+                foreach (string dependency in record.Dependencies)
+                {
+                    if (_dependents.TryGetValue(dependency, out HashSet<string> dependents)
+                        && dependents.Remove(name)
+                        && dependents.Count == 0)
+                    {
+                        _dependents.Remove(dependency);
+                    }
+                }
+
+                _variants.Remove(name);
+            }
+        }
+
+        /// <summary>
+        /// Removes the records of all variants which are not in the given set.
+        /// </summary>
+        public void RemoveVariantsExcept(ICollection<string> names)
+        {
+            foreach (string name in _variants.Keys.Where(n => !names.Contains(n)).ToArray())
+            {
+                RemoveVariant(name);
+            }
+        }
+
+        public string[] GetOutputs(string name)
+        {
+            return _variants.TryGetValue(name, out VariantRecord record) ? record.Outputs : Array.Empty<string>();
+        }
+
+        /// <summary>
+        /// Returns true if the variant was last compiled successfully from the same definition, all of its outputs still
+        /// exist and none of its dependencies changed since.
+        /// </summary>
+        public bool IsUpToDate(string name, string definition)
+        {
+            if (!_variants.TryGetValue(name, out VariantRecord record) || record.Definition != definition)
+            {
+                return false;
+            }
+
+            DateTime newestAllowed = record.CompileTimeUtc - TimestampSlack;
+            return record.Outputs.All(File.Exists)
+                && record.Dependencies.All(d => File.Exists(d) && File.GetLastWriteTimeUtc(d) < newestAllowed);
+        }
+
+        /// <summary>
+        /// Returns the names of the variants which depend on any of the given files.
+        /// </summary>
+        public HashSet<string> GetAffectedVariants(IEnumerable<string> changedPaths)
+        {
+            HashSet<string> affected = new HashSet<string>();
+            foreach (string path in changedPaths)
+            {
+                if (_dependents.TryGetValue(path, out HashSet<string> dependents))
+                {
+                    affected.UnionWith(dependents);
+                }
+            }
+
+            return affected;
+        }
+
+        /// <summary>
+        /// Returns the directories which contain at least one dependency.
+        /// </summary>
+        public IEnumerable<string> GetDependencyDirectories()
+        {
+            return _dependents.Keys.Select(Path.GetDirectoryName).Distinct(PathComparer);
+        }
+
+        /// <summary>
+        /// Writes a depfile in the syntax shared by Make and Ninja, with a single rule making every target depend on
+        /// the given extra files and on every dependency in the graph.
+        /// </summary>
+        public void WriteDepfile(string path, IEnumerable<string> targets, IEnumerable<string> extraDependencies)
+        {
+            StringBuilder sb = new StringBuilder();
+            sb.Append(string.Join(" ", targets.Select(EscapeDepfilePath)));
+            sb.Append(':');
+            foreach (string dependency in extraDependencies.Concat(_dependents.Keys.OrderBy(d => d, PathComparer)))
+            {
+                sb.Append(" \\\n  ");
+                sb.Append(EscapeDepfilePath(dependency));
+            }
+            sb.Append('\n');
+            File.WriteAllText(path, sb.ToString());
+        }
+
+        private void AddDependents(string name, VariantRecord record)
+        {
+            foreach (string dependency in record.Dependencies)
+            {
+                if (!_dependents.TryGetValue(dependency, out HashSet<string> dependents))
+                {
+                    dependents = new HashSet<string>();
+                    _dependents.Add(dependency, dependents);
+                }
+
+                dependents.Add(name);
+            }
+        }
+
+        private static string EscapeDepfilePath(string path)
+        {
+            // Both Make and Ninja accept forward slashes on Windows, which avoids backslashes being read as escapes.
+            return path.Replace('\\', '/').Replace("$", "$$").Replace("#", "\\#").Replace(" ", "\\ ");
+        }
+    }
+}
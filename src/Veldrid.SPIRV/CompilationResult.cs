@@ -3,12 +3,13 @@ using System.Runtime.InteropServices;
 
 namespace Veldrid.SPIRV
 {
-    [StructLayout(LayoutKind.Sequential)]
+    [StructLayout(LayoutKind.Sequential, Pack = 1)]
     internal unsafe struct CompilationResult
     {
         public Bool32 Succeeded;
         public InteropArray DataBuffers;
         public ReflectionInfo ReflectionInfo;
+        public SpirvFingerprint Fingerprint;
 
         public uint GetLength(uint index)
         {
@@ -0,0 +1,100 @@
+using System;
+
+namespace Veldrid.SPIRV
+{
+    /// <summary>
+    /// The phases of native compilation which are timed separately.
+    /// </summary>
+    public enum CompilePhase
+    {
+        /// <summary>
+        /// Compiling GLSL to SPIR-V with shaderc, including optimization.
+        /// </summary>
+        GlslCompile,
+        /// <summary>
+        /// Parsing SPIR-V modules and creating the cross-compilers for them.
+        /// </summary>
+        Parse,
+        /// <summary>
+        /// Collecting the resources and reflection data of the shaders.
+        /// </summary>
+        CollectResources,
+        /// <summary>
+        /// Assigning target-specific binding slots and names.
+        /// </summary>
+        RemapBindings,
+        /// <summary>
+        /// Emitting the shader code of the target language.
+        /// </summary>
+        Emit,
+        /// <summary>
+        /// Copying outputs and reflection data into the returned result.
+        /// </summary>
+        Marshal,
+        /// <summary>
+        /// Running the SPIR-V optimizer over the input modules.
+        /// </summary>
+        Optimize,
+    }
+
+    /// <summary>
+    /// The time spent in one <see cref="CompilePhase"/>, summed over all threads.
+    /// </summary>
+    public class CompilePhaseStatistics
+    {
+        /// <summary>
+        /// The total time spent in the phase.
+        /// </summary>
+        public TimeSpan Time => TimeSpan.FromTicks((long)(Nanoseconds / 100));
+        /// <summary>
+        /// The total time spent in the phase, in nanoseconds.
+        /// </summary>
+        public ulong Nanoseconds { get; }
+        /// <summary>
+        /// The number of times the phase was run.
+        /// </summary>
+        public ulong Calls { get; }
+        /// <summary>
+        /// The number of bytes processed by the phase: source text for GLSL compilation, SPIR-V for parsing, generated
+        /// code for emission and the result size for marshaling.
+        /// </summary>
+        public ulong Bytes { get; }
+
+        internal CompilePhaseStatistics(ulong nanoseconds, ulong calls, ulong bytes)
+        {
+            Nanoseconds = nanoseconds;
+            Calls = calls;
+            Bytes = bytes;
+        }
+    }
+
+    /// <summary>
+    /// A snapshot of the counters maintained by the native compile instrumentation.
+    /// </summary>
+    public class CompileStatistics
+    {
+        private readonly CompilePhaseStatistics[] _phases;
+
+        /// <summary>
+        /// The number of compilation calls made while instrumentation was enabled.
+        /// </summary>
+        public ulong CallCount { get; }
+
+        /// <summary>
+        /// Gets the counters of the given phase.
+        /// </summary>
+        /// <param name="phase">The phase.</param>
+        /// <returns>A <see cref="CompilePhaseStatistics"/> snapshot.</returns>
+        public CompilePhaseStatistics this[CompilePhase phase] => _phases[(int)phase];
+
+        internal unsafe CompileStatistics(NativeCompileStatistics stats)
+        {
+            CallCount = stats.CallCount;
+            _phases = new CompilePhaseStatistics[NativeCompileStatistics.PhaseCount];
+            for (int i = 0; i < _phases.Length; i++)
+            {
+                _phases[i] = new CompilePhaseStatistics(stats.Phases[i * 3], stats.Phases[i * 3 + 1], stats.Phases[i * 3 + 2]);
+            }
+        }
+    }
+}
@@ -0,0 +1,141 @@
+using System;
+using System.Threading;
+
+namespace Veldrid.SPIRV
+{
+    /// <summary>
+    /// A compilation running on the native worker threads, started by one of the Begin methods of
+    /// <see cref="SpirvCompilation"/>. Its status can be polled without blocking, and it can be cancelled while it runs.
+    /// Cancellation takes effect at the next phase of the compilation. Disposing an unfinished task cancels it.
+    /// </summary>
+    /// <typeparam name="T">The type of the compilation output.</typeparam>
+    public unsafe class CompileTask<T> : IDisposable
+    {
+        internal delegate T ResultReader(CompilationResult* result);
+
+        private readonly ResultReader _readResult;
+        private IntPtr _task;
+        private bool _finished;
+        private T _output;
+        private Exception _error;
+
+        internal CompileTask(IntPtr task, ResultReader readResult)
+        {
+            if (task == IntPtr.Zero)
+            {
+                throw new SpirvCompilationException("Unable to start the compilation.");
+            }
+
+            _task = task;
+            _readResult = readResult;
+        }
+
+        /// <summary>
+        /// The current state of the compilation.
+        /// </summary>
+        public CompileTaskStatus Status => VeldridSpirvNative.GetCompileTaskStatus(GetHandle());
+
+        /// <summary>
+        /// Indicates whether the compilation has finished or was cancelled.
+        /// </summary>
+        public bool IsCompleted
+        {
+            get
+            {
+                CompileTaskStatus status = Status;
+                return status == CompileTaskStatus.Completed || status == CompileTaskStatus.Cancelled;
+            }
+        }
+
+        /// <summary>
+        /// Blocks until the compilation has finished or the given time has passed.
+        /// </summary>
+        /// <param name="millisecondsTimeout">The longest time to wait, or <see cref="Timeout.Infinite"/>.</param>
+        /// <returns>True if the compilation has finished.</returns>
+        public bool Wait(int millisecondsTimeout)
+        {
+            if (millisecondsTimeout < Timeout.Infinite)
+            {
+                throw new ArgumentOutOfRangeException(nameof(millisecondsTimeout));
+            }
+
+            uint timeout = millisecondsTimeout == Timeout.Infinite ? uint.MaxValue : (uint)millisecondsTimeout;
+            return VeldridSpirvNative.WaitCompileTask(GetHandle(), timeout);
+        }
+
+        /// <summary>
+        /// Requests that the compilation stops. Has no effect once the compilation has finished.
+        /// </summary>
+        public void Cancel()
+        {
+            VeldridSpirvNative.CancelCompileTask(GetHandle());
+        }
+
+        /// <summary>
+        /// Waits for the compilation to finish and returns its output.
+        /// </summary>
+        /// <returns>The compilation output.</returns>
+        /// <exception cref="OperationCanceledException">The compilation was cancelled.</exception>
+        /// <exception cref="SpirvCompilationException">The compilation failed.</exception>
+        public T GetResult()
+        {
+            if (!_finished)
+            {
+                Wait(Timeout.Infinite);
+                bool cancelled = Status == CompileTaskStatus.Cancelled;
+                CompilationResult* result = VeldridSpirvNative.TakeCompileTaskResult(GetHandle());
+                try
+                {
+                    if (cancelled)
+                    {
+                        _error = new OperationCanceledException(
+                            Util.GetString((byte*)result->GetData(0), result->GetLength(0)));
+                    }
+                    else
+                    {
+                        _output = _readResult(result);
+                    }
+                }
+                catch (SpirvCompilationException e)
+                {
+                    _error = e;
+                }
+                finally
+                {
+                    VeldridSpirvNative.FreeResult(result);
+                }
+
+                _finished = true;
+            }
+
+            if (_error != null)
+            {
+                throw _error;
+            }
+
+            return _output;
+        }
+
+        private IntPtr GetHandle()
+        {
+            if (_task == IntPtr.Zero)
+            {
+                throw new ObjectDisposedException(nameof(CompileTask<T>));
+            }
+
+            return _task;
+        }
+
+        /// <summary>
+        /// Releases the native task, cancelling the compilation if it has not finished.
+        /// </summary>
+        public void Dispose()
+        {
+            if (_task != IntPtr.Zero)
+            {
+                VeldridSpirvNative.DestroyCompileTask(_task);
+                _task = IntPtr.Zero;
+            }
+        }
+    }
+}
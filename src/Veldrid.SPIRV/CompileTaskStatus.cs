@@ -0,0 +1,25 @@
+namespace Veldrid.SPIRV
+{
+    /// <summary>
+    /// The state of a <see cref="CompileTask{T}"/>.
+    /// </summary>
+    public enum CompileTaskStatus : uint
+    {
+        /// <summary>
+        /// The task is waiting for a native worker thread.
+        /// </summary>
+        Pending,
+        /// <summary>
+        /// The compilation is running.
+        /// </summary>
+        Running,
+        /// <summary>
+        /// The compilation has finished, successfully or with an error.
+        /// </summary>
+        Completed,
+        /// <summary>
+        /// The compilation was cancelled before it finished.
+        /// </summary>
+        Cancelled,
+    }
+}
@@ -0,0 +1,38 @@
+namespace Veldrid.SPIRV
+{
+    /// <summary>
+    /// A snapshot of the counters maintained by the native cross-compilation result cache.
+    /// </summary>
+    public class CrossCompileCacheStatistics
+    {
+        /// <summary>
+        /// The number of cross-compile calls which were served from the cache.
+        /// </summary>
+        public ulong Hits { get; }
+        /// <summary>
+        /// The number of cross-compile calls which were not found in the cache.
+        /// </summary>
+        public ulong Misses { get; }
+        /// <summary>
+        /// The number of entries which were removed from the cache to stay within its capacity.
+        /// </summary>
+        public ulong Evictions { get; }
+        /// <summary>
+        /// The number of results currently stored in the cache.
+        /// </summary>
+        public uint EntryCount { get; }
+        /// <summary>
+        /// The maximum number of results the cache will store. Zero if the cache is disabled.
+        /// </summary>
+        public uint Capacity { get; }
+
+        internal CrossCompileCacheStatistics(NativeCacheStatistics stats)
+        {
+            Hits = stats.Hits;
+            Misses = stats.Misses;
+            Evictions = stats.Evictions;
+            EntryCount = stats.EntryCount;
+            Capacity = stats.Capacity;
+        }
+    }
+}
@@ -13,5 +13,9 @@ namespace Veldrid.SPIRV
         public InteropArray VertexShader;
         public InteropArray FragmentShader;
         public InteropArray ComputeShader;
+        public Bool32 SparseResourceLayouts;
+        public SpirvOptimization Optimization;
+        public Bool32 MinifyOutput;
+        public Bool32 PruneStageInterface;
     }
 }
@@ -32,6 +32,30 @@ namespace Veldrid.SPIRV
         /// element in the array will be matched by ID with the SPIR-V specialization constants defined in the shader.
         /// </summary>
         public SpecializationConstant[] Specializations { get; set; }
+        /// <summary>
+        /// Indicates whether reflection should list only the resources that are actually bound, with their set and binding
+        /// numbers, in <see cref="SpirvReflection.SparseResourceBindings"/>. <see cref="SpirvReflection.ResourceLayouts"/> is
+        /// then empty. This avoids producing hundreds of unused elements for shaders with large, mostly empty binding ranges.
+        /// </summary>
+        public bool SparseResourceLayouts { get; set; }
+        /// <summary>
+        /// The SPIR-V optimizer passes to run over the input modules before they are translated. Defaults to
+        /// <see cref="SpirvOptimization.None"/>.
+        /// </summary>
+        public SpirvOptimization Optimization { get; set; }
+        /// <summary>
+        /// Indicates whether the translated shader code should be minified: comments and optional whitespace are removed
+        /// and internal identifiers are shortened. The names of resources, vertex inputs and stage inputs and outputs are
+        /// kept, so the output can be used in the same way as the regular output. Smaller source code compiles faster on
+        /// some OpenGL drivers.
+        /// </summary>
+        public bool MinifyOutput { get; set; }
+        /// <summary>
+        /// Indicates whether vertex shader outputs which the fragment shader never reads should be removed, along with the
+        /// code which computes them. The remaining outputs and fragment inputs are given consecutive locations. This saves
+        /// interpolants and vertex work. It only affects vertex-fragment pairs, whose outputs must then be used together.
+        /// </summary>
+        public bool PruneStageInterface { get; set; }
 
         /// <summary>
         /// Constructs a new <see cref="CrossCompileOptions"/> with default values.
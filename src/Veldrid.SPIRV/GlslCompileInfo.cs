@@ -19,5 +19,9 @@ namespace Veldrid.SPIRV
         /// Element type: NativeMacroDefinition
         /// </summary>
         public InteropArray Macros;
+        /// <summary>
+        /// Element type: InteropArray (of byte)
+        /// </summary>
+        public InteropArray IncludeDirectories;
     };
 }
@@ -17,6 +17,11 @@ namespace Veldrid.SPIRV
         /// GLSL source code.
         /// </summary>
         public MacroDefinition[] Macros { get; set; }
+        /// <summary>
+        /// The directories searched for files named in #include directives. Quoted includes are first looked up relative to
+        /// the including file.
+        /// </summary>
+        public string[] IncludeDirectories { get; set; }
 
         /// <summary>
         /// Gets a default <see cref="GlslCompileOptions"/>.
@@ -29,6 +34,7 @@ namespace Veldrid.SPIRV
         public GlslCompileOptions()
         {
             Macros = Array.Empty<MacroDefinition>();
+            IncludeDirectories = Array.Empty<string>();
         }
 
         /// <summary>
@@ -43,6 +49,7 @@ namespace Veldrid.SPIRV
         {
             Debug = debug;
             Macros = macros ?? Array.Empty<MacroDefinition>();
+            IncludeDirectories = Array.Empty<string>();
         }
     }
 }
\ No newline at end of file
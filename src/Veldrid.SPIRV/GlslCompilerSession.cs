@@ -0,0 +1,83 @@
+using System;
+
+namespace Veldrid.SPIRV
+{
+    /// <summary>
+    /// A reusable GLSL to SPIR-V compiler. The session keeps native compiler instances and a prebuilt set of base options
+    /// alive between compilations, which makes it considerably cheaper than the static methods of <see cref="SpirvCompilation"/>
+    /// when many shaders are compiled with mostly the same options. A session may be used from multiple threads at once.
+    /// </summary>
+    public unsafe class GlslCompilerSession : IDisposable
+    {
+        private IntPtr _session;
+
+        /// <summary>
+        /// Constructs a new <see cref="GlslCompilerSession"/>.
+        /// </summary>
+        /// <param name="baseOptions">The options shared by every compilation made through this session.</param>
+        public GlslCompilerSession(GlslCompileOptions baseOptions)
+        {
+            int macroCount = baseOptions.Macros.Length;
+            NativeMacroDefinition* macros = stackalloc NativeMacroDefinition[macroCount];
+            for (int i = 0; i < macroCount; i++)
+            {
+                macros[i] = new NativeMacroDefinition(baseOptions.Macros[i]);
+            }
+
+            GlslSessionInfo info;
+            info.Debug = baseOptions.Debug;
+            info.Macros = new InteropArray((uint)macroCount, macros);
+            _session = VeldridSpirvNative.CreateGlslCompilerSession(&info);
+            if (_session == IntPtr.Zero)
+            {
+                throw new SpirvCompilationException("Failed to create a GLSL compiler session.");
+            }
+        }
+
+        /// <summary>
+        /// Compiles the given GLSL source code into SPIR-V using the base options of this session.
+        /// </summary>
+        /// <param name="sourceText">The shader source code.</param>
+        /// <param name="fileName">A descriptive name for the shader. May be null.</param>
+        /// <param name="stage">The <see cref="ShaderStages"/> which the shader is used in.</param>
+        /// <returns>A <see cref="SpirvCompilationResult"/> containing the compiled SPIR-V bytecode.</returns>
+        public SpirvCompilationResult Compile(string sourceText, string fileName, ShaderStages stage)
+            => Compile(sourceText, fileName, stage, GlslCompileOptions.Default);
+
+        /// <summary>
+        /// Compiles the given GLSL source code into SPIR-V.
+        /// </summary>
+        /// <param name="sourceText">The shader source code.</param>
+        /// <param name="fileName">A descriptive name for the shader. May be null.</param>
+        /// <param name="stage">The <see cref="ShaderStages"/> which the shader is used in.</param>
+        /// <param name="options">Additional options for this compilation. Its macros are defined in addition to the base
+        /// macros of the session, and debug information is generated if either the session or these options request it.
+        /// </param>
+        /// <returns>A <see cref="SpirvCompilationResult"/> containing the compiled SPIR-V bytecode.</returns>
+        public SpirvCompilationResult Compile(
+            string sourceText,
+            string fileName,
+            ShaderStages stage,
+            GlslCompileOptions options)
+        {
+            if (_session == IntPtr.Zero)
+            {
+                throw new ObjectDisposedException(nameof(GlslCompilerSession));
+            }
+
+            return SpirvCompilation.CompileGlslToSpirv(sourceText, fileName, stage, options, _session);
+        }
+
+        /// <summary>
+        /// Releases the native resources held by this session.
+        /// </summary>
+        public void Dispose()
+        {
+            if (_session != IntPtr.Zero)
+            {
+                VeldridSpirvNative.DestroyGlslCompilerSession(_session);
+                _session = IntPtr.Zero;
+            }
+        }
+    }
+}
@@ -0,0 +1,14 @@
+using System.Runtime.InteropServices;
+
+namespace Veldrid.SPIRV
+{
+    [StructLayout(LayoutKind.Sequential, Pack = 1)]
+    internal struct GlslSessionInfo
+    {
+        public Bool32 Debug;
+        /// <summary>
+        /// Element type: NativeMacroDefinition
+        /// </summary>
+        public InteropArray Macros;
+    }
+}
@@ -0,0 +1,66 @@
+using System;
+using System.Collections.Generic;
+using System.Runtime.InteropServices;
+using System.Text;
+
+namespace Veldrid.SPIRV
+{
+    /// <summary>
+    /// Owns unmanaged memory used to describe nested native structures for the duration of a single call.
+    /// </summary>
+    internal unsafe sealed class InteropAllocator : IDisposable
+    {
+        private readonly List<IntPtr> _allocations = new List<IntPtr>();
+
+        public T* Allocate<T>(int count) where T : unmanaged
+        {
+            IntPtr ptr = Marshal.AllocHGlobal(Math.Max(count, 1) * sizeof(T));
+            _allocations.Add(ptr);
+            return (T*)ptr;
+        }
+
+        public InteropArray GetString(string value, Encoding encoding)
+        {
+            if (string.IsNullOrEmpty(value))
+            {
+                return new InteropArray(0, null);
+            }
+
+            int byteCount = encoding.GetByteCount(value);
+            byte* bytes = Allocate<byte>(byteCount);
+            fixed (char* valuePtr = value)
+            {
+                encoding.GetBytes(valuePtr, value.Length, bytes, byteCount);
+            }
+
+            return new InteropArray((uint)byteCount, bytes);
+        }
+
+        public byte* GetNullTerminatedString(string value, Encoding encoding)
+        {
+            if (value == null)
+            {
+                return null;
+            }
+
+            int byteCount = encoding.GetByteCount(value);
+            byte* bytes = Allocate<byte>(byteCount + 1);
+            fixed (char* valuePtr = value)
+            {
+                encoding.GetBytes(valuePtr, value.Length, bytes, byteCount);
+            }
+            bytes[byteCount] = 0;
+
+            return bytes;
+        }
+
+        public void Dispose()
+        {
+            foreach (IntPtr ptr in _allocations)
+            {
+                Marshal.FreeHGlobal(ptr);
+            }
+            _allocations.Clear();
+        }
+    }
+}
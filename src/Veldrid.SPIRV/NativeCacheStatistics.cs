@@ -0,0 +1,14 @@
+using System.Runtime.InteropServices;
+
+namespace Veldrid.SPIRV
+{
+    [StructLayout(LayoutKind.Sequential, Pack = 1)]
+    internal struct NativeCacheStatistics
+    {
+        public ulong Hits;
+        public ulong Misses;
+        public ulong Evictions;
+        public uint EntryCount;
+        public uint Capacity;
+    }
+}
@@ -0,0 +1,14 @@
+using System.Runtime.InteropServices;
+
+namespace Veldrid.SPIRV
+{
+    [StructLayout(LayoutKind.Sequential, Pack = 1)]
+    internal unsafe struct NativeCompileStatistics
+    {
+        public const int PhaseCount = 7;
+
+        public ulong CallCount;
+        // Nanoseconds, Calls and Bytes for each CompilePhase, in order.
+        public fixed ulong Phases[PhaseCount * 3];
+    }
+}
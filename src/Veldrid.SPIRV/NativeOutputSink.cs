@@ -0,0 +1,20 @@
+using System;
+using System.Runtime.InteropServices;
+
+namespace Veldrid.SPIRV
+{
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    internal unsafe delegate void OutputWriteCallback(IntPtr userData, uint bufferIndex, byte* data, uint size);
+
+    [StructLayout(LayoutKind.Sequential, Pack = 1)]
+    internal struct NativeOutputSink
+    {
+        /// <summary>
+        /// A function pointer to an <see cref="OutputWriteCallback"/>, or zero to write to
+        /// <see cref="FileDescriptor"/>.
+        /// </summary>
+        public IntPtr Callback;
+        public IntPtr UserData;
+        public int FileDescriptor;
+    }
+}
@@ -0,0 +1,69 @@
+using System.Runtime.InteropServices;
+
+namespace Veldrid.SPIRV
+{
+    [StructLayout(LayoutKind.Sequential, Pack = 1)]
+    internal struct NativeShaderBundleEntry
+    {
+        public SpirvFingerprint KeyHash;
+        public uint KeyOffset;
+        public uint KeyLength;
+        public uint FirstBlob;
+        public uint BlobCount;
+        public uint FirstVertexElement;
+        public uint VertexElementCount;
+        public uint FirstResourceElement;
+        public uint ResourceElementCount;
+        public uint ResourceLayoutCount;
+        public Bool32 SparseResourceLayouts;
+    }
+
+    [StructLayout(LayoutKind.Sequential, Pack = 1)]
+    internal struct NativeShaderBundleBlob
+    {
+        public const uint SpirvTarget = 0xFFFFFFFF;
+
+        public uint Target; // CrossCompileTarget, or SpirvTarget
+        public uint Stage; // ShaderStages
+        public uint Encoding;
+        public uint Reserved;
+        public ulong Offset;
+        public ulong Size;
+        public ulong DecodedSize;
+    }
+
+    [StructLayout(LayoutKind.Sequential, Pack = 1)]
+    internal struct NativeShaderBundleVertexElement
+    {
+        public uint NameOffset;
+        public uint NameLength;
+        public VertexElementSemantic Semantic;
+        public VertexElementFormat Format;
+        public ushort Reserved;
+        public uint Offset;
+    }
+
+    [StructLayout(LayoutKind.Sequential, Pack = 1)]
+    internal struct NativeShaderBundleResourceElement
+    {
+        public uint Set;
+        public uint Binding;
+        public uint NameOffset;
+        public uint NameLength;
+        public ResourceKind Kind;
+        public ShaderStages Stages;
+        public ushort Reserved;
+        public ResourceLayoutElementOptions Options;
+    }
+
+    [StructLayout(LayoutKind.Sequential, Pack = 1)]
+    internal unsafe struct NativeShaderBundleVariant
+    {
+        public byte* Base;
+        public NativeShaderBundleEntry* Entry;
+        public NativeShaderBundleBlob* Blobs;
+        public NativeShaderBundleVertexElement* VertexElements;
+        public NativeShaderBundleResourceElement* ResourceElements;
+        public byte* Strings;
+    }
+}
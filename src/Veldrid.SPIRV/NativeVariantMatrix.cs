@@ -0,0 +1,64 @@
+using System.Runtime.InteropServices;
+
+namespace Veldrid.SPIRV
+{
+    [StructLayout(LayoutKind.Sequential, Pack = 1)]
+    internal struct NativeVariantStageSource
+    {
+        public ShadercShaderKind Kind;
+        /// <summary>
+        /// Element type: byte
+        /// </summary>
+        public InteropArray SourceText;
+        /// <summary>
+        /// Element type: byte
+        /// </summary>
+        public InteropArray FileName;
+    }
+
+    [StructLayout(LayoutKind.Sequential, Pack = 1)]
+    internal struct NativeVariantMatrixInfo
+    {
+        /// <summary>
+        /// Element type: NativeVariantStageSource
+        /// </summary>
+        public InteropArray Stages;
+        public Bool32 Debug;
+        /// <summary>
+        /// Element type: NativeMacroDefinition
+        /// </summary>
+        public InteropArray Macros;
+        /// <summary>
+        /// Element type: InteropArray (of NativeMacroDefinition)
+        /// </summary>
+        public InteropArray Axes;
+        /// <summary>
+        /// Element type: InteropArray (of byte)
+        /// </summary>
+        public InteropArray IncludeDirectories;
+        public Bool32 FixClipSpaceZ;
+        public Bool32 InvertY;
+        public Bool32 NormalizeResourceNames;
+        /// <summary>
+        /// Element type: SpecializationConstant
+        /// </summary>
+        public InteropArray Specializations;
+        /// <summary>
+        /// Element type: CrossCompileTarget
+        /// </summary>
+        public InteropArray Targets;
+    }
+
+    [StructLayout(LayoutKind.Sequential, Pack = 1)]
+    internal struct NativeVariantMatrixResult
+    {
+        /// <summary>
+        /// Element type: uint
+        /// </summary>
+        public InteropArray PermutationVariants;
+        /// <summary>
+        /// Element type: CompilationResult*
+        /// </summary>
+        public InteropArray Variants;
+    }
+}
@@ -7,6 +7,7 @@ namespace Veldrid.SPIRV
     {
         public InteropArray VertexElements; // InteropArray<NativeVertexElementDescription>
         public InteropArray ResourceLayouts; // InteropArray<NativeResourceLayoutDescription>
+        public InteropArray SparseBindings; // InteropArray<NativeSparseResourceBinding>
     }
 
     [StructLayout(LayoutKind.Sequential, Pack = 1)]
@@ -32,4 +33,12 @@ namespace Veldrid.SPIRV
         public ShaderStages Stages;
         public ResourceLayoutElementOptions Options;
     }
+
+    [StructLayout(LayoutKind.Sequential, Pack = 1)]
+    internal struct NativeSparseResourceBinding
+    {
+        public uint Set;
+        public uint Binding;
+        public NativeResourceElementDescription Element;
+    }
 }
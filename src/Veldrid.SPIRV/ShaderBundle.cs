@@ -0,0 +1,81 @@
+using System;
+using System.Text;
+
+namespace Veldrid.SPIRV
+{
+    /// <summary>
+    /// A shader bundle file written by <see cref="ShaderBundleWriter"/>. The file is memory-mapped, and variants are found
+    /// through a hashed index without reading the rest of the bundle. A bundle may be used from multiple threads at once.
+    /// </summary>
+    public unsafe class ShaderBundle : IDisposable
+    {
+        private IntPtr _bundle;
+
+        /// <summary>
+        /// Opens the shader bundle at the given path.
+        /// </summary>
+        /// <param name="path">The path of the bundle file.</param>
+        public ShaderBundle(string path)
+        {
+            using (InteropAllocator allocator = new InteropAllocator())
+            {
+                _bundle = VeldridSpirvNative.OpenShaderBundle(allocator.GetNullTerminatedString(path, Encoding.UTF8));
+            }
+
+            if (_bundle == IntPtr.Zero)
+            {
+                throw new SpirvCompilationException($"Unable to open \"{path}\" as a shader bundle.");
+            }
+        }
+
+        /// <summary>
+        /// The number of variants in the bundle.
+        /// </summary>
+        public uint VariantCount => VeldridSpirvNative.GetShaderBundleVariantCount(GetHandle());
+
+        /// <summary>
+        /// Looks up the variant with the given key.
+        /// </summary>
+        /// <param name="key">The key the variant was added with.</param>
+        /// <param name="variant">The variant, if it was found. It can only be used while the bundle is open.</param>
+        /// <returns>True if the bundle contains a variant with the given key.</returns>
+        public bool TryGetVariant(string key, out ShaderBundleVariant variant)
+        {
+            byte[] keyBytes = Encoding.UTF8.GetBytes(key);
+            NativeShaderBundleVariant nativeVariant;
+            fixed (byte* keyPtr = keyBytes)
+            {
+                if (!VeldridSpirvNative.FindShaderBundleVariant(GetHandle(), keyPtr, (uint)keyBytes.Length, &nativeVariant))
+                {
+                    variant = null;
+                    return false;
+                }
+            }
+
+            variant = new ShaderBundleVariant(this, key, nativeVariant);
+            return true;
+        }
+
+        internal IntPtr GetHandle()
+        {
+            if (_bundle == IntPtr.Zero)
+            {
+                throw new ObjectDisposedException(nameof(ShaderBundle));
+            }
+
+            return _bundle;
+        }
+
+        /// <summary>
+        /// Unmaps the bundle file. Variants obtained from this bundle can no longer be used.
+        /// </summary>
+        public void Dispose()
+        {
+            if (_bundle != IntPtr.Zero)
+            {
+                VeldridSpirvNative.CloseShaderBundle(_bundle);
+                _bundle = IntPtr.Zero;
+            }
+        }
+    }
+}
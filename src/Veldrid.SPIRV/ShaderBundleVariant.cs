@@ -0,0 +1,141 @@
+using System;
+
+namespace Veldrid.SPIRV
+{
+    /// <summary>
+    /// A variant stored in a <see cref="ShaderBundle"/>. Shaders are read from the bundle when they are requested.
+    /// </summary>
+    public unsafe class ShaderBundleVariant
+    {
+        private readonly ShaderBundle _bundle;
+        private readonly NativeShaderBundleVariant _variant;
+
+        /// <summary>
+        /// The key of the variant.
+        /// </summary>
+        public string Key { get; }
+
+        /// <summary>
+        /// The reflection information of the variant.
+        /// </summary>
+        public SpirvReflection Reflection { get; }
+
+        internal ShaderBundleVariant(ShaderBundle bundle, string key, NativeShaderBundleVariant variant)
+        {
+            _bundle = bundle;
+            _variant = variant;
+            Key = key;
+            Reflection = CreateReflection();
+        }
+
+        /// <summary>
+        /// Gets the SPIR-V bytecode of the given stage.
+        /// </summary>
+        /// <param name="stage">The shader stage.</param>
+        /// <returns>The SPIR-V bytecode, or null if the variant has no such stage.</returns>
+        public byte[] GetSpirvBytes(ShaderStages stage) => ReadBlob(NativeShaderBundleBlob.SpirvTarget, stage);
+
+        /// <summary>
+        /// Gets the translated shader code of the given stage in the given language.
+        /// </summary>
+        /// <param name="target">The target language.</param>
+        /// <param name="stage">The shader stage.</param>
+        /// <returns>The UTF-8 encoded shader code, or null if the variant was not compiled for that target and stage.
+        /// </returns>
+        public byte[] GetShaderBytes(CrossCompileTarget target, ShaderStages stage) => ReadBlob((uint)target, stage);
+
+        /// <summary>
+        /// Gets the translated shader code of the given stage in the given language.
+        /// </summary>
+        /// <param name="target">The target language.</param>
+        /// <param name="stage">The shader stage.</param>
+        /// <returns>The shader code, or null if the variant was not compiled for that target and stage.</returns>
+        public string GetShaderText(CrossCompileTarget target, ShaderStages stage)
+        {
+            byte[] bytes = GetShaderBytes(target, stage);
+            return bytes != null ? System.Text.Encoding.UTF8.GetString(bytes) : null;
+        }
+
+        private byte[] ReadBlob(uint target, ShaderStages stage)
+        {
+            IntPtr bundle = _bundle.GetHandle();
+            for (uint i = 0; i < _variant.Entry->BlobCount; i++)
+            {
+                NativeShaderBundleBlob* blob = &_variant.Blobs[i];
+                if (blob->Target == target && blob->Stage == (uint)stage)
+                {
+                    byte[] bytes = new byte[blob->DecodedSize];
+                    fixed (byte* bytesPtr = bytes)
+                    {
+                        if (!VeldridSpirvNative.ReadShaderBundleBlob(bundle, blob, bytesPtr, (ulong)bytes.Length))
+                        {
+                            throw new SpirvCompilationException($"The shader bundle entry for \"{Key}\" is corrupt.");
+                        }
+                    }
+
+                    return bytes;
+                }
+            }
+
+            return null;
+        }
+
+        private string GetString(uint offset, uint length) => Util.GetString(_variant.Strings + offset, length);
+
+        private SpirvReflection CreateReflection()
+        {
+            NativeShaderBundleEntry* entry = _variant.Entry;
+            VertexElementDescription[] vertexElements = new VertexElementDescription[entry->VertexElementCount];
+            for (uint i = 0; i < entry->VertexElementCount; i++)
+            {
+                NativeShaderBundleVertexElement* element = &_variant.VertexElements[i];
+                vertexElements[i] = new VertexElementDescription(
+                    GetString(element->NameOffset, element->NameLength),
+                    element->Semantic,
+                    element->Format,
+                    element->Offset);
+            }
+
+            if (entry->SparseResourceLayouts)
+            {
+                SparseResourceBinding[] bindings = new SparseResourceBinding[entry->ResourceElementCount];
+                for (uint i = 0; i < entry->ResourceElementCount; i++)
+                {
+                    NativeShaderBundleResourceElement* element = &_variant.ResourceElements[i];
+                    bindings[i] = new SparseResourceBinding(element->Set, element->Binding, GetResourceElement(element));
+                }
+
+                return new SpirvReflection(vertexElements, Array.Empty<ResourceLayoutDescription>(), bindings);
+            }
+
+            // Elements are stored set-major and binding-ordered, so each layout is one contiguous run.
+            ResourceLayoutDescription[] layouts = new ResourceLayoutDescription[entry->ResourceLayoutCount];
+            uint next = 0;
+            for (uint set = 0; set < entry->ResourceLayoutCount; set++)
+            {
+                uint first = next;
+                while (next < entry->ResourceElementCount && _variant.ResourceElements[next].Set == set)
+                {
+                    next++;
+                }
+
+                layouts[set].Elements = new ResourceLayoutElementDescription[next - first];
+                for (uint i = first; i < next; i++)
+                {
+                    layouts[set].Elements[i - first] = GetResourceElement(&_variant.ResourceElements[i]);
+                }
+            }
+
+            return new SpirvReflection(vertexElements, layouts, Array.Empty<SparseResourceBinding>());
+        }
+
+        private ResourceLayoutElementDescription GetResourceElement(NativeShaderBundleResourceElement* element)
+        {
+            return new ResourceLayoutElementDescription(
+                GetString(element->NameOffset, element->NameLength),
+                element->Kind,
+                element->Stages,
+                element->Options);
+        }
+    }
+}
@@ -0,0 +1,147 @@
+using System;
+using System.Text;
+
+namespace Veldrid.SPIRV
+{
+    /// <summary>
+    /// Collects compiled shader variants and writes them into a single shader bundle file, which can be loaded with
+    /// <see cref="ShaderBundle"/>. Each variant holds its SPIR-V, the translated shader of every requested target and its
+    /// reflection information. Variants may be added from multiple threads at once.
+    /// </summary>
+    public unsafe class ShaderBundleWriter : IDisposable
+    {
+        private IntPtr _writer;
+
+        /// <summary>
+        /// Constructs a new <see cref="ShaderBundleWriter"/>.
+        /// </summary>
+        /// <param name="compress">Indicates whether the shaders should be compressed. Compressed shaders are smaller on
+        /// disk but must be decompressed when they are read.</param>
+        public ShaderBundleWriter(bool compress)
+        {
+            _writer = VeldridSpirvNative.CreateShaderBundleWriter(compress);
+        }
+
+        /// <summary>
+        /// Cross-compiles the given vertex-fragment pair into every target and adds it to the bundle.
+        /// </summary>
+        /// <param name="key">The name used to look up the variant. Must be unique within the bundle.</param>
+        /// <param name="vsSpirvBytes">The vertex shader's SPIR-V bytecode.</param>
+        /// <param name="fsSpirvBytes">The fragment shader's SPIR-V bytecode.</param>
+        /// <param name="targets">The languages to translate the shaders into.</param>
+        /// <param name="options">The options for shader translation.</param>
+        public void AddVertexFragment(
+            string key,
+            byte[] vsSpirvBytes,
+            byte[] fsSpirvBytes,
+            CrossCompileTarget[] targets,
+            CrossCompileOptions options)
+            => AddVariant(key, vsSpirvBytes, fsSpirvBytes, Array.Empty<byte>(), targets, options);
+
+        /// <summary>
+        /// Cross-compiles the given compute shader into every target and adds it to the bundle.
+        /// </summary>
+        /// <param name="key">The name used to look up the variant. Must be unique within the bundle.</param>
+        /// <param name="csSpirvBytes">The compute shader's SPIR-V bytecode.</param>
+        /// <param name="targets">The languages to translate the shader into.</param>
+        /// <param name="options">The options for shader translation.</param>
+        public void AddCompute(string key, byte[] csSpirvBytes, CrossCompileTarget[] targets, CrossCompileOptions options)
+            => AddVariant(key, Array.Empty<byte>(), Array.Empty<byte>(), csSpirvBytes, targets, options);
+
+        private void AddVariant(
+            string key,
+            byte[] vsBytes,
+            byte[] fsBytes,
+            byte[] csBytes,
+            CrossCompileTarget[] targets,
+            CrossCompileOptions options)
+        {
+            if (_writer == IntPtr.Zero)
+            {
+                throw new ObjectDisposedException(nameof(ShaderBundleWriter));
+            }
+
+            byte[] keyBytes = Encoding.UTF8.GetBytes(key);
+            CrossCompileInfo info = default(CrossCompileInfo);
+            SpirvCompilation.FillCrossCompileInfo(ref info, default(CrossCompileTarget), options);
+            using (InteropAllocator allocator = new InteropAllocator())
+            fixed (byte* keyPtr = keyBytes)
+            fixed (byte* vsBytesPtr = vsBytes)
+            fixed (byte* fsBytesPtr = fsBytes)
+            fixed (byte* csBytesPtr = csBytes)
+            fixed (CrossCompileTarget* targetsPtr = targets)
+            {
+                info.VertexShader = new InteropArray((uint)vsBytes.Length / 4, vsBytesPtr);
+                info.FragmentShader = new InteropArray((uint)fsBytes.Length / 4, fsBytesPtr);
+                info.ComputeShader = new InteropArray((uint)csBytes.Length / 4, csBytesPtr);
+                info.Specializations = SpirvCompilation.GetSpecializations(allocator, options.Specializations);
+
+                CompilationResult* result = null;
+                try
+                {
+                    result = VeldridSpirvNative.AddShaderBundleVariant(
+                        _writer,
+                        keyPtr,
+                        (uint)keyBytes.Length,
+                        &info,
+                        targetsPtr,
+                        (uint)targets.Length);
+                    if (!result->Succeeded)
+                    {
+                        throw new SpirvCompilationException(
+                            "Compilation failed: " + Util.GetString((byte*)result->GetData(0), result->GetLength(0)));
+                    }
+                }
+                finally
+                {
+                    if (result != null)
+                    {
+                        VeldridSpirvNative.FreeResult(result);
+                    }
+                }
+            }
+        }
+
+        /// <summary>
+        /// Writes every variant added so far to the given path, replacing any existing file.
+        /// </summary>
+        /// <param name="path">The path of the bundle file.</param>
+        public void Write(string path)
+        {
+            if (_writer == IntPtr.Zero)
+            {
+                throw new ObjectDisposedException(nameof(ShaderBundleWriter));
+            }
+
+            CompilationResult* result;
+            using (InteropAllocator allocator = new InteropAllocator())
+            {
+                result = VeldridSpirvNative.WriteShaderBundle(_writer, allocator.GetNullTerminatedString(path, Encoding.UTF8));
+            }
+
+            try
+            {
+                if (!result->Succeeded)
+                {
+                    throw new SpirvCompilationException(Util.GetString((byte*)result->GetData(0), result->GetLength(0)));
+                }
+            }
+            finally
+            {
+                VeldridSpirvNative.FreeResult(result);
+            }
+        }
+
+        /// <summary>
+        /// Releases the native resources held by this writer.
+        /// </summary>
+        public void Dispose()
+        {
+            if (_writer != IntPtr.Zero)
+            {
+                VeldridSpirvNative.DestroyShaderBundleWriter(_writer);
+                _writer = IntPtr.Zero;
+            }
+        }
+    }
+}
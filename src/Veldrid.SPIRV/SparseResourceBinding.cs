@@ -0,0 +1,34 @@
+namespace Veldrid.SPIRV
+{
+    /// <summary>
+    /// Describes a resource used by a compiled shader set together with the slot it is bound to.
+    /// </summary>
+    public struct SparseResourceBinding
+    {
+        /// <summary>
+        /// The index of the resource set.
+        /// </summary>
+        public uint Set;
+        /// <summary>
+        /// The binding slot within the resource set.
+        /// </summary>
+        public uint Binding;
+        /// <summary>
+        /// The description of the resource.
+        /// </summary>
+        public ResourceLayoutElementDescription Element;
+
+        /// <summary>
+        /// Constructs a new <see cref="SparseResourceBinding"/>.
+        /// </summary>
+        /// <param name="set">The index of the resource set.</param>
+        /// <param name="binding">The binding slot within the resource set.</param>
+        /// <param name="element">The description of the resource.</param>
+        public SparseResourceBinding(uint set, uint binding, ResourceLayoutElementDescription element)
+        {
+            Set = set;
+            Binding = binding;
+            Element = element;
+        }
+    }
+}
@@ -1,4 +1,6 @@
 ﻿using System;
+using System.IO;
+using System.Runtime.InteropServices;
 using System.Text;
 
 namespace Veldrid.SPIRV
@@ -8,6 +10,9 @@ namespace Veldrid.SPIRV
     /// </summary>
     public static class SpirvCompilation
     {
+        // Larger numbers of specialization sets are described in heap memory rather than on the stack.
+        private const int MaxStackSpecializationSets = 16;
+
         /// <summary>
         /// Cross-compiles the given vertex-fragment pair into some target language.
         /// </summary>
@@ -88,11 +93,8 @@ namespace Veldrid.SPIRV
                 nativeSpecConstants[i].Constant = options.Specializations[i].Data;
             }
 
-            CrossCompileInfo info;
-            info.Target = target;
-            info.FixClipSpaceZ = options.FixClipSpaceZ;
-            info.InvertY = options.InvertVertexOutputY;
-            info.NormalizeResourceNames = options.NormalizeResourceNames;
+            CrossCompileInfo info = default(CrossCompileInfo);
+            FillCrossCompileInfo(ref info, target, options);
             fixed (byte* vsBytesPtr = vsSpirvBytes)
             fixed (byte* fsBytesPtr = fsSpirvBytes)
             {
@@ -104,52 +106,74 @@ namespace Veldrid.SPIRV
                 try
                 {
                     result = VeldridSpirvNative.CrossCompile(&info);
-                    if (!result->Succeeded)
+                    return ReadVertexFragmentResult(result);
+                }
+                finally
+                {
+                    if (result != null)
                     {
-                        throw new SpirvCompilationException(
-                            "Compilation failed: " + Util.GetString((byte*)result->GetData(0), result->GetLength(0)));
+                        VeldridSpirvNative.FreeResult(result);
                     }
+                }
+            }
+        }
 
-                    string vsCode = Util.GetString((byte*)result->GetData(0), result->GetLength(0));
-                    string fsCode = Util.GetString((byte*)result->GetData(1), result->GetLength(1));
+        /// <summary>
+        /// Cross-compiles the given vertex-fragment pair into several target languages. Each module is parsed once and
+        /// reused for every target.
+        /// </summary>
+        /// <param name="vsBytes">The vertex shader's SPIR-V bytecode.</param>
+        /// <param name="fsBytes">The fragment shader's SPIR-V bytecode.</param>
+        /// <param name="targets">The target languages.</param>
+        /// <param name="options">The options for shader translation.</param>
+        /// <returns>One <see cref="VertexFragmentCompilationResult"/> per target, in the same order. All of them share the
+        /// same <see cref="SpirvReflection"/>.</returns>
+        public static unsafe VertexFragmentCompilationResult[] CompileVertexFragment(
+            byte[] vsBytes,
+            byte[] fsBytes,
+            CrossCompileTarget[] targets,
+            CrossCompileOptions options)
+        {
+            if (!Util.HasSpirvHeader(vsBytes) || !Util.HasSpirvHeader(fsBytes))
+            {
+                throw new ArgumentException(
+                    "Multi-target compilation requires SPIR-V bytecode. GLSL source code can be compiled with CompileGlslToSpirv.");
+            }
 
-                    ReflectionInfo* reflInfo = &result->ReflectionInfo;
+            CrossCompileInfo info = default(CrossCompileInfo);
+            FillCrossCompileInfo(ref info, default(CrossCompileTarget), options);
+            using (InteropAllocator allocator = new InteropAllocator())
+            fixed (byte* vsBytesPtr = vsBytes)
+            fixed (byte* fsBytesPtr = fsBytes)
+            fixed (CrossCompileTarget* targetsPtr = targets)
+            {
+                info.VertexShader = new InteropArray((uint)vsBytes.Length / 4, vsBytesPtr);
+                info.FragmentShader = new InteropArray((uint)fsBytes.Length / 4, fsBytesPtr);
+                info.Specializations = GetSpecializations(allocator, options.Specializations);
 
-                    VertexElementDescription[] vertexElements = new VertexElementDescription[reflInfo->VertexElements.Count];
-                    for (uint i = 0; i < reflInfo->VertexElements.Count; i++)
+                CompilationResult* result = null;
+                try
+                {
+                    result = VeldridSpirvNative.CrossCompileMultiTarget(&info, targetsPtr, (uint)targets.Length);
+                    if (!result->Succeeded)
                     {
-                        ref NativeVertexElementDescription nativeDesc
-                            = ref reflInfo->VertexElements.Ref<NativeVertexElementDescription>(i);
-                        vertexElements[i] = new VertexElementDescription(
-                            Util.GetString((byte*)nativeDesc.Name.Data, nativeDesc.Name.Count),
-                            nativeDesc.Semantic,
-                            nativeDesc.Format,
-                            nativeDesc.Offset);
+                        throw new SpirvCompilationException(
+                            "Compilation failed: " + Util.GetString((byte*)result->GetData(0), result->GetLength(0)));
                     }
 
-                    ResourceLayoutDescription[] layouts = new ResourceLayoutDescription[reflInfo->ResourceLayouts.Count];
-                    for (uint i = 0; i < reflInfo->ResourceLayouts.Count; i++)
+                    SpirvReflection reflection = GetReflection(&result->ReflectionInfo);
+
+                    // The outputs are stored target-major: both stages of the first target, then of the second, and so on.
+                    VertexFragmentCompilationResult[] results = new VertexFragmentCompilationResult[targets.Length];
+                    for (uint i = 0; i < results.Length; i++)
                     {
-                        ref NativeResourceLayoutDescription nativeDesc =
-                            ref reflInfo->ResourceLayouts.Ref<NativeResourceLayoutDescription>(i);
-                        layouts[i].Elements = new ResourceLayoutElementDescription[nativeDesc.ResourceElements.Count];
-                        for (uint j = 0; j < nativeDesc.ResourceElements.Count; j++)
-                        {
-                            ref NativeResourceElementDescription elemDesc =
-                                ref nativeDesc.ResourceElements.Ref<NativeResourceElementDescription>(j);
-                            layouts[i].Elements[j] = new ResourceLayoutElementDescription(
-                                Util.GetString((byte*)elemDesc.Name.Data, elemDesc.Name.Count),
-                                elemDesc.Kind,
-                                elemDesc.Stages,
-                                elemDesc.Options);
-                        }
+                        results[i] = new VertexFragmentCompilationResult(
+                            Util.GetString((byte*)result->GetData(i * 2), result->GetLength(i * 2)),
+                            Util.GetString((byte*)result->GetData(i * 2 + 1), result->GetLength(i * 2 + 1)),
+                            reflection);
                     }
 
-                    SpirvReflection reflection = new SpirvReflection(
-                        vertexElements,
-                        layouts);
-
-                    return new VertexFragmentCompilationResult(vsCode, fsCode, reflection);
+                    return results;
                 }
                 finally
                 {
@@ -205,54 +229,98 @@ namespace Veldrid.SPIRV
                 }
             }
 
-            CrossCompileInfo info;
-            info.Target = target;
-            info.FixClipSpaceZ = options.FixClipSpaceZ;
-            info.InvertY = options.InvertVertexOutputY;
-            info.NormalizeResourceNames = options.NormalizeResourceNames;
+            CrossCompileInfo info = default(CrossCompileInfo);
+            FillCrossCompileInfo(ref info, target, options);
+            using (InteropAllocator allocator = new InteropAllocator())
             fixed (byte* csBytesPtr = csSpirvBytes)
-            fixed (SpecializationConstant* specConstants = options.Specializations)
             {
                 info.ComputeShader = new InteropArray((uint)csSpirvBytes.Length / 4, csBytesPtr);
-                info.Specializations = new InteropArray((uint)options.Specializations.Length, specConstants);
+                info.Specializations = GetSpecializations(allocator, options.Specializations);
 
                 CompilationResult* result = null;
                 try
                 {
                     result = VeldridSpirvNative.CrossCompile(&info);
-                    if (!result->Succeeded)
+                    return ReadComputeResult(result);
+                }
+                finally
+                {
+                    if (result != null)
                     {
-                        throw new SpirvCompilationException(
-                            "Compilation failed: " + Util.GetString((byte*)result->GetData(0), result->GetLength(0)));
+                        VeldridSpirvNative.FreeResult(result);
                     }
+                }
+            }
+        }
 
-                    string csCode = Util.GetString((byte*)result->GetData(0), result->GetLength(0));
+        /// <summary>
+        /// Cross-compiles the vertex-fragment pair stored in the given SPIR-V files into some target language. The files are
+        /// memory-mapped rather than read into managed memory.
+        /// </summary>
+        /// <param name="vsPath">The path of the vertex shader's SPIR-V file.</param>
+        /// <param name="fsPath">The path of the fragment shader's SPIR-V file.</param>
+        /// <param name="target">The target language.</param>
+        /// <param name="options">The options for shader translation.</param>
+        /// <returns>A <see cref="VertexFragmentCompilationResult"/> containing the compiled output.</returns>
+        public static unsafe VertexFragmentCompilationResult CompileVertexFragmentFiles(
+            string vsPath,
+            string fsPath,
+            CrossCompileTarget target,
+            CrossCompileOptions options)
+        {
+            if (vsPath == null || fsPath == null)
+            {
+                throw new ArgumentNullException(vsPath == null ? nameof(vsPath) : nameof(fsPath));
+            }
 
-                    ReflectionInfo* reflInfo = &result->ReflectionInfo;
+            return CrossCompileFiles(vsPath, fsPath, null, target, options, ReadVertexFragmentResult);
+        }
 
-                    ResourceLayoutDescription[] layouts = new ResourceLayoutDescription[reflInfo->ResourceLayouts.Count];
-                    for (uint i = 0; i < reflInfo->ResourceLayouts.Count; i++)
-                    {
-                        ref NativeResourceLayoutDescription nativeDesc =
-                            ref reflInfo->ResourceLayouts.Ref<NativeResourceLayoutDescription>(i);
-                        layouts[i].Elements = new ResourceLayoutElementDescription[nativeDesc.ResourceElements.Count];
-                        for (uint j = 0; j < nativeDesc.ResourceElements.Count; j++)
-                        {
-                            ref NativeResourceElementDescription elemDesc =
-                                ref nativeDesc.ResourceElements.Ref<NativeResourceElementDescription>(j);
-                            layouts[i].Elements[j] = new ResourceLayoutElementDescription(
-                                Util.GetString((byte*)elemDesc.Name.Data, elemDesc.Name.Count),
-                                elemDesc.Kind,
-                                elemDesc.Stages,
-                                elemDesc.Options);
-                        }
-                    }
+        /// <summary>
+        /// Cross-compiles the compute shader stored in the given SPIR-V file into some target language. The file is
+        /// memory-mapped rather than read into managed memory.
+        /// </summary>
+        /// <param name="csPath">The path of the compute shader's SPIR-V file.</param>
+        /// <param name="target">The target language.</param>
+        /// <param name="options">The options for shader translation.</param>
+        /// <returns>A <see cref="ComputeCompilationResult"/> containing the compiled output.</returns>
+        public static unsafe ComputeCompilationResult CompileComputeFile(
+            string csPath,
+            CrossCompileTarget target,
+            CrossCompileOptions options)
+        {
+            if (csPath == null)
+            {
+                throw new ArgumentNullException(nameof(csPath));
+            }
 
-                    SpirvReflection reflection = new SpirvReflection(
-                        Array.Empty<VertexElementDescription>(),
-                        layouts);
+            return CrossCompileFiles(null, null, csPath, target, options, ReadComputeResult);
+        }
+
+        private static unsafe T CrossCompileFiles<T>(
+            string vsPath,
+            string fsPath,
+            string csPath,
+            CrossCompileTarget target,
+            CrossCompileOptions options,
+            CompileTask<T>.ResultReader readResult)
+        {
+            CrossCompileInfo info = default(CrossCompileInfo);
+            FillCrossCompileInfo(ref info, target, options);
+            using (InteropAllocator allocator = new InteropAllocator())
+            {
+                info.Specializations = GetSpecializations(allocator, options.Specializations);
 
-                    return new ComputeCompilationResult(csCode, reflection);
+                // Paths are passed as UTF-8 so that the native library can open any file name on every platform.
+                CompilationResult* result = null;
+                try
+                {
+                    result = VeldridSpirvNative.CrossCompileFiles(
+                        &info,
+                        allocator.GetNullTerminatedString(vsPath, Encoding.UTF8),
+                        allocator.GetNullTerminatedString(fsPath, Encoding.UTF8),
+                        allocator.GetNullTerminatedString(csPath, Encoding.UTF8));
+                    return readResult(result);
                 }
                 finally
                 {
@@ -265,88 +333,98 @@ namespace Veldrid.SPIRV
         }
 
         /// <summary>
-        /// Compiles the given GLSL source code into SPIR-V.
+        /// Cross-compiles the given vertex-fragment pair into some target language, and writes the text of each stage to the
+        /// given streams as soon as it has been generated instead of returning it. This avoids holding several copies of very
+        /// large generated shaders in memory.
         /// </summary>
-        /// <param name="sourceText">The shader source code.</param>
-        /// <param name="fileName">A descriptive name for the shader. May be null.</param>
-        /// <param name="stage">The <see cref="ShaderStages"/> which the shader is used in.</param>
-        /// <param name="options">Parameters for the GLSL compiler.</param>
-        /// <returns>A <see cref="SpirvCompilationResult"/> containing the compiled SPIR-V bytecode.</returns>
-        public static unsafe SpirvCompilationResult CompileGlslToSpirv(
-            string sourceText,
-            string fileName,
-            ShaderStages stage,
-            GlslCompileOptions options)
+        /// <param name="vsBytes">The vertex shader's SPIR-V bytecode.</param>
+        /// <param name="fsBytes">The fragment shader's SPIR-V bytecode.</param>
+        /// <param name="target">The target language.</param>
+        /// <param name="options">The options for shader translation.</param>
+        /// <param name="vertexOutput">The stream receiving the vertex shader's text.</param>
+        /// <param name="fragmentOutput">The stream receiving the fragment shader's text.</param>
+        /// <returns>The <see cref="SpirvReflection"/> of the shader pair.</returns>
+        public static unsafe SpirvReflection CompileVertexFragmentToStreams(
+            byte[] vsBytes,
+            byte[] fsBytes,
+            CrossCompileTarget target,
+            CrossCompileOptions options,
+            Stream vertexOutput,
+            Stream fragmentOutput)
         {
-            int sourceAsciiCount = Encoding.ASCII.GetByteCount(sourceText);
-            byte* sourceAsciiPtr = stackalloc byte[sourceAsciiCount];
-            fixed (char* sourceTextPtr = sourceText)
+            if (!Util.HasSpirvHeader(vsBytes) || !Util.HasSpirvHeader(fsBytes))
             {
-                Encoding.ASCII.GetBytes(sourceTextPtr, sourceText.Length, sourceAsciiPtr, sourceAsciiCount);
+                throw new ArgumentException(
+                    "Streaming compilation requires SPIR-V bytecode. GLSL source code can be compiled with CompileGlslToSpirv.");
             }
 
-            int macroCount = options.Macros.Length;
-            NativeMacroDefinition* macros = stackalloc NativeMacroDefinition[(int)macroCount];
-            for (int i = 0; i < macroCount; i++)
+            CrossCompileInfo info = default(CrossCompileInfo);
+            FillCrossCompileInfo(ref info, target, options);
+            using (InteropAllocator allocator = new InteropAllocator())
+            fixed (byte* vsBytesPtr = vsBytes)
+            fixed (byte* fsBytesPtr = fsBytes)
             {
-                macros[i] = new NativeMacroDefinition(options.Macros[i]);
+                info.VertexShader = new InteropArray((uint)vsBytes.Length / 4, vsBytesPtr);
+                info.FragmentShader = new InteropArray((uint)fsBytes.Length / 4, fsBytesPtr);
+                info.Specializations = GetSpecializations(allocator, options.Specializations);
+                return CrossCompileToStreams(&info, new[] { vertexOutput, fragmentOutput });
             }
-
-            return CompileGlslToSpirv(
-                (uint)sourceAsciiCount,
-                sourceAsciiPtr,
-                fileName,
-                stage,
-                options.Debug,
-                (uint)macroCount,
-                macros);
         }
 
-        internal static unsafe SpirvCompilationResult CompileGlslToSpirv(
-            uint sourceLength,
-            byte* sourceTextPtr,
-            string fileName,
-            ShaderStages stage,
-            bool debug,
-            uint macroCount,
-            NativeMacroDefinition* macros)
+        /// <summary>
+        /// Cross-compiles the given compute shader into some target language, and writes its text to the given stream as soon
+        /// as it has been generated instead of returning it.
+        /// </summary>
+        /// <param name="csBytes">The compute shader's SPIR-V bytecode.</param>
+        /// <param name="target">The target language.</param>
+        /// <param name="options">The options for shader translation.</param>
+        /// <param name="output">The stream receiving the compute shader's text.</param>
+        /// <returns>The <see cref="SpirvReflection"/> of the compute shader.</returns>
+        public static unsafe SpirvReflection CompileComputeToStream(
+            byte[] csBytes,
+            CrossCompileTarget target,
+            CrossCompileOptions options,
+            Stream output)
         {
-            GlslCompileInfo info;
-            info.Kind = GetShadercKind(stage);
-            info.SourceText = new InteropArray(sourceLength, sourceTextPtr);
-            info.Debug = debug;
-            info.Macros = new InteropArray(macroCount, macros);
+            if (!Util.HasSpirvHeader(csBytes))
+            {
+                throw new ArgumentException(
+                    "Streaming compilation requires SPIR-V bytecode. GLSL source code can be compiled with CompileGlslToSpirv.");
+            }
 
-            if (string.IsNullOrEmpty(fileName)) { fileName = "<veldrid-spirv-input>"; }
-            int fileNameAsciiCount = Encoding.ASCII.GetByteCount(fileName);
-            byte* fileNameAsciiPtr = stackalloc byte[fileNameAsciiCount];
-            if (fileNameAsciiCount > 0)
+            CrossCompileInfo info = default(CrossCompileInfo);
+            FillCrossCompileInfo(ref info, target, options);
+            using (InteropAllocator allocator = new InteropAllocator())
+            fixed (byte* csBytesPtr = csBytes)
             {
-                fixed (char* fileNameTextPtr = fileName)
-                {
-                    Encoding.ASCII.GetBytes(fileNameTextPtr, fileName.Length, fileNameAsciiPtr, fileNameAsciiCount);
-                }
+                info.ComputeShader = new InteropArray((uint)csBytes.Length / 4, csBytesPtr);
+                info.Specializations = GetSpecializations(allocator, options.Specializations);
+                return CrossCompileToStreams(&info, new[] { output });
             }
-            info.FileName = new InteropArray((uint)fileNameAsciiCount, fileNameAsciiPtr);
+        }
+
+        private static unsafe SpirvReflection CrossCompileToStreams(CrossCompileInfo* info, Stream[] outputs)
+        {
+            StreamOutputSink streamSink = new StreamOutputSink(outputs);
+            OutputWriteCallback callback = streamSink.Write;
+            NativeOutputSink sink;
+            sink.Callback = Marshal.GetFunctionPointerForDelegate(callback);
+            sink.UserData = IntPtr.Zero;
+            sink.FileDescriptor = -1;
 
             CompilationResult* result = null;
             try
             {
-                result = VeldridSpirvNative.CompileGlslToSpirv(&info);
+                result = VeldridSpirvNative.CrossCompileToSink(info, &sink);
+                GC.KeepAlive(callback);
+                streamSink.ThrowIfFailed();
                 if (!result->Succeeded)
                 {
                     throw new SpirvCompilationException(
                         "Compilation failed: " + Util.GetString((byte*)result->GetData(0), result->GetLength(0)));
                 }
 
-                uint length = result->GetLength(0);
-                byte[] spirvBytes = new byte[(int)length];
-                fixed (byte* spirvBytesPtr = &spirvBytes[0])
-                {
-                    Buffer.MemoryCopy(result->GetData(0), spirvBytesPtr, length, length);
-                }
-
-                return new SpirvCompilationResult(spirvBytes);
+                return GetReflection(&result->ReflectionInfo);
             }
             finally
             {
@@ -357,6 +435,945 @@ namespace Veldrid.SPIRV
             }
         }
 
+        /// <summary>
+        /// Starts cross-compiling the given vertex-fragment pair on the native worker threads, and returns without waiting
+        /// for it to finish. The inputs are copied before this returns.
+        /// </summary>
+        /// <param name="vsBytes">The vertex shader's SPIR-V bytecode.</param>
+        /// <param name="fsBytes">The fragment shader's SPIR-V bytecode.</param>
+        /// <param name="target">The target language.</param>
+        /// <param name="options">The options for shader translation.</param>
+        /// <returns>A <see cref="CompileTask{T}"/> which produces the compiled output.</returns>
+        public static unsafe CompileTask<VertexFragmentCompilationResult> BeginCompileVertexFragment(
+            byte[] vsBytes,
+            byte[] fsBytes,
+            CrossCompileTarget target,
+            CrossCompileOptions options)
+        {
+            if (!Util.HasSpirvHeader(vsBytes) || !Util.HasSpirvHeader(fsBytes))
+            {
+                throw new ArgumentException(
+                    "Asynchronous compilation requires SPIR-V bytecode. GLSL source code can be compiled with CompileGlslToSpirv.");
+            }
+
+            CrossCompileInfo info = default(CrossCompileInfo);
+            FillCrossCompileInfo(ref info, target, options);
+            using (InteropAllocator allocator = new InteropAllocator())
+            fixed (byte* vsBytesPtr = vsBytes)
+            fixed (byte* fsBytesPtr = fsBytes)
+            {
+                info.VertexShader = new InteropArray((uint)vsBytes.Length / 4, vsBytesPtr);
+                info.FragmentShader = new InteropArray((uint)fsBytes.Length / 4, fsBytesPtr);
+                info.Specializations = GetSpecializations(allocator, options.Specializations);
+                return new CompileTask<VertexFragmentCompilationResult>(
+                    VeldridSpirvNative.CrossCompileAsync(&info),
+                    ReadVertexFragmentResult);
+            }
+        }
+
+        /// <summary>
+        /// Starts cross-compiling the given compute shader on the native worker threads, and returns without waiting for it
+        /// to finish. The inputs are copied before this returns.
+        /// </summary>
+        /// <param name="csBytes">The compute shader's SPIR-V bytecode.</param>
+        /// <param name="target">The target language.</param>
+        /// <param name="options">The options for shader translation.</param>
+        /// <returns>A <see cref="CompileTask{T}"/> which produces the compiled output.</returns>
+        public static unsafe CompileTask<ComputeCompilationResult> BeginCompileCompute(
+            byte[] csBytes,
+            CrossCompileTarget target,
+            CrossCompileOptions options)
+        {
+            if (!Util.HasSpirvHeader(csBytes))
+            {
+                throw new ArgumentException(
+                    "Asynchronous compilation requires SPIR-V bytecode. GLSL source code can be compiled with CompileGlslToSpirv.");
+            }
+
+            CrossCompileInfo info = default(CrossCompileInfo);
+            FillCrossCompileInfo(ref info, target, options);
+            using (InteropAllocator allocator = new InteropAllocator())
+            fixed (byte* csBytesPtr = csBytes)
+            {
+                info.ComputeShader = new InteropArray((uint)csBytes.Length / 4, csBytesPtr);
+                info.Specializations = GetSpecializations(allocator, options.Specializations);
+                return new CompileTask<ComputeCompilationResult>(
+                    VeldridSpirvNative.CrossCompileAsync(&info),
+                    ReadComputeResult);
+            }
+        }
+
+        /// <summary>
+        /// Cross-compiles several vertex-fragment pairs at once, spread across the native worker threads. See
+        /// <see cref="SetWorkerThreadCount(uint)"/>.
+        /// </summary>
+        /// <param name="vsBytes">The SPIR-V bytecode of each pair's vertex shader.</param>
+        /// <param name="fsBytes">The SPIR-V bytecode of each pair's fragment shader.</param>
+        /// <param name="target">The target language.</param>
+        /// <param name="options">The options for shader translation, shared by all pairs.</param>
+        /// <returns>One <see cref="VertexFragmentCompilationResult"/> per pair, in the same order.</returns>
+        public static unsafe VertexFragmentCompilationResult[] CompileVertexFragmentBatch(
+            byte[][] vsBytes,
+            byte[][] fsBytes,
+            CrossCompileTarget target,
+            CrossCompileOptions options)
+        {
+            if (vsBytes.Length != fsBytes.Length)
+            {
+                throw new ArgumentException("Each vertex shader must be paired with exactly one fragment shader.");
+            }
+
+            return CrossCompileBatch(vsBytes, fsBytes, null, vsBytes.Length, target, options, ReadVertexFragmentResult);
+        }
+
+        /// <summary>
+        /// Cross-compiles several compute shaders at once, spread across the native worker threads. See
+        /// <see cref="SetWorkerThreadCount(uint)"/>.
+        /// </summary>
+        /// <param name="csBytes">The SPIR-V bytecode of each compute shader.</param>
+        /// <param name="target">The target language.</param>
+        /// <param name="options">The options for shader translation, shared by all shaders.</param>
+        /// <returns>One <see cref="ComputeCompilationResult"/> per shader, in the same order.</returns>
+        public static unsafe ComputeCompilationResult[] CompileComputeBatch(
+            byte[][] csBytes,
+            CrossCompileTarget target,
+            CrossCompileOptions options)
+        {
+            return CrossCompileBatch(null, null, csBytes, csBytes.Length, target, options, ReadComputeResult);
+        }
+
+        private static unsafe T[] CrossCompileBatch<T>(
+            byte[][] vsBytes,
+            byte[][] fsBytes,
+            byte[][] csBytes,
+            int count,
+            CrossCompileTarget target,
+            CrossCompileOptions options,
+            CompileTask<T>.ResultReader readResult)
+        {
+            GCHandle[] shaderHandles = new GCHandle[count * 3];
+            using (InteropAllocator allocator = new InteropAllocator())
+            {
+                CrossCompileInfo* infos = allocator.Allocate<CrossCompileInfo>(count);
+                CompilationResult** results = (CompilationResult**)allocator.Allocate<IntPtr>(count);
+                for (int i = 0; i < count; i++)
+                {
+                    results[i] = null;
+                }
+
+                try
+                {
+                    InteropArray specializations = GetSpecializations(allocator, options.Specializations);
+                    for (int i = 0; i < count; i++)
+                    {
+                        CrossCompileInfo info = default(CrossCompileInfo);
+                        FillCrossCompileInfo(ref info, target, options);
+                        info.VertexShader = PinBatchShader(vsBytes, i, shaderHandles, i * 3);
+                        info.FragmentShader = PinBatchShader(fsBytes, i, shaderHandles, i * 3 + 1);
+                        info.ComputeShader = PinBatchShader(csBytes, i, shaderHandles, i * 3 + 2);
+                        info.Specializations = specializations;
+                        infos[i] = info;
+                    }
+
+                    VeldridSpirvNative.CrossCompileBatch(infos, (uint)count, results);
+
+                    T[] outputs = new T[count];
+                    for (int i = 0; i < count; i++)
+                    {
+                        outputs[i] = readResult(results[i]);
+                    }
+
+                    return outputs;
+                }
+                finally
+                {
+                    for (int i = 0; i < count; i++)
+                    {
+                        if (results[i] != null)
+                        {
+                            VeldridSpirvNative.FreeResult(results[i]);
+                        }
+                    }
+
+                    foreach (GCHandle handle in shaderHandles)
+                    {
+                        if (handle.IsAllocated)
+                        {
+                            handle.Free();
+                        }
+                    }
+                }
+            }
+        }
+
+        private static unsafe InteropArray PinBatchShader(byte[][] shaders, int index, GCHandle[] handles, int handleIndex)
+        {
+            if (shaders == null)
+            {
+                return new InteropArray(0, null);
+            }
+
+            byte[] bytes = shaders[index];
+            if (!Util.HasSpirvHeader(bytes))
+            {
+                throw new ArgumentException(
+                    "Batched compilation requires SPIR-V bytecode. GLSL source code can be compiled with CompileGlslToSpirv.");
+            }
+
+            handles[handleIndex] = GCHandle.Alloc(bytes, GCHandleType.Pinned);
+            return new InteropArray((uint)bytes.Length / 4, (void*)handles[handleIndex].AddrOfPinnedObject());
+        }
+
+        /// <summary>
+        /// Cross-compiles the given compute shader once for each set of specialization constants. The shader is only parsed
+        /// once, which makes this much cheaper than a separate CompileCompute call per permutation when a kernel has many
+        /// specialization permutations.
+        /// </summary>
+        /// <param name="csBytes">The compute shader's SPIR-V bytecode or ASCII-encoded GLSL source code.</param>
+        /// <param name="target">The target language.</param>
+        /// <param name="options">The options for shader translation. Its <see cref="CrossCompileOptions.Specializations"/>
+        /// are ignored.</param>
+        /// <param name="specializationSets">The specialization constants of each output.</param>
+        /// <returns>One <see cref="ComputeCompilationResult"/> per specialization set, in the same order.</returns>
+        public static unsafe ComputeCompilationResult[] CompileComputeSpecializations(
+            byte[] csBytes,
+            CrossCompileTarget target,
+            CrossCompileOptions options,
+            SpecializationConstant[][] specializationSets)
+        {
+            byte[] csSpirvBytes;
+
+            if (Util.HasSpirvHeader(csBytes))
+            {
+                csSpirvBytes = csBytes;
+            }
+            else
+            {
+                fixed (byte* sourceTextPtr = csBytes)
+                {
+                    SpirvCompilationResult csCompileResult = CompileGlslToSpirv(
+                        (uint)csBytes.Length,
+                        sourceTextPtr,
+                        string.Empty,
+                        ShaderStages.Compute,
+                        target == CrossCompileTarget.GLSL || target == CrossCompileTarget.ESSL,
+                        0,
+                        null);
+                    csSpirvBytes = csCompileResult.SpirvBytes;
+                }
+            }
+
+            CrossCompileInfo info = default(CrossCompileInfo);
+            FillCrossCompileInfo(ref info, target, options);
+
+            int setCount = specializationSets.Length;
+            InteropAllocator allocator = new InteropAllocator();
+            CompilationResult* result = null;
+            try
+            {
+                InteropArray* nativeSets;
+                if (setCount <= MaxStackSpecializationSets)
+                {
+                    InteropArray* stackSets = stackalloc InteropArray[setCount];
+                    nativeSets = stackSets;
+                }
+                else
+                {
+                    nativeSets = allocator.Allocate<InteropArray>(setCount);
+                }
+
+                for (int i = 0; i < setCount; i++)
+                {
+                    nativeSets[i] = GetSpecializations(allocator, specializationSets[i]);
+                }
+
+                fixed (byte* csBytesPtr = csSpirvBytes)
+                {
+                    info.ComputeShader = new InteropArray((uint)csSpirvBytes.Length / 4, csBytesPtr);
+                    result = VeldridSpirvNative.CrossCompileSpecializations(&info, nativeSets, (uint)setCount);
+                }
+
+                if (!result->Succeeded)
+                {
+                    throw new SpirvCompilationException(
+                        "Compilation failed: " + Util.GetString((byte*)result->GetData(0), result->GetLength(0)));
+                }
+
+                SpirvReflection reflection = GetReflection(&result->ReflectionInfo);
+
+                ComputeCompilationResult[] results = new ComputeCompilationResult[setCount];
+                for (uint i = 0; i < setCount; i++)
+                {
+                    results[i] = new ComputeCompilationResult(
+                        Util.GetString((byte*)result->GetData(i), result->GetLength(i)),
+                        reflection);
+                }
+
+                return results;
+            }
+            finally
+            {
+                if (result != null)
+                {
+                    VeldridSpirvNative.FreeResult(result);
+                }
+
+                allocator.Dispose();
+            }
+        }
+
+        /// <summary>
+        /// Gets reflection information for the given vertex-fragment pair without translating it to any language.
+        /// </summary>
+        /// <param name="vsBytes">The vertex shader's SPIR-V bytecode.</param>
+        /// <param name="fsBytes">The fragment shader's SPIR-V bytecode.</param>
+        /// <param name="options">The options for shader translation. Only the specialization constants and
+        /// <see cref="CrossCompileOptions.NormalizeResourceNames"/> affect the reflection information.</param>
+        /// <returns>The <see cref="SpirvReflection"/> of the shader pair.</returns>
+        public static SpirvReflection ReflectVertexFragment(byte[] vsBytes, byte[] fsBytes, CrossCompileOptions options)
+            => Reflect(vsBytes, fsBytes, null, options);
+
+        /// <summary>
+        /// Gets reflection information for the given compute shader without translating it to any language.
+        /// </summary>
+        /// <param name="csBytes">The compute shader's SPIR-V bytecode.</param>
+        /// <param name="options">The options for shader translation. Only the specialization constants and
+        /// <see cref="CrossCompileOptions.NormalizeResourceNames"/> affect the reflection information.</param>
+        /// <returns>The <see cref="SpirvReflection"/> of the compute shader.</returns>
+        public static SpirvReflection ReflectCompute(byte[] csBytes, CrossCompileOptions options)
+            => Reflect(null, null, csBytes, options);
+
+        private static unsafe SpirvReflection Reflect(
+            byte[] vsBytes,
+            byte[] fsBytes,
+            byte[] csBytes,
+            CrossCompileOptions options)
+        {
+            vsBytes = vsBytes ?? Array.Empty<byte>();
+            fsBytes = fsBytes ?? Array.Empty<byte>();
+            csBytes = csBytes ?? Array.Empty<byte>();
+
+            CrossCompileInfo info = default(CrossCompileInfo);
+            FillCrossCompileInfo(ref info, default(CrossCompileTarget), options);
+            using (InteropAllocator allocator = new InteropAllocator())
+            fixed (byte* vsBytesPtr = vsBytes)
+            fixed (byte* fsBytesPtr = fsBytes)
+            fixed (byte* csBytesPtr = csBytes)
+            {
+                info.VertexShader = new InteropArray((uint)vsBytes.Length / 4, vsBytesPtr);
+                info.FragmentShader = new InteropArray((uint)fsBytes.Length / 4, fsBytesPtr);
+                info.ComputeShader = new InteropArray((uint)csBytes.Length / 4, csBytesPtr);
+                info.Specializations = GetSpecializations(allocator, options.Specializations);
+
+                CompilationResult* result = null;
+                try
+                {
+                    result = VeldridSpirvNative.Reflect(&info);
+                    if (!result->Succeeded)
+                    {
+                        throw new SpirvCompilationException(
+                            "Reflection failed: " + Util.GetString((byte*)result->GetData(0), result->GetLength(0)));
+                    }
+
+                    return GetReflection(&result->ReflectionInfo);
+                }
+                finally
+                {
+                    if (result != null)
+                    {
+                        VeldridSpirvNative.FreeResult(result);
+                    }
+                }
+            }
+        }
+
+        /// <summary>
+        /// Compiles the given GLSL source code into SPIR-V.
+        /// </summary>
+        /// <param name="sourceText">The shader source code.</param>
+        /// <param name="fileName">A descriptive name for the shader. May be null.</param>
+        /// <param name="stage">The <see cref="ShaderStages"/> which the shader is used in.</param>
+        /// <param name="options">Parameters for the GLSL compiler.</param>
+        /// <returns>A <see cref="SpirvCompilationResult"/> containing the compiled SPIR-V bytecode.</returns>
+        public static unsafe SpirvCompilationResult CompileGlslToSpirv(
+            string sourceText,
+            string fileName,
+            ShaderStages stage,
+            GlslCompileOptions options) => CompileGlslToSpirv(sourceText, fileName, stage, options, IntPtr.Zero);
+
+        internal static unsafe SpirvCompilationResult CompileGlslToSpirv(
+            string sourceText,
+            string fileName,
+            ShaderStages stage,
+            GlslCompileOptions options,
+            IntPtr session)
+        {
+            int sourceAsciiCount = Encoding.ASCII.GetByteCount(sourceText);
+            byte* sourceAsciiPtr = stackalloc byte[sourceAsciiCount];
+            fixed (char* sourceTextPtr = sourceText)
+            {
+                Encoding.ASCII.GetBytes(sourceTextPtr, sourceText.Length, sourceAsciiPtr, sourceAsciiCount);
+            }
+
+            int macroCount = options.Macros.Length;
+            NativeMacroDefinition* macros = stackalloc NativeMacroDefinition[(int)macroCount];
+            for (int i = 0; i < macroCount; i++)
+            {
+                macros[i] = new NativeMacroDefinition(options.Macros[i]);
+            }
+
+            string[] includeDirectories = options.IncludeDirectories ?? Array.Empty<string>();
+            int includeDirectoryCount = includeDirectories.Length;
+            InteropArray* nativeIncludeDirectories = stackalloc InteropArray[includeDirectoryCount];
+            GCHandle[] includeDirectoryHandles = new GCHandle[includeDirectoryCount];
+            try
+            {
+                for (int i = 0; i < includeDirectoryCount; i++)
+                {
+                    byte[] directoryBytes = Encoding.UTF8.GetBytes(includeDirectories[i]);
+                    includeDirectoryHandles[i] = GCHandle.Alloc(directoryBytes, GCHandleType.Pinned);
+                    nativeIncludeDirectories[i] = new InteropArray(
+                        (uint)directoryBytes.Length,
+                        (void*)includeDirectoryHandles[i].AddrOfPinnedObject());
+                }
+
+                return CompileGlslToSpirv(
+                    (uint)sourceAsciiCount,
+                    sourceAsciiPtr,
+                    fileName,
+                    stage,
+                    options.Debug,
+                    (uint)macroCount,
+                    macros,
+                    session,
+                    new InteropArray((uint)includeDirectoryCount, nativeIncludeDirectories));
+            }
+            finally
+            {
+                foreach (GCHandle handle in includeDirectoryHandles)
+                {
+                    if (handle.IsAllocated)
+                    {
+                        handle.Free();
+                    }
+                }
+            }
+        }
+
+        internal static unsafe SpirvCompilationResult CompileGlslToSpirv(
+            uint sourceLength,
+            byte* sourceTextPtr,
+            string fileName,
+            ShaderStages stage,
+            bool debug,
+            uint macroCount,
+            NativeMacroDefinition* macros,
+            IntPtr session = default(IntPtr),
+            InteropArray includeDirectories = default(InteropArray))
+        {
+            GlslCompileInfo info;
+            info.Kind = GetShadercKind(stage);
+            info.SourceText = new InteropArray(sourceLength, sourceTextPtr);
+            info.Debug = debug;
+            info.Macros = new InteropArray(macroCount, macros);
+            info.IncludeDirectories = includeDirectories;
+
+            if (string.IsNullOrEmpty(fileName)) { fileName = "<veldrid-spirv-input>"; }
+            int fileNameAsciiCount = Encoding.ASCII.GetByteCount(fileName);
+            byte* fileNameAsciiPtr = stackalloc byte[fileNameAsciiCount];
+            if (fileNameAsciiCount > 0)
+            {
+                fixed (char* fileNameTextPtr = fileName)
+                {
+                    Encoding.ASCII.GetBytes(fileNameTextPtr, fileName.Length, fileNameAsciiPtr, fileNameAsciiCount);
+                }
+            }
+            info.FileName = new InteropArray((uint)fileNameAsciiCount, fileNameAsciiPtr);
+
+            CompilationResult* result = null;
+            try
+            {
+                result = session == IntPtr.Zero
+                    ? VeldridSpirvNative.CompileGlslToSpirv(&info)
+                    : VeldridSpirvNative.CompileGlslToSpirvWithSession(session, &info);
+                // Both successful and failed results list the resolved include files after the first buffer.
+                string[] includedFiles = GetIncludedFiles(result, 1);
+                if (!result->Succeeded)
+                {
+                    throw new SpirvCompilationException(
+                        "Compilation failed: " + Util.GetString((byte*)result->GetData(0), result->GetLength(0)),
+                        includedFiles);
+                }
+
+                uint length = result->GetLength(0);
+                byte[] spirvBytes = new byte[(int)length];
+                fixed (byte* spirvBytesPtr = &spirvBytes[0])
+                {
+                    Buffer.MemoryCopy(result->GetData(0), spirvBytesPtr, length, length);
+                }
+
+                return new SpirvCompilationResult(spirvBytes, includedFiles, result->Fingerprint);
+            }
+            finally
+            {
+                if (result != null)
+                {
+                    VeldridSpirvNative.FreeResult(result);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Sets the number of native worker threads used by batched, parallel and asynchronous compilation.
+        /// </summary>
+        /// <param name="threadCount">The number of worker threads. Zero selects one thread per hardware thread.</param>
+        public static void SetWorkerThreadCount(uint threadCount)
+        {
+            VeldridSpirvNative.SetWorkerThreadCount(threadCount);
+        }
+
+        /// <summary>
+        /// Forwards single-shader compilations to a running veldrid-spirv-server listening on the given Unix domain socket.
+        /// Compilation falls back to the local compiler whenever the server cannot be reached. The initial value is read from
+        /// the VELDRID_SPIRV_COMPILE_SERVER environment variable. Forwarding is not available on Windows.
+        /// </summary>
+        /// <param name="socketPath">The path of the server's socket, or null to always compile locally.</param>
+        public static unsafe void SetCompileServer(string socketPath)
+        {
+            using (InteropAllocator allocator = new InteropAllocator())
+            {
+                VeldridSpirvNative.SetCompileServer(allocator.GetNullTerminatedString(socketPath, Encoding.UTF8));
+            }
+        }
+
+        /// <summary>
+        /// Sets the directory of the on-disk cache used when compiling GLSL to SPIR-V. When a directory is set, sources are
+        /// preprocessed first and the SPIR-V is looked up by a hash of the preprocessed code, the shader stage and the debug
+        /// flag, so edits which only touch comments, formatting or unused macros do not run the full compiler again. Several
+        /// processes may share the same directory.
+        /// </summary>
+        /// <param name="directory">An existing directory, or null to disable the cache.</param>
+        public static unsafe void SetGlslCompileCacheDirectory(string directory)
+        {
+            using (InteropAllocator allocator = new InteropAllocator())
+            {
+                VeldridSpirvNative.SetGlslCompileCacheDirectory(allocator.GetNullTerminatedString(directory, Encoding.UTF8));
+            }
+        }
+
+        /// <summary>
+        /// Controls whether files pulled in through #include directives are memory-mapped rather than read into memory.
+        /// Included files are cached by path, modification time and size in either case.
+        /// </summary>
+        /// <param name="enabled">Whether include files should be memory-mapped.</param>
+        public static void SetIncludeFileMapping(bool enabled)
+        {
+            VeldridSpirvNative.SetIncludeFileMapping(enabled);
+        }
+
+        /// <summary>
+        /// Drops all cached #include file contents.
+        /// </summary>
+        public static void ClearIncludeFileCache()
+        {
+            VeldridSpirvNative.ClearIncludeFileCache();
+        }
+
+        /// <summary>
+        /// Sets the maximum number of cross-compilation results retained by the native result cache. Identical
+        /// cross-compile requests (same SPIR-V, target, options and specialization constants) are served from the cache
+        /// without re-running the compiler. The cache is disabled by default; a capacity of zero disables it again.
+        /// </summary>
+        /// <param name="capacity">The maximum number of cached results.</param>
+        public static void SetCrossCompileCacheCapacity(uint capacity)
+        {
+            VeldridSpirvNative.SetCrossCompileCacheCapacity(capacity);
+        }
+
+        /// <summary>
+        /// Removes all entries from the native cross-compilation result cache and resets its counters.
+        /// </summary>
+        public static void ClearCrossCompileCache()
+        {
+            VeldridSpirvNative.ClearCrossCompileCache();
+        }
+
+        /// <summary>
+        /// Gets the current counters of the native cross-compilation result cache.
+        /// </summary>
+        /// <returns>A <see cref="CrossCompileCacheStatistics"/> snapshot.</returns>
+        public static unsafe CrossCompileCacheStatistics GetCrossCompileCacheStatistics()
+        {
+            NativeCacheStatistics stats;
+            VeldridSpirvNative.GetCrossCompileCacheStatistics(&stats);
+            return new CrossCompileCacheStatistics(stats);
+        }
+
+        /// <summary>
+        /// Turns the native per-phase compile timers on or off. They are off by default.
+        /// </summary>
+        /// <param name="enabled">Whether compile phases should be timed.</param>
+        public static void SetCompileInstrumentation(bool enabled)
+        {
+            VeldridSpirvNative.SetCompileInstrumentation(enabled);
+        }
+
+        /// <summary>
+        /// Gets the time and bytes spent in each compile phase since the counters were last reset. Only calls made while
+        /// instrumentation or tracing was enabled are counted.
+        /// </summary>
+        /// <returns>A <see cref="CompileStatistics"/> snapshot.</returns>
+        public static unsafe CompileStatistics GetCompileStatistics()
+        {
+            NativeCompileStatistics stats;
+            VeldridSpirvNative.GetCompileStatistics(&stats);
+            return new CompileStatistics(stats);
+        }
+
+        /// <summary>
+        /// Resets the counters reported by <see cref="GetCompileStatistics"/>.
+        /// </summary>
+        public static void ResetCompileStatistics()
+        {
+            VeldridSpirvNative.ResetCompileStatistics();
+        }
+
+        /// <summary>
+        /// Starts recording every compilation call and phase, on every thread, as a trace span. This also turns the
+        /// per-phase compile timers on.
+        /// </summary>
+        public static void BeginCompileTrace()
+        {
+            VeldridSpirvNative.BeginCompileTrace();
+        }
+
+        /// <summary>
+        /// Stops recording and writes the spans recorded since <see cref="BeginCompileTrace"/> to a file in the Chrome
+        /// trace event format, which can be opened in chrome://tracing or Perfetto.
+        /// </summary>
+        /// <param name="path">The path of the trace file to write.</param>
+        public static unsafe void EndCompileTrace(string path)
+        {
+            using (InteropAllocator allocator = new InteropAllocator())
+            {
+                if (!VeldridSpirvNative.EndCompileTrace(allocator.GetNullTerminatedString(path, Encoding.UTF8)))
+                {
+                    throw new SpirvCompilationException("Unable to write the compile trace to " + path + ".");
+                }
+            }
+        }
+
+        /// <summary>
+        /// Computes the fingerprint of a SPIR-V module. Modules which only differ in debug-only instructions, such as names,
+        /// source text and line information, have equal fingerprints.
+        /// </summary>
+        /// <param name="spirvBytes">The SPIR-V bytecode.</param>
+        /// <returns>The <see cref="SpirvFingerprint"/> of the module.</returns>
+        public static unsafe SpirvFingerprint GetSpirvFingerprint(byte[] spirvBytes)
+        {
+            if (spirvBytes.Length == 0 || spirvBytes.Length % 4 != 0)
+            {
+                throw new SpirvCompilationException("The given bytes are not a valid SPIR-V module.");
+            }
+
+            SpirvFingerprint fingerprint;
+            fixed (byte* spirvPtr = &spirvBytes[0])
+            {
+                if (!VeldridSpirvNative.GetSpirvFingerprint((uint*)spirvPtr, (uint)spirvBytes.Length / 4, &fingerprint))
+                {
+                    throw new SpirvCompilationException("The given bytes are not a valid SPIR-V module.");
+                }
+            }
+
+            return fingerprint;
+        }
+
+        /// <summary>
+        /// Compiles every permutation of the given variant matrix from GLSL to SPIR-V in parallel. Permutations which produce
+        /// identical SPIR-V share a single variant, which is translated to each target once.
+        /// </summary>
+        /// <param name="description">The shaders, macro axes and options to compile.</param>
+        /// <returns>A <see cref="VariantMatrixResult"/> mapping each permutation to its variant.</returns>
+        public static unsafe VariantMatrixResult CompileVariantMatrix(VariantMatrixDescription description)
+        {
+            using (InteropAllocator allocator = new InteropAllocator())
+            {
+                NativeVariantMatrixInfo info;
+
+                VariantMatrixStage[] stages = description.Stages;
+                NativeVariantStageSource* nativeStages = allocator.Allocate<NativeVariantStageSource>(stages.Length);
+                for (int i = 0; i < stages.Length; i++)
+                {
+                    nativeStages[i].Kind = GetShadercKind(stages[i].Stage);
+                    nativeStages[i].SourceText = allocator.GetString(stages[i].SourceText, Encoding.ASCII);
+                    nativeStages[i].FileName = allocator.GetString(
+                        string.IsNullOrEmpty(stages[i].FileName) ? "<veldrid-spirv-input>" : stages[i].FileName,
+                        Encoding.ASCII);
+                }
+                info.Stages = new InteropArray((uint)stages.Length, nativeStages);
+
+                GlslCompileOptions glslOptions = description.GlslOptions ?? GlslCompileOptions.Default;
+                info.Debug = glslOptions.Debug;
+                info.Macros = GetMacros(allocator, glslOptions.Macros);
+
+                ShaderMacroAxis[] axes = description.Axes ?? Array.Empty<ShaderMacroAxis>();
+                InteropArray* nativeAxes = allocator.Allocate<InteropArray>(axes.Length);
+                for (int i = 0; i < axes.Length; i++)
+                {
+                    nativeAxes[i] = GetMacros(allocator, axes[i].Values);
+                }
+                info.Axes = new InteropArray((uint)axes.Length, nativeAxes);
+
+                string[] includeDirectories = glslOptions.IncludeDirectories ?? Array.Empty<string>();
+                InteropArray* nativeIncludeDirectories = allocator.Allocate<InteropArray>(includeDirectories.Length);
+                for (int i = 0; i < includeDirectories.Length; i++)
+                {
+                    nativeIncludeDirectories[i] = allocator.GetString(includeDirectories[i], Encoding.UTF8);
+                }
+                info.IncludeDirectories = new InteropArray((uint)includeDirectories.Length, nativeIncludeDirectories);
+
+                CrossCompileOptions options = description.CrossCompileOptions ?? new CrossCompileOptions();
+                info.FixClipSpaceZ = options.FixClipSpaceZ;
+                info.InvertY = options.InvertVertexOutputY;
+                info.NormalizeResourceNames = options.NormalizeResourceNames;
+                info.Specializations = GetSpecializations(allocator, options.Specializations);
+
+                CrossCompileTarget[] targets = description.Targets ?? Array.Empty<CrossCompileTarget>();
+                NativeVariantMatrixResult* result = null;
+                try
+                {
+                    fixed (CrossCompileTarget* targetsPtr = targets)
+                    {
+                        info.Targets = new InteropArray((uint)targets.Length, targetsPtr);
+                        result = VeldridSpirvNative.CompileVariantMatrix(&info);
+                    }
+
+                    CompiledShaderVariant[] variants = new CompiledShaderVariant[result->Variants.Count];
+                    for (uint i = 0; i < variants.Length; i++)
+                    {
+                        CompilationResult* variant = ((CompilationResult**)result->Variants.Data)[i];
+                        variants[i] = GetCompiledVariant(variant, (uint)stages.Length, (uint)targets.Length);
+                    }
+
+                    if (result->PermutationVariants.Count == 0 && variants.Length == 1 && variants[0].ErrorMessage != null)
+                    {
+                        throw new SpirvCompilationException("Compilation failed: " + variants[0].ErrorMessage);
+                    }
+
+                    int[] permutationVariants = new int[result->PermutationVariants.Count];
+                    for (uint i = 0; i < permutationVariants.Length; i++)
+                    {
+                        permutationVariants[i] = (int)result->PermutationVariants.Ref<uint>(i);
+                    }
+
+                    return new VariantMatrixResult(permutationVariants, variants);
+                }
+                finally
+                {
+                    if (result != null)
+                    {
+                        VeldridSpirvNative.FreeVariantMatrixResult(result);
+                    }
+                }
+            }
+        }
+
+        private static unsafe InteropArray GetMacros(InteropAllocator allocator, MacroDefinition[] macros)
+        {
+            macros = macros ?? Array.Empty<MacroDefinition>();
+            NativeMacroDefinition* nativeMacros = allocator.Allocate<NativeMacroDefinition>(macros.Length);
+            for (int i = 0; i < macros.Length; i++)
+            {
+                nativeMacros[i] = macros[i] != null ? new NativeMacroDefinition(macros[i]) : default(NativeMacroDefinition);
+            }
+
+            return new InteropArray((uint)macros.Length, nativeMacros);
+        }
+
+        internal static unsafe InteropArray GetSpecializations(
+            InteropAllocator allocator,
+            SpecializationConstant[] specializations)
+        {
+            // SpecializationConstant carries its type and is padded, so it must be copied into the packed native layout.
+            specializations = specializations ?? Array.Empty<SpecializationConstant>();
+            NativeSpecializationConstant* nativeSpecConstants =
+                allocator.Allocate<NativeSpecializationConstant>(specializations.Length);
+            for (int i = 0; i < specializations.Length; i++)
+            {
+                nativeSpecConstants[i].ID = specializations[i].ID;
+                nativeSpecConstants[i].Constant = specializations[i].Data;
+            }
+
+            return new InteropArray((uint)specializations.Length, nativeSpecConstants);
+        }
+
+        internal static void FillCrossCompileInfo(ref CrossCompileInfo info, CrossCompileTarget target, CrossCompileOptions options)
+        {
+            info.Target = target;
+            info.FixClipSpaceZ = options.FixClipSpaceZ;
+            info.InvertY = options.InvertVertexOutputY;
+            info.NormalizeResourceNames = options.NormalizeResourceNames;
+            info.SparseResourceLayouts = options.SparseResourceLayouts;
+            info.Optimization = options.Optimization;
+            info.MinifyOutput = options.MinifyOutput;
+            info.PruneStageInterface = options.PruneStageInterface;
+        }
+
+        private static unsafe CompiledShaderVariant GetCompiledVariant(
+            CompilationResult* result,
+            uint stageCount,
+            uint targetCount)
+        {
+            if (!result->Succeeded)
+            {
+                return new CompiledShaderVariant(
+                    null,
+                    null,
+                    null,
+                    GetIncludedFiles(result, 1),
+                    Util.GetString((byte*)result->GetData(0), result->GetLength(0)));
+            }
+
+            byte[][] spirvBytes = new byte[stageCount][];
+            for (uint stage = 0; stage < stageCount; stage++)
+            {
+                uint length = result->GetLength(stage);
+                spirvBytes[stage] = new byte[length];
+                fixed (byte* spirvBytesPtr = spirvBytes[stage])
+                {
+                    Buffer.MemoryCopy(result->GetData(stage), spirvBytesPtr, length, length);
+                }
+            }
+
+            string[][] targetOutputs = new string[targetCount][];
+            for (uint target = 0; target < targetCount; target++)
+            {
+                targetOutputs[target] = new string[stageCount];
+                for (uint stage = 0; stage < stageCount; stage++)
+                {
+                    uint index = stageCount * (1 + target) + stage;
+                    targetOutputs[target][stage] = Util.GetString((byte*)result->GetData(index), result->GetLength(index));
+                }
+            }
+
+            string[] includedFiles = GetIncludedFiles(result, stageCount * (1 + targetCount));
+
+            SpirvReflection reflection = targetCount == 0 ? null : GetReflection(&result->ReflectionInfo);
+
+            return new CompiledShaderVariant(spirvBytes, targetOutputs, reflection, includedFiles, null);
+        }
+
+        private static unsafe string[] GetIncludedFiles(CompilationResult* result, uint includeIndex)
+        {
+            string[] includedFiles = new string[result->DataBuffers.Count - includeIndex];
+            for (uint i = 0; i < includedFiles.Length; i++)
+            {
+                includedFiles[i] = Util.GetString((byte*)result->GetData(includeIndex + i), result->GetLength(includeIndex + i));
+            }
+
+            return includedFiles;
+        }
+
+        private static unsafe VertexFragmentCompilationResult ReadVertexFragmentResult(CompilationResult* result)
+        {
+            if (!result->Succeeded)
+            {
+                throw new SpirvCompilationException(
+                    "Compilation failed: " + Util.GetString((byte*)result->GetData(0), result->GetLength(0)));
+            }
+
+            string vsCode = Util.GetString((byte*)result->GetData(0), result->GetLength(0));
+            string fsCode = Util.GetString((byte*)result->GetData(1), result->GetLength(1));
+
+            SpirvReflection reflection = GetReflection(&result->ReflectionInfo);
+
+            return new VertexFragmentCompilationResult(vsCode, fsCode, reflection);
+        }
+
+        private static unsafe ComputeCompilationResult ReadComputeResult(CompilationResult* result)
+        {
+            if (!result->Succeeded)
+            {
+                throw new SpirvCompilationException(
+                    "Compilation failed: " + Util.GetString((byte*)result->GetData(0), result->GetLength(0)));
+            }
+
+            string csCode = Util.GetString((byte*)result->GetData(0), result->GetLength(0));
+
+            SpirvReflection reflection = GetReflection(&result->ReflectionInfo);
+
+            return new ComputeCompilationResult(csCode, reflection);
+        }
+
+        private static unsafe SpirvReflection GetReflection(ReflectionInfo* reflInfo)
+        {
+            return new SpirvReflection(
+                GetVertexElements(reflInfo),
+                GetResourceLayouts(reflInfo),
+                GetSparseResourceBindings(reflInfo));
+        }
+
+        private static unsafe VertexElementDescription[] GetVertexElements(ReflectionInfo* reflInfo)
+        {
+            VertexElementDescription[] vertexElements = new VertexElementDescription[reflInfo->VertexElements.Count];
+            for (uint i = 0; i < reflInfo->VertexElements.Count; i++)
+            {
+                ref NativeVertexElementDescription nativeDesc
+                    = ref reflInfo->VertexElements.Ref<NativeVertexElementDescription>(i);
+                vertexElements[i] = new VertexElementDescription(
+                    Util.GetString((byte*)nativeDesc.Name.Data, nativeDesc.Name.Count),
+                    nativeDesc.Semantic,
+                    nativeDesc.Format,
+                    nativeDesc.Offset);
+            }
+
+            return vertexElements;
+        }
+
+        private static unsafe ResourceLayoutDescription[] GetResourceLayouts(ReflectionInfo* reflInfo)
+        {
+            ResourceLayoutDescription[] layouts = new ResourceLayoutDescription[reflInfo->ResourceLayouts.Count];
+            for (uint i = 0; i < reflInfo->ResourceLayouts.Count; i++)
+            {
+                ref NativeResourceLayoutDescription nativeDesc =
+                    ref reflInfo->ResourceLayouts.Ref<NativeResourceLayoutDescription>(i);
+                layouts[i].Elements = new ResourceLayoutElementDescription[nativeDesc.ResourceElements.Count];
+                for (uint j = 0; j < nativeDesc.ResourceElements.Count; j++)
+                {
+                    ref NativeResourceElementDescription elemDesc =
+                        ref nativeDesc.ResourceElements.Ref<NativeResourceElementDescription>(j);
+                    layouts[i].Elements[j] = new ResourceLayoutElementDescription(
+                        Util.GetString((byte*)elemDesc.Name.Data, elemDesc.Name.Count),
+                        elemDesc.Kind,
+                        elemDesc.Stages,
+                        elemDesc.Options);
+                }
+            }
+
+            return layouts;
+        }
+
+        private static unsafe SparseResourceBinding[] GetSparseResourceBindings(ReflectionInfo* reflInfo)
+        {
+            SparseResourceBinding[] bindings = new SparseResourceBinding[reflInfo->SparseBindings.Count];
+            for (uint i = 0; i < reflInfo->SparseBindings.Count; i++)
+            {
+                ref NativeSparseResourceBinding nativeBinding =
+                    ref reflInfo->SparseBindings.Ref<NativeSparseResourceBinding>(i);
+                ref NativeResourceElementDescription elemDesc = ref nativeBinding.Element;
+                bindings[i] = new SparseResourceBinding(
+                    nativeBinding.Set,
+                    nativeBinding.Binding,
+                    new ResourceLayoutElementDescription(
+                        Util.GetString((byte*)elemDesc.Name.Data, elemDesc.Name.Count),
+                        elemDesc.Kind,
+                        elemDesc.Stages,
+                        elemDesc.Options));
+            }
+
+            return bindings;
+        }
+
         private static ShadercShaderKind GetShadercKind(ShaderStages stage)
         {
             switch (stage)
@@ -7,6 +7,12 @@ namespace Veldrid.SPIRV
     /// </summary>
     public class SpirvCompilationException : Exception
     {
+        /// <summary>
+        /// The paths of the files pulled in through #include directives before the error occurred. Empty if the error
+        /// did not come from a GLSL compilation.
+        /// </summary>
+        public string[] IncludedFiles { get; } = Array.Empty<string>();
+
         /// <summary>
         /// Constructs a new <see cref="SpirvCompilationException"/>.
         /// </summary>
@@ -30,5 +36,16 @@ namespace Veldrid.SPIRV
         public SpirvCompilationException(string message, Exception innerException) : base(message, innerException)
         {
         }
+
+        /// <summary>
+        /// Constructs a new <see cref="SpirvCompilationException"/> with the given message and the files which were
+        /// included before the error.
+        /// </summary>
+        /// <param name="message">The error message.</param>
+        /// <param name="includedFiles">The paths of the files pulled in through #include directives.</param>
+        public SpirvCompilationException(string message, string[] includedFiles) : base(message)
+        {
+            IncludedFiles = includedFiles ?? Array.Empty<string>();
+        }
     }
 }
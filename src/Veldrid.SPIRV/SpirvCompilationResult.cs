@@ -1,4 +1,6 @@
-﻿namespace Veldrid.SPIRV
+﻿using System;
+
+namespace Veldrid.SPIRV
 {
     /// <summary>
     /// The output of a source to SPIR-V compilation operation.
@@ -9,14 +11,44 @@
         /// The compiled SPIR-V bytecode.
         /// </summary>
         public byte[] SpirvBytes { get; }
+        /// <summary>
+        /// The paths of all files pulled in through #include directives, in the order they were first included.
+        /// </summary>
+        public string[] IncludedFiles { get; }
+        /// <summary>
+        /// The fingerprint of <see cref="SpirvBytes"/>, which ignores debug-only instructions.
+        /// </summary>
+        public SpirvFingerprint Fingerprint { get; }
+
+        /// <summary>
+        /// Constructs a new <see cref="SpirvCompilationResult"/>.
+        /// </summary>
+        /// <param name="spirvBytes">The compiled SPIR-V bytecode.</param>
+        public SpirvCompilationResult(byte[] spirvBytes) : this(spirvBytes, Array.Empty<string>())
+        {
+        }
+
+        /// <summary>
+        /// Constructs a new <see cref="SpirvCompilationResult"/>.
+        /// </summary>
+        /// <param name="spirvBytes">The compiled SPIR-V bytecode.</param>
+        /// <param name="includedFiles">The paths of all files pulled in through #include directives.</param>
+        public SpirvCompilationResult(byte[] spirvBytes, string[] includedFiles)
+            : this(spirvBytes, includedFiles, default)
+        {
+        }
 
         /// <summary>
         /// Constructs a new <see cref="SpirvCompilationResult"/>.
         /// </summary>
         /// <param name="spirvBytes">The compiled SPIR-V bytecode.</param>
-        public SpirvCompilationResult(byte[] spirvBytes)
+        /// <param name="includedFiles">The paths of all files pulled in through #include directives.</param>
+        /// <param name="fingerprint">The fingerprint of the compiled SPIR-V bytecode.</param>
+        public SpirvCompilationResult(byte[] spirvBytes, string[] includedFiles, SpirvFingerprint fingerprint)
         {
             SpirvBytes = spirvBytes;
+            IncludedFiles = includedFiles;
+            Fingerprint = fingerprint;
         }
     }
 }
@@ -0,0 +1,71 @@
+using System;
+using System.Runtime.InteropServices;
+
+namespace Veldrid.SPIRV
+{
+    /// <summary>
+    /// A 128-bit hash of the semantic content of a SPIR-V module. Debug-only instructions, such as names, source text and
+    /// line information, do not contribute, so modules that differ only in debug instructions and share their ID
+    /// assignment have equal fingerprints. Debug and release builds of a shader generally differ in more than that, since
+    /// they are optimized differently.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential, Pack = 1)]
+    public struct SpirvFingerprint : IEquatable<SpirvFingerprint>
+    {
+        /// <summary>
+        /// The low 64 bits of the fingerprint.
+        /// </summary>
+        public readonly ulong Low;
+        /// <summary>
+        /// The high 64 bits of the fingerprint.
+        /// </summary>
+        public readonly ulong High;
+
+        /// <summary>
+        /// Constructs a new <see cref="SpirvFingerprint"/>.
+        /// </summary>
+        /// <param name="low">The low 64 bits of the fingerprint.</param>
+        /// <param name="high">The high 64 bits of the fingerprint.</param>
+        public SpirvFingerprint(ulong low, ulong high)
+        {
+            Low = low;
+            High = high;
+        }
+
+        /// <summary>
+        /// Element-wise equality.
+        /// </summary>
+        /// <param name="other">The instance to compare to.</param>
+        /// <returns>True if all elements are equal; false otherwise.</returns>
+        public bool Equals(SpirvFingerprint other) => Low == other.Low && High == other.High;
+
+        /// <summary>
+        /// Element-wise equality.
+        /// </summary>
+        /// <param name="obj">The instance to compare to.</param>
+        /// <returns>True if obj is a <see cref="SpirvFingerprint"/> with equal elements; false otherwise.</returns>
+        public override bool Equals(object obj) => obj is SpirvFingerprint other && Equals(other);
+
+        /// <summary>
+        /// Returns the hash code for this instance.
+        /// </summary>
+        /// <returns>A 32-bit signed integer that is the hash code for this instance.</returns>
+        public override int GetHashCode() => Low.GetHashCode();
+
+        /// <summary>
+        /// Returns the fingerprint as 32 hexadecimal digits, high bits first.
+        /// </summary>
+        /// <returns>A string representation of this fingerprint.</returns>
+        public override string ToString() => High.ToString("x16") + Low.ToString("x16");
+
+        /// <summary>
+        /// Element-wise equality.
+        /// </summary>
+        public static bool operator ==(SpirvFingerprint left, SpirvFingerprint right) => left.Equals(right);
+
+        /// <summary>
+        /// Element-wise inequality.
+        /// </summary>
+        public static bool operator !=(SpirvFingerprint left, SpirvFingerprint right) => !left.Equals(right);
+    }
+}
@@ -0,0 +1,27 @@
+namespace Veldrid.SPIRV
+{
+    /// <summary>
+    /// Identifies the SPIR-V optimizer passes that are run over the input modules before they are translated.
+    /// </summary>
+    public enum SpirvOptimization : uint
+    {
+        /// <summary>
+        /// The input modules are translated as given.
+        /// </summary>
+        None,
+        /// <summary>
+        /// The SPIRV-Tools performance recipe. Inlines functions and removes redundant loads, stores and dead code.
+        /// </summary>
+        Performance,
+        /// <summary>
+        /// The SPIRV-Tools size recipe.
+        /// </summary>
+        Size,
+        /// <summary>
+        /// The values in <see cref="CrossCompileOptions.Specializations"/> are baked into the modules as regular constants,
+        /// which are then folded, and the branches and functions they make unreachable are removed. The translated shader
+        /// no longer contains the specialization constants.
+        /// </summary>
+        FreezeSpecializations,
+    }
+}
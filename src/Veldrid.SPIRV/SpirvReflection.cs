@@ -25,6 +25,13 @@ namespace Veldrid.SPIRV
         /// </summary>
         public ResourceLayoutDescription[] ResourceLayouts { get; }
 
+        /// <summary>
+        /// An array containing each resource used by the compiled shader set with its set and binding numbers, sorted by set
+        /// and then binding. This array is only filled in when <see cref="CrossCompileOptions.SparseResourceLayouts"/> is
+        /// set, in which case <see cref="ResourceLayouts"/> is empty.
+        /// </summary>
+        public SparseResourceBinding[] SparseResourceBindings { get; }
+
         /// <summary>
         /// Constructs a new <see cref="SpirvReflection"/> instance.
         /// </summary>
@@ -35,9 +42,28 @@ namespace Veldrid.SPIRV
         public SpirvReflection(
             VertexElementDescription[] vertexElements,
             ResourceLayoutDescription[] resourceLayouts)
+            : this(vertexElements, resourceLayouts, Array.Empty<SparseResourceBinding>())
+        {
+        }
+
+        /// <summary>
+        /// Constructs a new <see cref="SpirvReflection"/> instance.
+        /// </summary>
+        /// <param name="vertexElements">/// An array containing a description of each vertex element that is used by
+        /// the compiled shader set.</param>
+        /// <param name="resourceLayouts">An array containing a description of each set of resources used by the
+        /// compiled shader set.</param>
+        /// <param name="sparseResourceBindings">An array containing each resource used by the compiled shader set with
+        /// its set and binding numbers.</param>
+        [JsonConstructor]
+        public SpirvReflection(
+            VertexElementDescription[] vertexElements,
+            ResourceLayoutDescription[] resourceLayouts,
+            SparseResourceBinding[] sparseResourceBindings)
         {
             VertexElements = vertexElements;
             ResourceLayouts = resourceLayouts;
+            SparseResourceBindings = sparseResourceBindings ?? Array.Empty<SparseResourceBinding>();
         }
 
         /// <summary>
@@ -0,0 +1,48 @@
+using System;
+using System.IO;
+
+namespace Veldrid.SPIRV
+{
+    /// <summary>
+    /// Forwards the generated text of each output buffer to one stream per buffer. Exceptions thrown by the streams are
+    /// kept until the native call has returned, since they cannot be thrown through native frames.
+    /// </summary>
+    internal unsafe sealed class StreamOutputSink
+    {
+        private readonly Stream[] _outputs;
+        private Exception _error;
+
+        public StreamOutputSink(Stream[] outputs)
+        {
+            _outputs = outputs;
+        }
+
+        public void Write(IntPtr userData, uint bufferIndex, byte* data, uint size)
+        {
+            if (_error != null)
+            {
+                return;
+            }
+
+            try
+            {
+                using (UnmanagedMemoryStream text = new UnmanagedMemoryStream(data, size))
+                {
+                    text.CopyTo(_outputs[bufferIndex]);
+                }
+            }
+            catch (Exception e)
+            {
+                _error = e;
+            }
+        }
+
+        public void ThrowIfFailed()
+        {
+            if (_error != null)
+            {
+                throw new IOException("Unable to write the generated shader text.", _error);
+            }
+        }
+    }
+}
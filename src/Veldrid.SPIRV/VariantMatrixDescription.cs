@@ -0,0 +1,147 @@
+using System;
+
+namespace Veldrid.SPIRV
+{
+    /// <summary>
+    /// A GLSL shader stage compiled as part of a <see cref="VariantMatrixDescription"/>.
+    /// </summary>
+    public class VariantMatrixStage
+    {
+        /// <summary>
+        /// The stage of the shader.
+        /// </summary>
+        public ShaderStages Stage { get; set; }
+        /// <summary>
+        /// The GLSL source code of the shader.
+        /// </summary>
+        public string SourceText { get; set; }
+        /// <summary>
+        /// A descriptive name for the shader, also used to resolve quoted #include directives. May be null.
+        /// </summary>
+        public string FileName { get; set; }
+
+        /// <summary>
+        /// Constructs a new <see cref="VariantMatrixStage"/>.
+        /// </summary>
+        /// <param name="stage">The stage of the shader.</param>
+        /// <param name="sourceText">The GLSL source code of the shader.</param>
+        /// <param name="fileName">A descriptive name for the shader. May be null.</param>
+        public VariantMatrixStage(ShaderStages stage, string sourceText, string fileName)
+        {
+            Stage = stage;
+            SourceText = sourceText;
+            FileName = fileName;
+        }
+    }
+
+    /// <summary>
+    /// One dimension of a variant matrix: a set of alternative values for a preprocessor macro.
+    /// </summary>
+    public class ShaderMacroAxis
+    {
+        /// <summary>
+        /// The alternatives of this axis. A null entry leaves the macro undefined in that alternative.
+        /// </summary>
+        public MacroDefinition[] Values { get; set; }
+
+        /// <summary>
+        /// Constructs a new <see cref="ShaderMacroAxis"/>.
+        /// </summary>
+        /// <param name="values">The alternatives of this axis. A null entry leaves the macro undefined.</param>
+        public ShaderMacroAxis(params MacroDefinition[] values)
+        {
+            Values = values;
+        }
+    }
+
+    /// <summary>
+    /// Describes a vertex-fragment pair or compute shader which is compiled under every combination of the values of its
+    /// macro axes.
+    /// </summary>
+    public class VariantMatrixDescription
+    {
+        /// <summary>
+        /// Either a vertex and a fragment stage, or a single compute stage.
+        /// </summary>
+        public VariantMatrixStage[] Stages { get; set; }
+        /// <summary>
+        /// Options applied to every GLSL compilation. Its macros are defined in every permutation.
+        /// </summary>
+        public GlslCompileOptions GlslOptions { get; set; } = new GlslCompileOptions();
+        /// <summary>
+        /// The macro axes which are expanded into permutations. Permutations are numbered with the last axis varying
+        /// fastest.
+        /// </summary>
+        public ShaderMacroAxis[] Axes { get; set; } = Array.Empty<ShaderMacroAxis>();
+        /// <summary>
+        /// The options for shader translation.
+        /// </summary>
+        public CrossCompileOptions CrossCompileOptions { get; set; } = new CrossCompileOptions();
+        /// <summary>
+        /// The languages which every distinct variant is translated to.
+        /// </summary>
+        public CrossCompileTarget[] Targets { get; set; } = Array.Empty<CrossCompileTarget>();
+    }
+
+    /// <summary>
+    /// A distinct output of a variant matrix compilation, shared by all permutations which produced identical SPIR-V.
+    /// </summary>
+    public class CompiledShaderVariant
+    {
+        /// <summary>
+        /// The SPIR-V bytecode of each stage, in the order of <see cref="VariantMatrixDescription.Stages"/>.
+        /// </summary>
+        public byte[][] SpirvBytes { get; }
+        /// <summary>
+        /// The translated source code, indexed by target and then by stage.
+        /// </summary>
+        public string[][] TargetOutputs { get; }
+        /// <summary>
+        /// Information about the resources used by the variant. Null if no targets were requested.
+        /// </summary>
+        public SpirvReflection Reflection { get; }
+        /// <summary>
+        /// The paths of all files pulled in through #include directives by any permutation of this variant.
+        /// </summary>
+        public string[] IncludedFiles { get; }
+        /// <summary>
+        /// The compilation errors of this variant, or null if it was compiled successfully.
+        /// </summary>
+        public string ErrorMessage { get; }
+
+        internal CompiledShaderVariant(
+            byte[][] spirvBytes,
+            string[][] targetOutputs,
+            SpirvReflection reflection,
+            string[] includedFiles,
+            string errorMessage)
+        {
+            SpirvBytes = spirvBytes;
+            TargetOutputs = targetOutputs;
+            Reflection = reflection;
+            IncludedFiles = includedFiles;
+            ErrorMessage = errorMessage;
+        }
+    }
+
+    /// <summary>
+    /// The output of a variant matrix compilation.
+    /// </summary>
+    public class VariantMatrixResult
+    {
+        /// <summary>
+        /// For each permutation, the index of its entry in <see cref="Variants"/>.
+        /// </summary>
+        public int[] PermutationVariants { get; }
+        /// <summary>
+        /// The distinct variants.
+        /// </summary>
+        public CompiledShaderVariant[] Variants { get; }
+
+        internal VariantMatrixResult(int[] permutationVariants, CompiledShaderVariant[] variants)
+        {
+            PermutationVariants = permutationVariants;
+            Variants = variants;
+        }
+    }
+}
@@ -1,4 +1,5 @@
-﻿using System.Runtime.InteropServices;
+﻿using System;
+using System.Runtime.InteropServices;
 
 namespace Veldrid.SPIRV
 {
@@ -9,10 +10,154 @@ namespace Veldrid.SPIRV
         [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
         public static extern CompilationResult* CrossCompile(CrossCompileInfo* info);
 
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern CompilationResult* CrossCompileFiles(
+            CrossCompileInfo* info,
+            byte* vertexShaderPath,
+            byte* fragmentShaderPath,
+            byte* computeShaderPath);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern CompilationResult* CrossCompileMultiTarget(
+            CrossCompileInfo* info,
+            CrossCompileTarget* targets,
+            uint targetCount);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern CompilationResult* CrossCompileSpecializations(
+            CrossCompileInfo* info,
+            InteropArray* specializationSets,
+            uint setCount);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern NativeVariantMatrixResult* CompileVariantMatrix(NativeVariantMatrixInfo* info);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void FreeVariantMatrixResult(NativeVariantMatrixResult* result);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern CompilationResult* Reflect(CrossCompileInfo* info);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern CompilationResult* CrossCompileToSink(CrossCompileInfo* info, NativeOutputSink* sink);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void CrossCompileBatch(CrossCompileInfo* infos, uint count, CompilationResult** results);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void SetWorkerThreadCount(uint threadCount);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void SetCompileServer(byte* socketPath);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern IntPtr CrossCompileAsync(CrossCompileInfo* info);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern CompileTaskStatus GetCompileTaskStatus(IntPtr task);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern Bool32 WaitCompileTask(IntPtr task, uint timeoutMilliseconds);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void CancelCompileTask(IntPtr task);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern CompilationResult* TakeCompileTaskResult(IntPtr task);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void DestroyCompileTask(IntPtr task);
+
         [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
         public static extern CompilationResult* CompileGlslToSpirv(GlslCompileInfo* info);
 
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void SetGlslCompileCacheDirectory(byte* directory);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void SetIncludeFileMapping(Bool32 enabled);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void ClearIncludeFileCache();
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern IntPtr CreateGlslCompilerSession(GlslSessionInfo* info);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern CompilationResult* CompileGlslToSpirvWithSession(IntPtr session, GlslCompileInfo* info);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void DestroyGlslCompilerSession(IntPtr session);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern IntPtr CreateShaderBundleWriter(Bool32 compress);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern CompilationResult* AddShaderBundleVariant(
+            IntPtr writer,
+            byte* key,
+            uint keyLength,
+            CrossCompileInfo* info,
+            CrossCompileTarget* targets,
+            uint targetCount);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern CompilationResult* WriteShaderBundle(IntPtr writer, byte* path);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void DestroyShaderBundleWriter(IntPtr writer);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern IntPtr OpenShaderBundle(byte* path);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern uint GetShaderBundleVariantCount(IntPtr bundle);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern Bool32 FindShaderBundleVariant(
+            IntPtr bundle,
+            byte* key,
+            uint keyLength,
+            NativeShaderBundleVariant* variant);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern Bool32 ReadShaderBundleBlob(
+            IntPtr bundle,
+            NativeShaderBundleBlob* blob,
+            byte* destination,
+            ulong size);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void CloseShaderBundle(IntPtr bundle);
+
         [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
         public static extern void FreeResult(CompilationResult* result);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void SetCrossCompileCacheCapacity(uint capacity);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void ClearCrossCompileCache();
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void GetCrossCompileCacheStatistics(NativeCacheStatistics* stats);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern Bool32 GetSpirvFingerprint(uint* words, uint wordCount, SpirvFingerprint* fingerprint);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void SetCompileInstrumentation(Bool32 enabled);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void GetCompileStatistics(NativeCompileStatistics* stats);
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void ResetCompileStatistics();
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void BeginCompileTrace();
+
+        [DllImport(LibName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern Bool32 EndCompileTrace(byte* path);
     }
 }
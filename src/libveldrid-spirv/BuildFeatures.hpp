@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+// The full library is built without any of the following macros. The runtime libraries in CMakeLists.txt
+// define some of them to leave out the dependencies they do not link:
+//   VD_NO_GLSL_FRONTEND  GLSL compilation through shaderc, including sessions and variant matrices.
+//   VD_NO_OPTIMIZER      The SPIRV-Tools optimizer, used by SpirvOptimization and PruneStageInterface.
+//   VD_NO_HLSL           The HLSL backend of SPIRV-Cross.
+//   VD_NO_MSL            The MSL backend of SPIRV-Cross.
+// Exports which depend on a missing component are still present, so every library has the same C ABI,
+// but they fail at run time.
+
+namespace Veldrid
+{
+[[noreturn]] inline void ThrowFeatureUnavailable(const char *feature)
+{
+    throw std::runtime_error(std::string(feature) + " is not available in this build of libveldrid-spirv.");
+}
+} // namespace Veldrid
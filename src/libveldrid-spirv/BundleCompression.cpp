@@ -0,0 +1,168 @@
+#include "BundleCompression.hpp"
+#include <string.h>
+
+namespace Veldrid
+{
+static const size_t MinMatch = 4;
+static const size_t MaxOffset = 0xFFFF;
+static const uint32_t HashBits = 14;
+static const uint32_t NoPosition = 0xFFFFFFFF;
+
+static uint32_t HashSequence(const uint8_t *data)
+{
+    uint32_t sequence;
+    memcpy(&sequence, data, sizeof(sequence));
+    return (sequence * 2654435761u) >> (32 - HashBits);
+}
+
+static void WriteLength(std::vector<uint8_t> &output, size_t length)
+{
+    // Called with the part of the length that did not fit into its nibble.
+    while (length >= 255)
+    {
+        output.push_back(255);
+        length -= 255;
+    }
+    output.push_back(static_cast<uint8_t>(length));
+}
+
+static void WriteSequence(
+    std::vector<uint8_t> &output,
+    const uint8_t *literals,
+    size_t literalCount,
+    size_t offset,
+    size_t matchLength)
+{
+    size_t matchCode = matchLength >= MinMatch ? matchLength - MinMatch : 0;
+    uint8_t token = static_cast<uint8_t>((literalCount < 15 ? literalCount : 15) << 4);
+    token |= static_cast<uint8_t>(matchCode < 15 ? matchCode : 15);
+    output.push_back(token);
+    if (literalCount >= 15)
+    {
+        WriteLength(output, literalCount - 15);
+    }
+
+    output.insert(output.end(), literals, literals + literalCount);
+    if (matchLength == 0)
+    {
+        return;
+    }
+
+    output.push_back(static_cast<uint8_t>(offset));
+    output.push_back(static_cast<uint8_t>(offset >> 8));
+    if (matchCode >= 15)
+    {
+        WriteLength(output, matchCode - 15);
+    }
+}
+
+std::vector<uint8_t> CompressBlock(const uint8_t *data, size_t size)
+{
+    std::vector<uint8_t> output;
+    output.reserve(size / 2 + 16);
+    std::vector<uint32_t> table(size_t(1) << HashBits, NoPosition);
+
+    size_t literalStart = 0;
+    size_t position = 0;
+    while (position + MinMatch <= size)
+    {
+        uint32_t &slot = table[HashSequence(data + position)];
+        size_t candidate = slot;
+        slot = static_cast<uint32_t>(position);
+        if (candidate == NoPosition
+            || position - candidate > MaxOffset
+            || memcmp(data + candidate, data + position, MinMatch) != 0)
+        {
+            position++;
+            continue;
+        }
+
+        size_t length = MinMatch;
+        while (position + length < size && data[candidate + length] == data[position + length])
+        {
+            length++;
+        }
+
+        WriteSequence(output, data + literalStart, position - literalStart, position - candidate, length);
+        position += length;
+        literalStart = position;
+    }
+
+    WriteSequence(output, data + literalStart, size - literalStart, 0, 0);
+    return output;
+}
+
+static bool ReadLength(const uint8_t *&source, const uint8_t *end, size_t &length)
+{
+    uint8_t value;
+    do
+    {
+        if (source == end)
+        {
+            return false;
+        }
+
+        value = *source++;
+        length += value;
+    } while (value == 255);
+
+    return true;
+}
+
+bool DecompressBlock(const uint8_t *source, size_t sourceSize, uint8_t *destination, size_t destinationSize)
+{
+    const uint8_t *end = source + sourceSize;
+    size_t written = 0;
+    while (source != end)
+    {
+        uint8_t token = *source++;
+        size_t literalCount = token >> 4;
+        if (literalCount == 15 && !ReadLength(source, end, literalCount))
+        {
+            return false;
+        }
+
+        if (literalCount > static_cast<size_t>(end - source) || literalCount > destinationSize - written)
+        {
+            return false;
+        }
+
+        memcpy(destination + written, source, literalCount);
+        source += literalCount;
+        written += literalCount;
+        if (source == end)
+        {
+            break;
+        }
+
+        if (end - source < 2)
+        {
+            return false;
+        }
+
+        size_t offset = source[0] | (size_t(source[1]) << 8);
+        source += 2;
+        size_t matchLength = token & 0xF;
+        if (matchLength == 15 && !ReadLength(source, end, matchLength))
+        {
+            return false;
+        }
+
+        matchLength += MinMatch;
+        if (offset == 0 || offset > written || matchLength > destinationSize - written)
+        {
+            return false;
+        }
+
+        // Matches may overlap the bytes they produce, so they are copied forwards one byte at a time.
+        const uint8_t *match = destination + written - offset;
+        for (size_t i = 0; i < matchLength; i++)
+        {
+            destination[written + i] = match[i];
+        }
+        written += matchLength;
+    }
+
+    return written == destinationSize;
+}
+} // namespace Veldrid
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace Veldrid
+{
+// A small byte-oriented LZ77 codec for shader bundle entries. Each sequence is a token byte holding the
+// literal count and match length in its two nibbles, the literals, a 16-bit match offset and any length
+// extension bytes. The last sequence only holds literals. Nothing is stored about the decoded size: the
+// caller records it next to the compressed data.
+std::vector<uint8_t> CompressBlock(const uint8_t *data, size_t size);
+
+// Returns false if the input is malformed or does not decode to exactly destinationSize bytes.
+bool DecompressBlock(const uint8_t *source, size_t sourceSize, uint8_t *destination, size_t destinationSize);
+} // namespace Veldrid
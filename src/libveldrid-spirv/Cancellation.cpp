@@ -0,0 +1,30 @@
+#include "Cancellation.hpp"
+
+namespace Veldrid
+{
+static thread_local const std::atomic<bool> *t_cancellationFlag = nullptr;
+
+CancellationScope::CancellationScope(const std::atomic<bool> *flag)
+    : _previous(t_cancellationFlag)
+{
+    t_cancellationFlag = flag;
+}
+
+CancellationScope::~CancellationScope()
+{
+    t_cancellationFlag = _previous;
+}
+
+const std::atomic<bool> *GetCancellationFlag()
+{
+    return t_cancellationFlag;
+}
+
+void ThrowIfCancelled()
+{
+    if (t_cancellationFlag != nullptr && t_cancellationFlag->load(std::memory_order_relaxed))
+    {
+        throw CompilationCancelled();
+    }
+}
+} // namespace Veldrid
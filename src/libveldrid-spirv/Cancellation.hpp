@@ -0,0 +1,36 @@
+#pragma once
+
+#include <atomic>
+#include <stdexcept>
+
+namespace Veldrid
+{
+// Thrown at the next phase boundary once the compilation running on the current thread was cancelled.
+class CompilationCancelled : public std::runtime_error
+{
+public:
+    CompilationCancelled() : std::runtime_error("The compilation was cancelled.") {}
+};
+
+// Makes the given flag the cancellation flag of the current thread until the scope ends. Iterations of
+// ThreadPool::ParallelFor run under the flag of the thread which started them. A null flag means the
+// work cannot be cancelled.
+class CancellationScope
+{
+public:
+    explicit CancellationScope(const std::atomic<bool> *flag);
+    ~CancellationScope();
+
+    CancellationScope(const CancellationScope &) = delete;
+    CancellationScope &operator=(const CancellationScope &) = delete;
+
+private:
+    const std::atomic<bool> *_previous;
+};
+
+const std::atomic<bool> *GetCancellationFlag();
+
+// Throws CompilationCancelled if the flag of the current thread is set. PhaseTimer calls this whenever a
+// phase starts, so cancellation takes effect between phases.
+void ThrowIfCancelled();
+} // namespace Veldrid
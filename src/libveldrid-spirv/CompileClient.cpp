@@ -0,0 +1,207 @@
+#include "CompileClient.hpp"
+#include "CompileProtocol.hpp"
+#include <stdlib.h>
+
+#ifndef _WIN32
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace Veldrid
+{
+static const std::chrono::seconds RetryDelay(1);
+
+#ifndef _WIN32
+static int Connect(const std::string &socketPath)
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path))
+    {
+        return -1;
+    }
+    memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connection < 0)
+    {
+        return -1;
+    }
+    if (connect(connection, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+    {
+        close(connection);
+        return -1;
+    }
+
+    PrepareSocket(connection);
+    return connection;
+}
+
+static std::string GetWorkingDirectory()
+{
+    char buffer[4096];
+    return getcwd(buffer, sizeof(buffer)) != nullptr ? std::string(buffer) : std::string();
+}
+#endif
+
+CompileClient::CompileClient()
+{
+    const char *socketPath = getenv("VELDRID_SPIRV_COMPILE_SERVER");
+    if (socketPath != nullptr)
+    {
+        _socketPath = socketPath;
+    }
+}
+
+CompileClient::~CompileClient()
+{
+    CloseIdleSockets();
+}
+
+void CompileClient::SetSocketPath(const std::string &socketPath)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    CloseIdleSockets();
+    _socketPath = socketPath;
+    _retryTime = std::chrono::steady_clock::time_point();
+}
+
+void CompileClient::CloseIdleSockets()
+{
+#ifndef _WIN32
+    for (int connection : _idleSockets)
+    {
+        close(connection);
+    }
+#endif
+    _idleSockets.clear();
+}
+
+CompilationResult *CompileClient::CrossCompile(const CrossCompileInfo &info)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_socketPath.empty())
+        {
+            return nullptr;
+        }
+    }
+
+    MessageWriter writer;
+    WriteCrossCompileInfo(writer, info);
+    return Send(CrossCompileRequest, writer.GetBytes());
+}
+
+CompilationResult *CompileClient::CompileGlslToSpirv(const GlslCompileInfo &info)
+{
+#ifndef _WIN32
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_socketPath.empty())
+        {
+            return nullptr;
+        }
+    }
+
+    MessageWriter writer;
+    writer.WriteString(GetWorkingDirectory());
+    WriteGlslCompileInfo(writer, info);
+    return Send(GlslCompileRequest, writer.GetBytes());
+#else
+    (void)info;
+    return nullptr;
+#endif
+}
+
+CompilationResult *CompileClient::Send(uint32_t type, const std::vector<uint8_t> &request)
+{
+#ifndef _WIN32
+    std::string socketPath;
+    int connection = -1;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_socketPath.empty() || std::chrono::steady_clock::now() < _retryTime)
+        {
+            return nullptr;
+        }
+
+        socketPath = _socketPath;
+        if (!_idleSockets.empty())
+        {
+            connection = _idleSockets.back();
+            _idleSockets.pop_back();
+        }
+    }
+
+    // An idle connection may have been closed by a server which has since restarted, so a failure on one
+    // is retried once on a new connection.
+    bool reused = connection >= 0;
+    while (true)
+    {
+        if (connection < 0)
+        {
+            connection = Connect(socketPath);
+            if (connection < 0)
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (_socketPath == socketPath)
+                {
+                    _retryTime = std::chrono::steady_clock::now() + RetryDelay;
+                }
+                return nullptr;
+            }
+        }
+
+        uint32_t responseType;
+        std::vector<uint8_t> response;
+        if (SendMessage(connection, type, request)
+            && ReceiveMessage(connection, responseType, response)
+            && responseType == CompileResultMessage)
+        {
+            CompilationResult *result = nullptr;
+            try
+            {
+                MessageReader reader(response.data(), response.size());
+                result = ReadCompilationResult(reader);
+            }
+            catch (const std::exception &)
+            {
+                close(connection);
+                return nullptr;
+            }
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_socketPath == socketPath)
+            {
+                _idleSockets.push_back(connection);
+            }
+            else
+            {
+                close(connection);
+            }
+            return result;
+        }
+
+        close(connection);
+        connection = -1;
+        if (!reused)
+        {
+            return nullptr;
+        }
+        reused = false;
+    }
+#else
+    (void)type;
+    (void)request;
+    return nullptr;
+#endif
+}
+
+CompileClient &GetCompileClient()
+{
+    static CompileClient client;
+    return client;
+}
+} // namespace Veldrid
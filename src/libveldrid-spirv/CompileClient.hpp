@@ -0,0 +1,42 @@
+#pragma once
+
+#include "InteropStructs.hpp"
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Veldrid
+{
+// Forwards compilations to a CompileServer on the same machine. The forwarding calls return null when no
+// server is configured or the configured one cannot be reached, and the caller then compiles locally.
+// Connections are kept open and reused, one per concurrent call.
+class CompileClient
+{
+public:
+    // Reads the initial socket path from the VELDRID_SPIRV_COMPILE_SERVER environment variable.
+    CompileClient();
+    ~CompileClient();
+
+    CompileClient(const CompileClient &) = delete;
+    CompileClient &operator=(const CompileClient &) = delete;
+
+    // An empty path turns forwarding off.
+    void SetSocketPath(const std::string &socketPath);
+
+    CompilationResult *CrossCompile(const CrossCompileInfo &info);
+    CompilationResult *CompileGlslToSpirv(const GlslCompileInfo &info);
+
+private:
+    CompilationResult *Send(uint32_t type, const std::vector<uint8_t> &request);
+    void CloseIdleSockets();
+
+    std::mutex _mutex;
+    std::string _socketPath;
+    std::vector<int> _idleSockets;
+    // After a failed connection attempt, calls compile locally until this time instead of retrying.
+    std::chrono::steady_clock::time_point _retryTime;
+};
+
+CompileClient &GetCompileClient();
+} // namespace Veldrid
@@ -0,0 +1,351 @@
+#include "CompileProtocol.hpp"
+#include "ResultBuilder.hpp"
+#include <string.h>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace Veldrid
+{
+void MessageWriter::WriteBytes(const void *data, size_t size)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    _bytes.insert(_bytes.end(), bytes, bytes + size);
+}
+
+void MessageWriter::WriteString(const std::string &value)
+{
+    WriteU32(static_cast<uint32_t>(value.size()));
+    WriteBytes(value.data(), value.size());
+}
+
+uint8_t MessageReader::ReadU8()
+{
+    return *ReadBytes(sizeof(uint8_t));
+}
+
+uint32_t MessageReader::ReadU32()
+{
+    uint32_t value;
+    memcpy(&value, ReadBytes(sizeof(value)), sizeof(value));
+    return value;
+}
+
+const uint8_t *MessageReader::ReadBytes(size_t size)
+{
+    if (size > _size - _position)
+    {
+        throw std::runtime_error("The compile server message is truncated.");
+    }
+
+    const uint8_t *ret = _data + _position;
+    _position += size;
+    return ret;
+}
+
+std::string MessageReader::ReadString()
+{
+    uint32_t length = ReadU32();
+    const char *data = reinterpret_cast<const char *>(ReadBytes(length));
+    return std::string(data, length);
+}
+
+uint32_t MessageReader::ReadCount(size_t minElementSize)
+{
+    uint32_t count = ReadU32();
+    if (count > GetRemainingSize() / minElementSize)
+    {
+        throw std::runtime_error("The compile server message is truncated.");
+    }
+
+    return count;
+}
+
+void WriteCrossCompileInfo(MessageWriter &writer, const CrossCompileInfo &info)
+{
+    writer.WriteU32(info.Target);
+    writer.WriteU32(info.FixClipSpaceZ.Value);
+    writer.WriteU32(info.InvertY.Value);
+    writer.WriteU32(info.NormalizeResourceNames.Value);
+    writer.WriteU32(info.SparseResourceLayouts.Value);
+    writer.WriteU32(static_cast<uint32_t>(info.Optimization));
+    writer.WriteU32(info.MinifyOutput.Value);
+    writer.WriteU32(info.PruneStageInterface.Value);
+    writer.WriteArray(info.Specializations);
+    writer.WriteArray(info.VertexShader);
+    writer.WriteArray(info.FragmentShader);
+    writer.WriteArray(info.ComputeShader);
+}
+
+void ReadCrossCompileInfo(MessageReader &reader, CrossCompileInfo &info)
+{
+    info.Target = static_cast<CrossCompileTarget>(reader.ReadU32());
+    info.FixClipSpaceZ = reader.ReadU32() != 0;
+    info.InvertY = reader.ReadU32() != 0;
+    info.NormalizeResourceNames = reader.ReadU32() != 0;
+    info.SparseResourceLayouts = reader.ReadU32() != 0;
+    info.Optimization = static_cast<SpirvOptimization>(reader.ReadU32());
+    info.MinifyOutput = reader.ReadU32() != 0;
+    info.PruneStageInterface = reader.ReadU32() != 0;
+    reader.ReadArray(info.Specializations);
+    reader.ReadArray(info.VertexShader);
+    reader.ReadArray(info.FragmentShader);
+    reader.ReadArray(info.ComputeShader);
+}
+
+void WriteGlslCompileInfo(MessageWriter &writer, const GlslCompileInfo &info)
+{
+    writer.WriteArray(info.SourceText);
+    writer.WriteArray(info.FileName);
+    writer.WriteU32(static_cast<uint32_t>(info.Kind));
+    writer.WriteU32(info.Debug.Value);
+    writer.WriteArray(info.Macros);
+    writer.WriteU32(info.IncludeDirectories.Count);
+    for (uint32_t i = 0; i < info.IncludeDirectories.Count; i++)
+    {
+        writer.WriteArray(info.IncludeDirectories[i]);
+    }
+}
+
+void ReadGlslCompileInfo(MessageReader &reader, GlslCompileInfo &info)
+{
+    reader.ReadArray(info.SourceText);
+    reader.ReadArray(info.FileName);
+    info.Kind = static_cast<shaderc_shader_kind>(reader.ReadU32());
+    info.Debug = reader.ReadU32() != 0;
+    reader.ReadArray(info.Macros);
+    for (uint32_t i = 0; i < info.Macros.Count; i++)
+    {
+        const MacroDefinition &macro = info.Macros[i];
+        if (macro.NameLength > sizeof(macro.Name) || macro.ValueLength > sizeof(macro.Value))
+        {
+            throw std::runtime_error("The compile server message contains an invalid macro definition.");
+        }
+    }
+
+    // Every directory takes at least its length word.
+    uint32_t includeDirectoryCount = reader.ReadCount(sizeof(uint32_t));
+
+    info.IncludeDirectories = InteropArray<InteropArray<char>>(includeDirectoryCount);
+    for (uint32_t i = 0; i < includeDirectoryCount; i++)
+    {
+        reader.ReadArray(info.IncludeDirectories[i]);
+    }
+}
+
+static void WriteResourceElement(MessageWriter &writer, const ResourceElementDescription &element)
+{
+    writer.WriteArray(element.Name);
+    writer.WriteU8(element.Kind);
+    writer.WriteU8(static_cast<uint8_t>(element.Stages));
+    writer.WriteU32(element.Options);
+}
+
+static void ReadResourceElement(MessageReader &reader, ResourceElementInfo &element)
+{
+    element.Name = reader.ReadString();
+    element.Kind = static_cast<ResourceKind>(reader.ReadU8());
+    element.Stages = static_cast<ShaderStages>(reader.ReadU8());
+    element.Options = reader.ReadU32();
+}
+
+void WriteCompilationResult(MessageWriter &writer, const CompilationResult &result)
+{
+    writer.WriteU32(result.Succeeded.Value);
+    writer.WriteBytes(&result.Fingerprint, sizeof(result.Fingerprint));
+    writer.WriteU32(result.DataBuffers.Count);
+    for (uint32_t i = 0; i < result.DataBuffers.Count; i++)
+    {
+        writer.WriteArray(result.DataBuffers[i]);
+    }
+
+    const ReflectionInfo &reflection = result.Reflection;
+    writer.WriteU32(reflection.VertexElements.Count);
+    for (uint32_t i = 0; i < reflection.VertexElements.Count; i++)
+    {
+        const VertexElementDescription &element = reflection.VertexElements[i];
+        writer.WriteArray(element.Name);
+        writer.WriteU8(static_cast<uint8_t>(element.Semantic));
+        writer.WriteU8(static_cast<uint8_t>(element.Format));
+        writer.WriteU32(element.Offset);
+    }
+
+    writer.WriteU32(reflection.ResourceLayouts.Count);
+    for (uint32_t i = 0; i < reflection.ResourceLayouts.Count; i++)
+    {
+        const InteropArray<ResourceElementDescription> &elements = reflection.ResourceLayouts[i].ResourceElements;
+        writer.WriteU32(elements.Count);
+        for (uint32_t j = 0; j < elements.Count; j++)
+        {
+            WriteResourceElement(writer, elements[j]);
+        }
+    }
+
+    writer.WriteU32(reflection.SparseBindings.Count);
+    for (uint32_t i = 0; i < reflection.SparseBindings.Count; i++)
+    {
+        const SparseResourceBinding &binding = reflection.SparseBindings[i];
+        writer.WriteU32(binding.Set);
+        writer.WriteU32(binding.Binding);
+        WriteResourceElement(writer, binding.Element);
+    }
+}
+
+CompilationResult *ReadCompilationResult(MessageReader &reader)
+{
+    bool succeeded = reader.ReadU32() != 0;
+    Hash128 fingerprint;
+    memcpy(&fingerprint, reader.ReadBytes(sizeof(fingerprint)), sizeof(fingerprint));
+
+    // The buffers are copied straight out of the payload by CreateResult.
+    uint32_t bufferCount = reader.ReadCount(sizeof(uint32_t));
+
+    std::vector<ByteSpan> dataBuffers(bufferCount);
+    for (uint32_t i = 0; i < bufferCount; i++)
+    {
+        dataBuffers[i].Size = reader.ReadU32();
+        dataBuffers[i].Data = reader.ReadBytes(dataBuffers[i].Size);
+    }
+
+    // The minimum sizes count a name's length word plus the fixed fields that follow it.
+    const size_t MinVertexElementSize = sizeof(uint32_t) + 2 * sizeof(uint8_t) + sizeof(uint32_t);
+    const size_t MinResourceElementSize = sizeof(uint32_t) + 2 * sizeof(uint8_t) + sizeof(uint32_t);
+    ReflectionData reflection;
+    reflection.VertexElements.resize(reader.ReadCount(MinVertexElementSize));
+    for (VertexElementInfo &element : reflection.VertexElements)
+    {
+        element.Name = reader.ReadString();
+        element.Semantic = static_cast<VertexElementSemantic>(reader.ReadU8());
+        element.Format = static_cast<VertexElementFormat>(reader.ReadU8());
+        element.Offset = reader.ReadU32();
+    }
+
+    reflection.ResourceLayouts.resize(reader.ReadCount(sizeof(uint32_t)));
+    for (std::vector<ResourceElementInfo> &layout : reflection.ResourceLayouts)
+    {
+        layout.resize(reader.ReadCount(MinResourceElementSize));
+        for (ResourceElementInfo &element : layout)
+        {
+            ReadResourceElement(reader, element);
+        }
+    }
+
+    reflection.SparseBindings.resize(reader.ReadCount(2 * sizeof(uint32_t) + MinResourceElementSize));
+    for (SparseBindingInfo &binding : reflection.SparseBindings)
+    {
+        binding.Set = reader.ReadU32();
+        binding.Binding = reader.ReadU32();
+        ReadResourceElement(reader, binding.Element);
+    }
+
+    CompilationResult *result = CreateResult(dataBuffers.data(), bufferCount, &reflection);
+    result->Succeeded = succeeded;
+    result->Fingerprint = fingerprint;
+    return result;
+}
+
+#ifndef _WIN32
+#ifdef MSG_NOSIGNAL
+static const int SendFlags = MSG_NOSIGNAL;
+#else
+static const int SendFlags = 0;
+#endif
+
+void PrepareSocket(int socket)
+{
+#ifdef SO_NOSIGPIPE
+    int enabled = 1;
+    setsockopt(socket, SOL_SOCKET, SO_NOSIGPIPE, &enabled, sizeof(enabled));
+#else
+    (void)socket;
+#endif
+}
+
+static bool WriteAll(int socket, const void *data, size_t size)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    while (size > 0)
+    {
+        ssize_t written = send(socket, bytes, size, SendFlags);
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            return false;
+        }
+
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+
+    return true;
+}
+
+static bool ReadAll(int socket, void *data, size_t size)
+{
+    uint8_t *bytes = static_cast<uint8_t *>(data);
+    while (size > 0)
+    {
+        ssize_t count = recv(socket, bytes, size, 0);
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (count <= 0)
+        {
+            return false;
+        }
+
+        bytes += count;
+        size -= static_cast<size_t>(count);
+    }
+
+    return true;
+}
+
+bool SendMessage(int socket, uint32_t type, const std::vector<uint8_t> &payload)
+{
+    CompileMessageHeader header = {};
+    header.Magic = CompileMessageMagic;
+    header.Version = CompileProtocolVersion;
+    header.Type = type;
+    header.Size = payload.size();
+    return WriteAll(socket, &header, sizeof(header)) && WriteAll(socket, payload.data(), payload.size());
+}
+
+bool ReceiveMessage(int socket, uint32_t &type, std::vector<uint8_t> &payload)
+{
+    CompileMessageHeader header;
+    if (!ReadAll(socket, &header, sizeof(header))
+        || header.Magic != CompileMessageMagic
+        || header.Version != CompileProtocolVersion
+        || header.Size > MaxCompileMessageSize)
+    {
+        return false;
+    }
+
+    type = header.Type;
+    payload.resize(static_cast<size_t>(header.Size));
+    return ReadAll(socket, payload.data(), payload.size());
+}
+#else
+void PrepareSocket(int)
+{
+}
+
+bool SendMessage(int, uint32_t, const std::vector<uint8_t> &)
+{
+    return false;
+}
+
+bool ReceiveMessage(int, uint32_t &, std::vector<uint8_t> &)
+{
+    return false;
+}
+#endif
+} // namespace Veldrid
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "InteropStructs.hpp"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Veldrid
+{
+// The compile server protocol. Both ends run on the same machine, so values are sent in native byte order.
+// Every message is a CompileMessageHeader followed by Size bytes of payload. A client sends one request
+// and reads one CompileResultMessage before it sends the next request on the same connection.
+static const uint32_t CompileMessageMagic = 0x43505356; // "VSPC"
+static const uint32_t CompileProtocolVersion = 1;
+// Messages larger than this are treated as a protocol error.
+static const uint64_t MaxCompileMessageSize = 1ull << 30;
+
+enum CompileMessageType : uint32_t
+{
+    // A CrossCompileInfo.
+    CrossCompileRequest = 1,
+    // The client's working directory, followed by a GlslCompileInfo.
+    GlslCompileRequest = 2,
+    // A CompilationResult.
+    CompileResultMessage = 3,
+};
+
+#pragma pack(push, 1)
+struct CompileMessageHeader
+{
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t Type;
+    uint32_t Reserved;
+    uint64_t Size;
+};
+#pragma pack(pop)
+
+class MessageWriter
+{
+public:
+    void WriteU8(uint8_t value) { WriteBytes(&value, sizeof(value)); }
+    void WriteU32(uint32_t value) { WriteBytes(&value, sizeof(value)); }
+    void WriteBytes(const void *data, size_t size);
+    void WriteString(const std::string &value);
+
+    // Writes the element count followed by the elements, which must be plain data.
+    template <typename T>
+    void WriteArray(const InteropArray<T> &array)
+    {
+        WriteU32(array.Count);
+        WriteBytes(array.Data, array.Count * sizeof(T));
+    }
+
+    const std::vector<uint8_t> &GetBytes() const { return _bytes; }
+
+private:
+    std::vector<uint8_t> _bytes;
+};
+
+// Reads a payload written by MessageWriter. Throws std::runtime_error when the payload is truncated.
+class MessageReader
+{
+public:
+    MessageReader(const uint8_t *data, size_t size) : _data(data), _size(size) {}
+
+    uint8_t ReadU8();
+    uint32_t ReadU32();
+    // Returns a pointer to the next size bytes inside the payload.
+    const uint8_t *ReadBytes(size_t size);
+    std::string ReadString();
+    // Reads an element count, rejecting counts whose elements could not fit in the rest of the payload even at
+    // their smallest encoding, so that a corrupt count never drives a huge allocation.
+    uint32_t ReadCount(size_t minElementSize);
+
+    // Copies the elements into memory owned by the array.
+    template <typename T>
+    void ReadArray(InteropArray<T> &array)
+    {
+        uint32_t count = ReadU32();
+        if (count > GetRemainingSize() / sizeof(T))
+        {
+            throw std::runtime_error("The compile server message is truncated.");
+        }
+
+        array.CopyFrom(count, reinterpret_cast<const T *>(ReadBytes(count * sizeof(T))));
+    }
+
+    size_t GetRemainingSize() const { return _size - _position; }
+
+private:
+    const uint8_t *_data;
+    size_t _size;
+    size_t _position = 0;
+};
+
+void WriteCrossCompileInfo(MessageWriter &writer, const CrossCompileInfo &info);
+void ReadCrossCompileInfo(MessageReader &reader, CrossCompileInfo &info);
+void WriteGlslCompileInfo(MessageWriter &writer, const GlslCompileInfo &info);
+void ReadGlslCompileInfo(MessageReader &reader, GlslCompileInfo &info);
+void WriteCompilationResult(MessageWriter &writer, const CompilationResult &result);
+// Builds a new result from the payload, which is released with DestroyResult.
+CompilationResult *ReadCompilationResult(MessageReader &reader);
+
+// Prepares a connected socket for SendMessage. Writing to a closed connection then fails instead of
+// raising SIGPIPE.
+void PrepareSocket(int socket);
+
+// Blocking socket I/O. Both return false if the connection fails or is closed; ReceiveMessage also
+// returns false for a message that does not follow the protocol.
+bool SendMessage(int socket, uint32_t type, const std::vector<uint8_t> &payload);
+bool ReceiveMessage(int socket, uint32_t &type, std::vector<uint8_t> &payload);
+} // namespace Veldrid
@@ -0,0 +1,215 @@
+#include "CompileServer.hpp"
+#include "CompileClient.hpp"
+#include "CompileProtocol.hpp"
+#include "ResultBuilder.hpp"
+#include "libveldrid-spirv.hpp"
+#include <stdexcept>
+#include <thread>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace Veldrid
+{
+VD_EXPORT CompilationResult *CrossCompile(CrossCompileInfo *info);
+VD_EXPORT CompilationResult *CompileGlslToSpirv(GlslCompileInfo *info);
+VD_EXPORT void FreeResult(CompilationResult *result);
+
+#ifndef _WIN32
+// How often Run() checks whether it was stopped.
+static const int AcceptPollMilliseconds = 250;
+
+static sockaddr_un GetSocketAddress(const std::string &socketPath)
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path))
+    {
+        throw std::runtime_error("The socket path \"" + socketPath + "\" is too long.");
+    }
+
+    memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+    return address;
+}
+
+static void SetArray(InteropArray<char> &array, const std::string &value)
+{
+    array.CopyFrom(static_cast<uint32_t>(value.size()), value.data());
+}
+
+// Relative paths in a request are relative to the client's working directory. Include directories are
+// always resolved; the file name is only resolved if it names an existing file, since it may just be a
+// description of the source.
+static void ResolveClientPaths(const std::string &workingDirectory, GlslCompileInfo &info)
+{
+    for (uint32_t i = 0; i < info.IncludeDirectories.Count; i++)
+    {
+        InteropArray<char> &directory = info.IncludeDirectories[i];
+        if (directory.Count > 0 && directory.Data[0] != '/')
+        {
+            SetArray(directory, workingDirectory + "/" + std::string(directory.Data, directory.Count));
+        }
+    }
+
+    if (info.FileName.Count > 0 && info.FileName.Data[0] != '/')
+    {
+        std::string path = workingDirectory + "/" + std::string(info.FileName.Data, info.FileName.Count);
+        struct stat status;
+        if (stat(path.c_str(), &status) == 0 && S_ISREG(status.st_mode))
+        {
+            SetArray(info.FileName, path);
+        }
+    }
+}
+
+static CompilationResult *HandleRequest(uint32_t type, const std::vector<uint8_t> &payload)
+{
+    try
+    {
+        MessageReader reader(payload.data(), payload.size());
+        switch (type)
+        {
+        case CrossCompileRequest:
+        {
+            CrossCompileInfo info;
+            ReadCrossCompileInfo(reader, info);
+            return CrossCompile(&info);
+        }
+        case GlslCompileRequest:
+        {
+            std::string workingDirectory = reader.ReadString();
+            GlslCompileInfo info;
+            ReadGlslCompileInfo(reader, info);
+            ResolveClientPaths(workingDirectory, info);
+            return CompileGlslToSpirv(&info);
+        }
+        default:
+            return CreateErrorResult("Unknown compile server request " + std::to_string(type) + ".");
+        }
+    }
+    catch (const std::exception &e)
+    {
+        return CreateErrorResult(e.what());
+    }
+}
+
+CompileServer::CompileServer(const std::string &socketPath)
+    : _socketPath(socketPath)
+{
+    // Requests must be compiled here, even if this process inherited a server path to forward them to.
+    GetCompileClient().SetSocketPath("");
+
+    sockaddr_un address = GetSocketAddress(socketPath);
+    int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (probe >= 0)
+    {
+        bool running = connect(probe, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0;
+        close(probe);
+        if (running)
+        {
+            throw std::runtime_error("A compile server is already listening on \"" + socketPath + "\".");
+        }
+    }
+
+    unlink(socketPath.c_str());
+    _listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (_listenSocket < 0
+        || bind(_listenSocket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0
+        || listen(_listenSocket, SOMAXCONN) != 0)
+    {
+        std::string error = strerror(errno);
+        if (_listenSocket >= 0)
+        {
+            close(_listenSocket);
+        }
+        throw std::runtime_error("Unable to listen on \"" + socketPath + "\": " + error);
+    }
+}
+
+CompileServer::~CompileServer()
+{
+    close(_listenSocket);
+    unlink(_socketPath.c_str());
+}
+
+void CompileServer::Run()
+{
+    while (!_stopping)
+    {
+        pollfd listener = { _listenSocket, POLLIN, 0 };
+        if (poll(&listener, 1, AcceptPollMilliseconds) <= 0)
+        {
+            continue;
+        }
+
+        int connection = accept(_listenSocket, nullptr, nullptr);
+        if (connection < 0)
+        {
+            continue;
+        }
+
+        PrepareSocket(connection);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _connections.insert(connection);
+        }
+        std::thread([this, connection]() { Serve(connection); }).detach();
+    }
+
+    // Wakes connections waiting for their next request, and waits for those still compiling to finish.
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (int connection : _connections)
+    {
+        shutdown(connection, SHUT_RDWR);
+    }
+    _connectionClosed.wait(lock, [this]() { return _connections.empty(); });
+}
+
+void CompileServer::Serve(int connection)
+{
+    uint32_t type;
+    std::vector<uint8_t> payload;
+    while (!_stopping && ReceiveMessage(connection, type, payload))
+    {
+        CompilationResult *result = HandleRequest(type, payload);
+        MessageWriter writer;
+        WriteCompilationResult(writer, *result);
+        FreeResult(result);
+        if (!SendMessage(connection, CompileResultMessage, writer.GetBytes()))
+        {
+            break;
+        }
+    }
+
+    // Closed under the lock, so that Run() never shuts down a descriptor which was already reused.
+    std::lock_guard<std::mutex> lock(_mutex);
+    close(connection);
+    _connections.erase(connection);
+    _connectionClosed.notify_all();
+}
+#else
+CompileServer::CompileServer(const std::string &)
+{
+    throw std::runtime_error("The compile server is not supported on this platform.");
+}
+
+CompileServer::~CompileServer()
+{
+}
+
+void CompileServer::Run()
+{
+}
+
+void CompileServer::Serve(int)
+{
+}
+#endif
+} // namespace Veldrid
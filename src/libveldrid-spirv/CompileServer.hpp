@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace Veldrid
+{
+// Serves compile requests from other processes over a Unix domain socket, following CompileProtocol.hpp.
+// Requests are compiled in this process, so they share its worker pool, cross-compile result cache and
+// include file cache. Only available on POSIX systems.
+class CompileServer
+{
+public:
+    // Listens on the given socket path. A socket file left behind by a server which is no longer running
+    // is replaced. Throws if the socket cannot be created or another server is listening on the path.
+    explicit CompileServer(const std::string &socketPath);
+    // Removes the socket file.
+    ~CompileServer();
+
+    CompileServer(const CompileServer &) = delete;
+    CompileServer &operator=(const CompileServer &) = delete;
+
+    // Accepts connections until Stop() is called, serving each one on its own thread. Returns once every
+    // connection has been closed.
+    void Run();
+    // Makes Run() return. Safe to call from a signal handler.
+    void Stop() { _stopping = true; }
+
+private:
+    void Serve(int connection);
+
+    std::string _socketPath;
+    int _listenSocket = -1;
+    std::atomic<bool> _stopping { false };
+    std::mutex _mutex;
+    std::condition_variable _connectionClosed;
+    std::set<int> _connections;
+};
+} // namespace Veldrid
@@ -0,0 +1,114 @@
+#include "CompileTask.hpp"
+#include "Cancellation.hpp"
+#include "ResultBuilder.hpp"
+#include "ResultCache.hpp"
+#include "ThreadPool.hpp"
+#include <chrono>
+
+namespace Veldrid
+{
+struct CompileTask::State
+{
+    std::function<CompilationResult *()> Work;
+    std::atomic<bool> CancelRequested { false };
+    mutable std::mutex Mutex;
+    mutable std::condition_variable Finished;
+    CompileTaskStatus Status = CompileTaskStatus::Pending;
+    CompilationResult *Result = nullptr;
+
+    ~State()
+    {
+        // Cross-compiled results may be shared with the result cache.
+        if (Result != nullptr && !GetCrossCompileCache().Release(Result))
+        {
+            DestroyResult(Result);
+        }
+    }
+
+    bool IsFinished() const
+    {
+        return Status == CompileTaskStatus::Completed || Status == CompileTaskStatus::Cancelled;
+    }
+
+    void Run()
+    {
+        CompilationResult *result;
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            Status = CompileTaskStatus::Running;
+        }
+
+        try
+        {
+            CancellationScope scope(&CancelRequested);
+            ThrowIfCancelled();
+            result = Work();
+        }
+        catch (const std::exception &e)
+        {
+            result = CreateErrorResult(e.what());
+        }
+
+        // The work holds the copied inputs, which are no longer needed.
+        Work = nullptr;
+
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            // A compilation which completed before noticing the request still counts as completed.
+            Status = CancelRequested && !result->Succeeded ? CompileTaskStatus::Cancelled : CompileTaskStatus::Completed;
+            Result = result;
+        }
+
+        Finished.notify_all();
+    }
+};
+
+CompileTask::CompileTask(std::function<CompilationResult *()> work)
+    : _state(std::make_shared<State>())
+{
+    _state->Work = std::move(work);
+    std::shared_ptr<State> state = _state;
+    // The task keeps the pool it was queued on alive until it has run, even if the process-wide pool is
+    // replaced in the meantime.
+    std::shared_ptr<ThreadPool> pool = GetWorkerPool();
+    pool->Enqueue([state, pool]() { state->Run(); });
+}
+
+CompileTask::~CompileTask()
+{
+    Cancel();
+}
+
+CompileTaskStatus CompileTask::GetStatus() const
+{
+    std::lock_guard<std::mutex> lock(_state->Mutex);
+    return _state->Status;
+}
+
+bool CompileTask::Wait(uint32_t timeoutMilliseconds) const
+{
+    std::unique_lock<std::mutex> lock(_state->Mutex);
+    State *state = _state.get();
+    auto isFinished = [state]() { return state->IsFinished(); };
+    if (timeoutMilliseconds == UINT32_MAX)
+    {
+        _state->Finished.wait(lock, isFinished);
+        return true;
+    }
+
+    return _state->Finished.wait_for(lock, std::chrono::milliseconds(timeoutMilliseconds), isFinished);
+}
+
+void CompileTask::Cancel()
+{
+    _state->CancelRequested = true;
+}
+
+CompilationResult *CompileTask::TakeResult()
+{
+    std::lock_guard<std::mutex> lock(_state->Mutex);
+    CompilationResult *result = _state->Result;
+    _state->Result = nullptr;
+    return result;
+}
+} // namespace Veldrid
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "InteropStructs.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace Veldrid
+{
+enum class CompileTaskStatus : uint32_t
+{
+    Pending,
+    Running,
+    Completed,
+    Cancelled,
+};
+
+// A compilation running on the worker pool. The handle and the worker share the task state, so the handle
+// may be destroyed while the work is still running; the result is then released when the work ends.
+class CompileTask
+{
+public:
+    // Queues the work on the worker pool. The work must not refer to memory owned by the caller, and
+    // should report failures as error results.
+    explicit CompileTask(std::function<CompilationResult *()> work);
+    // Cancels the work if it has not finished yet.
+    ~CompileTask();
+
+    CompileTask(const CompileTask &) = delete;
+    CompileTask &operator=(const CompileTask &) = delete;
+
+    CompileTaskStatus GetStatus() const;
+    // Returns true if the task finished within the given time. UINT32_MAX waits without a time limit.
+    bool Wait(uint32_t timeoutMilliseconds) const;
+    // Requests cancellation. A pending task never starts; a running one stops at its next phase boundary
+    // with an error result. A task which already finished is not affected.
+    void Cancel();
+    // Hands the result over to the caller once the task has finished, and null before that or when it
+    // was already taken.
+    CompilationResult *TakeResult();
+
+private:
+    struct State;
+    std::shared_ptr<State> _state;
+};
+} // namespace Veldrid
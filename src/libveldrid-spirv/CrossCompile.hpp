@@ -0,0 +1,28 @@
+#pragma once
+
+#include "InteropStructs.hpp"
+#include "OutputWriter.hpp"
+#include "ResultBuilder.hpp"
+
+namespace Veldrid
+{
+// One output of a compilation: the target language and the specialization constant values to apply.
+struct CompileJob
+{
+    CrossCompileTarget Target;
+    const InteropArray<SpecializationConstant> *Specializations;
+};
+
+// 2 for a vertex-fragment pair, 1 for a compute shader and 0 for an invalid combination.
+uint32_t GetStageCount(const CrossCompileInfo &info);
+
+// Parses the modules of the given info once and emits them for every job. The stage texts are submitted
+// job-major starting at firstOutput; reflection data is gathered for the first job only.
+void CompileJobs(
+    const CrossCompileInfo &info,
+    const CompileJob *jobs,
+    uint32_t jobCount,
+    OutputWriter &output,
+    uint32_t firstOutput,
+    ReflectionData &reflectionData);
+} // namespace Veldrid
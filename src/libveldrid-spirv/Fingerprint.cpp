@@ -0,0 +1,126 @@
+#include "Fingerprint.hpp"
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+namespace Veldrid
+{
+static const uint32_t SpirvMagic = 0x07230203;
+static const size_t HeaderWordCount = 5;
+
+enum : uint32_t
+{
+    OpSourceContinued = 2,
+    OpSource = 3,
+    OpSourceExtension = 4,
+    OpName = 5,
+    OpMemberName = 6,
+    OpString = 7,
+    OpLine = 8,
+    OpExtension = 10,
+    OpExtInstImport = 11,
+    OpExtInst = 12,
+    OpNoLine = 317,
+    OpModuleProcessed = 330,
+};
+
+static bool StartsWith(const uint32_t *operands, size_t operandCount, const char *prefix)
+{
+    size_t length = strlen(prefix);
+    return operandCount * sizeof(uint32_t) >= length && memcmp(operands, prefix, length) == 0;
+}
+
+static bool IsDebugInstruction(
+    uint32_t opcode,
+    const uint32_t *instruction,
+    uint32_t wordCount,
+    std::vector<uint32_t> &nonSemanticSets)
+{
+    switch (opcode)
+    {
+    case OpSourceContinued:
+    case OpSource:
+    case OpSourceExtension:
+    case OpName:
+    case OpMemberName:
+    case OpString:
+    case OpLine:
+    case OpNoLine:
+    case OpModuleProcessed:
+        return true;
+    case OpExtension:
+        return StartsWith(instruction + 1, wordCount - 1, "SPV_KHR_non_semantic_info");
+    case OpExtInstImport:
+        if (wordCount > 2 && StartsWith(instruction + 2, wordCount - 2, "NonSemantic."))
+        {
+            nonSemanticSets.push_back(instruction[1]);
+            return true;
+        }
+        return false;
+    case OpExtInst:
+        return wordCount > 3
+            && std::find(nonSemanticSets.begin(), nonSemanticSets.end(), instruction[3]) != nonSemanticSets.end();
+    default:
+        return false;
+    }
+}
+
+bool FingerprintSpirv(const uint32_t *words, size_t wordCount, Hash128 &fingerprint)
+{
+    if (wordCount < HeaderWordCount || words[0] != SpirvMagic)
+    {
+        return false;
+    }
+
+    Hasher128 hasher;
+    hasher.UpdateValue(words[1]); // Version
+    hasher.UpdateValue(words[4]); // Schema
+
+    // Instruction boundaries can only be found by walking the length prefixes, but the semantic
+    // instructions between two debug instructions are contiguous, so each such run is hashed in one
+    // bulk update rather than instruction by instruction.
+    std::vector<uint32_t> nonSemanticSets;
+    size_t runStart = HeaderWordCount;
+    size_t position = HeaderWordCount;
+    while (position < wordCount)
+    {
+        uint32_t instructionWordCount = words[position] >> 16;
+        uint32_t opcode = words[position] & 0xFFFF;
+        if (instructionWordCount == 0 || instructionWordCount > wordCount - position)
+        {
+            return false;
+        }
+
+        if (IsDebugInstruction(opcode, &words[position], instructionWordCount, nonSemanticSets))
+        {
+            hasher.Update(&words[runStart], (position - runStart) * sizeof(uint32_t));
+            runStart = position + instructionWordCount;
+        }
+
+        position += instructionWordCount;
+    }
+
+    hasher.Update(&words[runStart], (wordCount - runStart) * sizeof(uint32_t));
+    fingerprint = hasher.Finish();
+    return true;
+}
+
+Hash128 FingerprintStages(const CrossCompileInfo &info)
+{
+    const InteropArray<uint32_t> *stages[3] = { &info.VertexShader, &info.FragmentShader, &info.ComputeShader };
+    Hasher128 hasher;
+    for (const InteropArray<uint32_t> *stage : stages)
+    {
+        Hash128 stageFingerprint = Hash128();
+        if (stage->Count > 0)
+        {
+            FingerprintSpirv(stage->Data, stage->Count, stageFingerprint);
+        }
+
+        hasher.UpdateValue(stageFingerprint.Low);
+        hasher.UpdateValue(stageFingerprint.High);
+    }
+
+    return hasher.Finish();
+}
+} // namespace Veldrid
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Hashing.hpp"
+#include "InteropStructs.hpp"
+#include <stddef.h>
+
+namespace Veldrid
+{
+// Computes a 128-bit hash of the semantic content of a SPIR-V module. Debug-only instructions (names,
+// source text, line information, module-processed notes and non-semantic extended instructions) and the
+// generator and ID bound header words are left out, so modules that only differ in those hash equal.
+// Returns false if the word stream is not a well-formed SPIR-V module.
+bool FingerprintSpirv(const uint32_t *words, size_t wordCount, Hash128 &fingerprint);
+
+// Combines the fingerprints of all stages given in the info. Stages that are not valid modules
+// contribute a zero fingerprint.
+Hash128 FingerprintStages(const CrossCompileInfo &info);
+} // namespace Veldrid
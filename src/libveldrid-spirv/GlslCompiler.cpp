@@ -0,0 +1,325 @@
+#include "GlslCompiler.hpp"
+#include "Fingerprint.hpp"
+#include "IncludeResolver.hpp"
+#include "PhaseTimer.hpp"
+#include "ResultBuilder.hpp"
+#include "SpirvDiskCache.hpp"
+#include "spirv-tools/libspirv.h"
+#include <ctype.h>
+#include <string.h>
+
+// Set by the build to the shaderc and glslang revisions it was configured with.
+#ifndef VD_SHADERC_VERSION
+#define VD_SHADERC_VERSION "unknown"
+#endif
+
+namespace Veldrid
+{
+static shaderc_optimization_level GetOptimizationLevel(bool debug)
+{
+    return debug ? shaderc_optimization_level_zero : shaderc_optimization_level_performance;
+}
+
+void SetDebugOption(shaderc::CompileOptions &options, bool debug)
+{
+    if (debug)
+    {
+        options.SetGenerateDebugInfo();
+    }
+    options.SetOptimizationLevel(GetOptimizationLevel(debug));
+}
+
+void AddMacroDefinitions(shaderc::CompileOptions &options, const InteropArray<MacroDefinition> &macros)
+{
+    for (uint32_t i = 0; i < macros.Count; i++)
+    {
+        const MacroDefinition &macro = macros[i];
+        if (macro.ValueLength == 0)
+        {
+            options.AddMacroDefinition(std::string(macro.Name, macro.NameLength));
+        }
+        else
+        {
+            options.AddMacroDefinition(
+                std::string(macro.Name, macro.NameLength),
+                std::string(macro.Value, macro.ValueLength));
+        }
+    }
+}
+
+std::unique_ptr<shaderc::Compiler> ShadercCompilerPool::Acquire()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_idleCompilers.empty())
+        {
+            std::unique_ptr<shaderc::Compiler> ret = std::move(_idleCompilers.back());
+            _idleCompilers.pop_back();
+            return ret;
+        }
+    }
+
+    return std::unique_ptr<shaderc::Compiler>(new shaderc::Compiler());
+}
+
+void ShadercCompilerPool::Return(std::unique_ptr<shaderc::Compiler> compiler)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _idleCompilers.push_back(std::move(compiler));
+}
+
+static void HashString(Hasher128 &hasher, const char *text)
+{
+    size_t length = strlen(text);
+    hasher.Update(text, length);
+    hasher.UpdateValue(static_cast<uint64_t>(length));
+}
+
+// Hashes everything that can influence the SPIR-V produced from a preprocessed source: the text, the
+// versions of shaderc, glslang and SPIRV-Tools, and the option state. Macros are already expanded in the
+// text, and every other option is derived from the debug flag by SetDebugOption. Without debug
+// information the SPIR-V does not depend on line numbers, so whitespace runs and #line directives are
+// dropped; edits that only touch comments or layout then map to the same key.
+static Hash128 HashPreprocessedSource(
+    const char *text,
+    size_t length,
+    shaderc_shader_kind kind,
+    bool debug,
+    const std::string &fileName)
+{
+    static const uint32_t FormatVersion = 2;
+
+    Hasher128 hasher;
+    hasher.UpdateValue(FormatVersion);
+    HashString(hasher, VD_SHADERC_VERSION);
+    HashString(hasher, spvSoftwareVersionDetailsString());
+    hasher.UpdateValue(static_cast<uint32_t>(kind));
+    hasher.UpdateValue(static_cast<uint32_t>(debug));
+    hasher.UpdateValue(static_cast<uint32_t>(GetOptimizationLevel(debug)));
+    if (debug)
+    {
+        hasher.Update(fileName.data(), fileName.size());
+        hasher.UpdateValue(static_cast<uint64_t>(fileName.size()));
+        hasher.Update(text, length);
+        return hasher.Finish();
+    }
+
+    std::string tokens;
+    tokens.reserve(length);
+    const char *end = text + length;
+    while (text < end)
+    {
+        const char *lineEnd = static_cast<const char *>(memchr(text, '\n', end - text));
+        if (lineEnd == nullptr)
+        {
+            lineEnd = end;
+        }
+
+        const char *start = text;
+        while (start < lineEnd && isspace(static_cast<unsigned char>(*start)))
+        {
+            start++;
+        }
+
+        if (lineEnd - start < 5 || strncmp(start, "#line", 5) != 0)
+        {
+            bool pendingSpace = false;
+            for (const char *c = start; c < lineEnd; c++)
+            {
+                if (isspace(static_cast<unsigned char>(*c)))
+                {
+                    pendingSpace = true;
+                    continue;
+                }
+
+                if (pendingSpace)
+                {
+                    tokens += ' ';
+                    pendingSpace = false;
+                }
+                tokens += *c;
+            }
+            if (start < lineEnd)
+            {
+                tokens += '\n';
+            }
+        }
+
+        text = lineEnd + 1;
+    }
+
+    hasher.Update(tokens.data(), tokens.size());
+    return hasher.Finish();
+}
+
+// Looks for '#', optional blanks and "include", the way the preprocessor spells the directive.
+static bool ContainsIncludeDirective(const InteropArray<char> &source)
+{
+    static const char Directive[] = "include";
+    static const size_t DirectiveLength = sizeof(Directive) - 1;
+    if (source.Count == 0)
+    {
+        return false;
+    }
+
+    const char *end = source.Data + source.Count;
+    const char *hash = source.Data;
+    while ((hash = static_cast<const char *>(memchr(hash, '#', end - hash))) != nullptr)
+    {
+        const char *name = hash + 1;
+        while (name < end && (*name == ' ' || *name == '\t'))
+        {
+            name++;
+        }
+
+        if (static_cast<size_t>(end - name) >= DirectiveLength && memcmp(name, Directive, DirectiveLength) == 0)
+        {
+            return true;
+        }
+
+        hash = name;
+    }
+
+    return false;
+}
+
+// The SPIR-V module is fingerprinted and followed by the paths of all resolved include files, one per data buffer.
+static CompilationResult *CreateSpirvResult(const uint32_t *words, size_t wordCount, const CachedIncluder *includer)
+{
+    std::vector<ByteSpan> dataBuffers;
+    dataBuffers.push_back({ words, wordCount * sizeof(uint32_t) });
+    if (includer != nullptr)
+    {
+        for (const std::string &path : includer->GetIncludedFiles())
+        {
+            dataBuffers.push_back({ path.data(), path.size() });
+        }
+    }
+
+    CompilationResult *result = CreateResult(dataBuffers.data(), static_cast<uint32_t>(dataBuffers.size()), nullptr);
+    FingerprintSpirv(words, wordCount, result->Fingerprint);
+    return result;
+}
+
+// A failed compilation keeps the include files resolved before the error, after the message.
+static CompilationResult *CreateGlslErrorResult(const std::string &errorMessage, const CachedIncluder *includer)
+{
+    return includer != nullptr
+        ? CreateErrorResult(errorMessage, includer->GetIncludedFiles())
+        : CreateErrorResult(errorMessage);
+}
+
+static CompilationResult *CompileWithCompiler(
+    const shaderc::Compiler &compiler,
+    const GlslCompileInfo &info,
+    const shaderc::CompileOptions &options,
+    bool debug,
+    const CachedIncluder *includer)
+{
+    std::string fileName(info.FileName.Data, info.FileName.Count);
+    PhaseTimer timer(CompilePhase::GlslCompile);
+    timer.AddBytes(info.SourceText.Count);
+
+    SpirvDiskCache &diskCache = GetSpirvDiskCache();
+    bool useDiskCache = diskCache.IsEnabled();
+    Hash128 key = {};
+    if (useDiskCache)
+    {
+        shaderc::PreprocessedSourceCompilationResult preprocessed = compiler.PreprocessGlsl(
+            info.SourceText.Data,
+            info.SourceText.Count,
+            info.Kind,
+            fileName.c_str(),
+            options);
+        if (preprocessed.GetCompilationStatus() != shaderc_compilation_status_success)
+        {
+            return CreateGlslErrorResult(preprocessed.GetErrorMessage(), includer);
+        }
+
+        key = HashPreprocessedSource(
+            preprocessed.begin(),
+            static_cast<size_t>(preprocessed.end() - preprocessed.begin()),
+            info.Kind,
+            debug,
+            fileName);
+
+        std::vector<uint32_t> cached;
+        if (diskCache.Load(key, cached))
+        {
+            timer.Stop();
+            return CreateSpirvResult(cached.data(), cached.size(), includer);
+        }
+    }
+
+    shaderc::SpvCompilationResult result = compiler.CompileGlslToSpv(
+        info.SourceText.Data,
+        info.SourceText.Count,
+        info.Kind,
+        fileName.c_str(),
+        options);
+
+    if (result.GetCompilationStatus() != shaderc_compilation_status_success)
+    {
+        return CreateGlslErrorResult(result.GetErrorMessage(), includer);
+    }
+
+    size_t wordCount = static_cast<size_t>(result.end() - result.begin());
+    if (useDiskCache)
+    {
+        diskCache.Store(key, result.begin(), wordCount);
+    }
+
+    timer.Stop();
+
+    return CreateSpirvResult(result.begin(), wordCount, includer);
+}
+
+CompilationResult *CompileGLSLToSPIRV(
+    ShadercCompilerPool &compilers,
+    const GlslCompileInfo &info,
+    const shaderc::CompileOptions &options,
+    bool debug)
+{
+    std::unique_ptr<shaderc::Compiler> compiler = compilers.Acquire();
+    CompilationResult *result;
+    if (ContainsIncludeDirective(info.SourceText))
+    {
+        // The includer records what it resolves, so each compilation needs its own; the shared options
+        // are left untouched.
+        shaderc::CompileOptions includeOptions(options);
+        CachedIncluder *includer = new CachedIncluder(info.IncludeDirectories);
+        includeOptions.SetIncluder(std::unique_ptr<shaderc::CompileOptions::IncluderInterface>(includer));
+        result = CompileWithCompiler(*compiler, info, includeOptions, debug, includer);
+    }
+    else
+    {
+        result = CompileWithCompiler(*compiler, info, options, debug, nullptr);
+    }
+    compilers.Return(std::move(compiler));
+    return result;
+}
+
+GlslCompilerSession::GlslCompilerSession(const GlslSessionInfo &info)
+    : _debug(info.Debug)
+{
+    SetDebugOption(_baseOptions, _debug);
+    AddMacroDefinitions(_baseOptions, info.Macros);
+}
+
+CompilationResult *GlslCompilerSession::Compile(const GlslCompileInfo &info)
+{
+    bool debug = info.Debug && !_debug;
+    if (!debug && info.Macros.Count == 0)
+    {
+        return CompileGLSLToSPIRV(_compilers, info, _baseOptions, _debug);
+    }
+
+    shaderc::CompileOptions options(_baseOptions);
+    if (debug)
+    {
+        SetDebugOption(options, true);
+    }
+    AddMacroDefinitions(options, info.Macros);
+    return CompileGLSLToSPIRV(_compilers, info, options, _debug || debug);
+}
+} // namespace Veldrid
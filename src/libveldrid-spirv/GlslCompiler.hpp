@@ -0,0 +1,53 @@
+#pragma once
+
+#include "InteropStructs.hpp"
+#include "shaderc.hpp"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Veldrid
+{
+void SetDebugOption(shaderc::CompileOptions &options, bool debug);
+void AddMacroDefinitions(shaderc::CompileOptions &options, const InteropArray<MacroDefinition> &macros);
+
+// shaderc::Compiler objects are costly to create, so they are kept around and handed out to one caller
+// at a time.
+class ShadercCompilerPool
+{
+public:
+    std::unique_ptr<shaderc::Compiler> Acquire();
+    void Return(std::unique_ptr<shaderc::Compiler> compiler);
+
+private:
+    std::mutex _mutex;
+    std::vector<std::unique_ptr<shaderc::Compiler>> _idleCompilers;
+};
+
+// When a SPIR-V disk cache directory is configured, the source is preprocessed first and the SPIR-V is
+// looked up by a hash of the preprocessed text, the shader kind, the options and the versions of shaderc
+// and SPIRV-Tools. The full front end
+// and optimizer only run on a miss. Sources containing #include directives get a CachedIncluder, and the
+// paths of the files it resolved follow the SPIR-V in the result's data buffers.
+CompilationResult *CompileGLSLToSPIRV(
+    ShadercCompilerPool &compilers,
+    const GlslCompileInfo &info,
+    const shaderc::CompileOptions &options,
+    bool debug);
+
+// Keeps the shaderc compilers and a prebuilt base option set alive across compilations. Each compilation
+// only layers its own macros and debug flag on top of the base options. Sessions may be used from several
+// threads at once.
+class GlslCompilerSession
+{
+public:
+    explicit GlslCompilerSession(const GlslSessionInfo &info);
+
+    CompilationResult *Compile(const GlslCompileInfo &info);
+
+private:
+    ShadercCompilerPool _compilers;
+    shaderc::CompileOptions _baseOptions;
+    bool _debug;
+};
+} // namespace Veldrid
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+namespace Veldrid
+{
+struct Hash128
+{
+    uint64_t Low;
+    uint64_t High;
+
+    bool operator==(const Hash128 &other) const { return Low == other.Low && High == other.High; }
+    bool operator!=(const Hash128 &other) const { return !(*this == other); }
+};
+
+inline uint64_t RotateLeft64(uint64_t x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t FinalizeMix64(uint64_t k)
+{
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+// Incremental MurmurHash3 (x64, 128-bit). Data may be fed in arbitrarily-sized pieces; the
+// result only depends on the concatenation of everything passed to Update().
+class Hasher128
+{
+public:
+    explicit Hasher128(uint64_t seed = 0) : _h1(seed), _h2(seed) {}
+
+    void Update(const void *data, size_t size)
+    {
+        const uint8_t *bytes = static_cast<const uint8_t *>(data);
+        _length += size;
+
+        if (_tailLength > 0)
+        {
+            size_t needed = 16 - _tailLength;
+            size_t count = size < needed ? size : needed;
+            memcpy(_tail + _tailLength, bytes, count);
+            _tailLength += count;
+            bytes += count;
+            size -= count;
+            if (_tailLength < 16)
+            {
+                return;
+            }
+
+            MixBlock(_tail);
+            _tailLength = 0;
+        }
+
+        while (size >= 16)
+        {
+            MixBlock(bytes);
+            bytes += 16;
+            size -= 16;
+        }
+
+        if (size > 0)
+        {
+            memcpy(_tail, bytes, size);
+            _tailLength = size;
+        }
+    }
+
+    template <typename T>
+    void UpdateValue(const T &value) { Update(&value, sizeof(T)); }
+
+    Hash128 Finish() const
+    {
+        uint64_t h1 = _h1;
+        uint64_t h2 = _h2;
+        uint64_t k1 = 0;
+        uint64_t k2 = 0;
+
+        for (size_t i = _tailLength; i > 8; i--)
+        {
+            k2 ^= uint64_t(_tail[i - 1]) << ((i - 9) * 8);
+        }
+        if (_tailLength > 8)
+        {
+            k2 *= C2;
+            k2 = RotateLeft64(k2, 33);
+            k2 *= C1;
+            h2 ^= k2;
+        }
+
+        for (size_t i = _tailLength < 8 ? _tailLength : 8; i > 0; i--)
+        {
+            k1 ^= uint64_t(_tail[i - 1]) << ((i - 1) * 8);
+        }
+        if (_tailLength > 0)
+        {
+            k1 *= C1;
+            k1 = RotateLeft64(k1, 31);
+            k1 *= C2;
+            h1 ^= k1;
+        }
+
+        h1 ^= _length;
+        h2 ^= _length;
+        h1 += h2;
+        h2 += h1;
+        h1 = FinalizeMix64(h1);
+        h2 = FinalizeMix64(h2);
+        h1 += h2;
+        h2 += h1;
+
+        Hash128 ret;
+        ret.Low = h1;
+        ret.High = h2;
+        return ret;
+    }
+
+private:
+    static const uint64_t C1 = 0x87c37b91114253d5ULL;
+    static const uint64_t C2 = 0x4cf5ad432745937fULL;
+
+    void MixBlock(const uint8_t *block)
+    {
+        uint64_t k1;
+        uint64_t k2;
+        memcpy(&k1, block, 8);
+        memcpy(&k2, block + 8, 8);
+
+        k1 *= C1;
+        k1 = RotateLeft64(k1, 31);
+        k1 *= C2;
+        _h1 ^= k1;
+        _h1 = RotateLeft64(_h1, 27);
+        _h1 += _h2;
+        _h1 = _h1 * 5 + 0x52dce729;
+
+        k2 *= C2;
+        k2 = RotateLeft64(k2, 33);
+        k2 *= C1;
+        _h2 ^= k2;
+        _h2 = RotateLeft64(_h2, 31);
+        _h2 += _h1;
+        _h2 = _h2 * 5 + 0x38495ab5;
+    }
+
+    uint64_t _h1;
+    uint64_t _h2;
+    uint64_t _length = 0;
+    uint8_t _tail[16];
+    size_t _tailLength = 0;
+};
+
+inline Hash128 HashBytes(const void *data, size_t size, uint64_t seed = 0)
+{
+    Hasher128 hasher(seed);
+    hasher.Update(data, size);
+    return hasher.Finish();
+}
+} // namespace Veldrid
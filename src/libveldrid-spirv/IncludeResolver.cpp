@@ -0,0 +1,203 @@
+#include "IncludeResolver.hpp"
+#include <fstream>
+#include <iterator>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace Veldrid
+{
+// The modification time is only compared for equality. It keeps the file system's full resolution, so
+// that a file rewritten within the same second is still reloaded: nanoseconds on POSIX systems and
+// 100-nanosecond FILETIME intervals on Windows.
+static bool GetFileStatus(const std::string &path, int64_t &modificationTime, uint64_t &size)
+{
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if (!GetFileAttributesExW(Utf8ToWide(path).c_str(), GetFileExInfoStandard, &attributes)
+        || (attributes.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+    {
+        return false;
+    }
+
+    modificationTime = static_cast<int64_t>(
+        (static_cast<uint64_t>(attributes.ftLastWriteTime.dwHighDateTime) << 32)
+        | attributes.ftLastWriteTime.dwLowDateTime);
+    size = (static_cast<uint64_t>(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
+#else
+    struct stat status;
+    if (stat(path.c_str(), &status) != 0 || !S_ISREG(status.st_mode))
+    {
+        return false;
+    }
+
+#ifdef __APPLE__
+    const struct timespec &writeTime = status.st_mtimespec;
+#else
+    const struct timespec &writeTime = status.st_mtim;
+#endif
+    modificationTime = static_cast<int64_t>(writeTime.tv_sec) * 1000000000 + writeTime.tv_nsec;
+    size = static_cast<uint64_t>(status.st_size);
+#endif
+    return true;
+}
+
+const char *IncludeFile::GetData() const
+{
+    if (Mapping != nullptr && Mapping->GetData() != nullptr)
+    {
+        return reinterpret_cast<const char *>(Mapping->GetData());
+    }
+
+    return Contents.c_str();
+}
+
+std::shared_ptr<const IncludeFile> IncludeFileCache::Load(const std::string &path)
+{
+    int64_t modificationTime;
+    uint64_t size;
+    if (!GetFileStatus(path, modificationTime, size))
+    {
+        return nullptr;
+    }
+
+    bool mapFiles;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _files.find(path);
+        if (it != _files.end() && it->second->ModificationTime == modificationTime && it->second->Size == size)
+        {
+            return it->second;
+        }
+
+        mapFiles = _mapFiles;
+    }
+
+    std::shared_ptr<IncludeFile> file = std::make_shared<IncludeFile>();
+    file->Path = path;
+    file->ModificationTime = modificationTime;
+    file->Size = size;
+    if (mapFiles)
+    {
+        try
+        {
+            file->Mapping.reset(new MappedFile(path));
+        }
+        catch (const std::exception &)
+        {
+            return nullptr;
+        }
+        file->Size = file->Mapping->GetSize();
+    }
+    else
+    {
+        std::ifstream stream(ToNativePath(path).c_str(), std::ios::binary);
+        if (!stream)
+        {
+            return nullptr;
+        }
+
+        file->Contents.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+        file->Size = file->Contents.size();
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _files[path] = file;
+    return file;
+}
+
+void IncludeFileCache::SetFileMapping(bool enabled)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _mapFiles = enabled;
+}
+
+void IncludeFileCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _files.clear();
+}
+
+IncludeFileCache &GetIncludeFileCache()
+{
+    static IncludeFileCache cache;
+    return cache;
+}
+
+CachedIncluder::CachedIncluder(const InteropArray<InteropArray<char>> &includeDirectories)
+{
+    for (uint32_t i = 0; i < includeDirectories.Count; i++)
+    {
+        std::string directory(includeDirectories[i].Data, includeDirectories[i].Count);
+        if (!directory.empty() && directory.back() != '/' && directory.back() != '\\')
+        {
+            directory += '/';
+        }
+        _directories.push_back(std::move(directory));
+    }
+}
+
+shaderc_include_result *CachedIncluder::GetInclude(
+    const char *requestedSource,
+    shaderc_include_type type,
+    const char *requestingSource,
+    size_t includeDepth)
+{
+    std::vector<std::string> candidates;
+    if (type == shaderc_include_type_relative)
+    {
+        std::string requesting(requestingSource);
+        size_t separator = requesting.find_last_of("/\\");
+        candidates.push_back(
+            separator == std::string::npos ? requestedSource : requesting.substr(0, separator + 1) + requestedSource);
+    }
+    for (const std::string &directory : _directories)
+    {
+        candidates.push_back(directory + requestedSource);
+    }
+
+    Request *request = new Request();
+    for (const std::string &candidate : candidates)
+    {
+        request->File = GetIncludeFileCache().Load(candidate);
+        if (request->File != nullptr)
+        {
+            break;
+        }
+    }
+
+    shaderc_include_result &result = request->Result;
+    result.user_data = request;
+    if (request->File == nullptr)
+    {
+        request->ErrorMessage = std::string("Unable to find include file \"") + requestedSource + "\".";
+        result.source_name = "";
+        result.source_name_length = 0;
+        result.content = request->ErrorMessage.c_str();
+        result.content_length = request->ErrorMessage.size();
+        return &result;
+    }
+
+    const IncludeFile &file = *request->File;
+    result.source_name = file.Path.c_str();
+    result.source_name_length = file.Path.size();
+    result.content = file.GetData();
+    result.content_length = static_cast<size_t>(file.Size);
+    if (_includedFileSet.insert(file.Path).second)
+    {
+        _includedFiles.push_back(file.Path);
+    }
+
+    return &result;
+}
+
+void CachedIncluder::ReleaseInclude(shaderc_include_result *data)
+{
+    delete static_cast<Request *>(data->user_data);
+}
+} // namespace Veldrid
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "InteropStructs.hpp"
+#include "MappedFile.hpp"
+#include "shaderc.hpp"
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Veldrid
+{
+struct IncludeFile
+{
+    std::string Path;
+    int64_t ModificationTime = 0;
+    uint64_t Size = 0;
+    std::string Contents;
+    std::unique_ptr<MappedFile> Mapping;
+
+    const char *GetData() const;
+};
+
+// Contents of #include'd files, shared by every compilation in the process. An entry is reused for as
+// long as the file's modification time and size are unchanged, so a header shared by many shaders is
+// only read once.
+class IncludeFileCache
+{
+public:
+    // Returns null if the file does not exist or cannot be read.
+    std::shared_ptr<const IncludeFile> Load(const std::string &path);
+    void SetFileMapping(bool enabled);
+    void Clear();
+
+private:
+    std::mutex _mutex;
+    std::unordered_map<std::string, std::shared_ptr<const IncludeFile>> _files;
+    bool _mapFiles = false;
+};
+
+IncludeFileCache &GetIncludeFileCache();
+
+// Resolves #include directives for a single compilation. Quoted includes are looked up next to the
+// including file first and then in the include directories; angle-bracket includes only in the include
+// directories. Every file that was resolved is recorded.
+class CachedIncluder : public shaderc::CompileOptions::IncluderInterface
+{
+public:
+    CachedIncluder(const InteropArray<InteropArray<char>> &includeDirectories);
+
+    shaderc_include_result *GetInclude(
+        const char *requestedSource,
+        shaderc_include_type type,
+        const char *requestingSource,
+        size_t includeDepth) override;
+    void ReleaseInclude(shaderc_include_result *data) override;
+
+    // The resolved include files in the order they were first included.
+    const std::vector<std::string> &GetIncludedFiles() const { return _includedFiles; }
+
+private:
+    struct Request
+    {
+        shaderc_include_result Result;
+        std::shared_ptr<const IncludeFile> File;
+        std::string ErrorMessage;
+    };
+
+    std::vector<std::string> _directories;
+    std::vector<std::string> _includedFiles;
+    std::set<std::string> _includedFileSet;
+};
+} // namespace Veldrid
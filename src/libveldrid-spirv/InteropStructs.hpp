@@ -1,6 +1,7 @@
 #pragma once
 
 #include "stdint.h"
+#include "Hashing.hpp"
 #include <vector>
 #include "spirv_common.hpp"
 #include "shaderc.hpp"
@@ -118,6 +119,19 @@ enum CrossCompileTarget : uint32_t
 };
 #pragma pack(pop)
 
+// Optimizer passes run over the input modules before they are cross-compiled.
+enum class SpirvOptimization : uint32_t
+{
+    None,
+    // The SPIRV-Tools performance recipe.
+    Performance,
+    // The SPIRV-Tools size recipe.
+    Size,
+    // Bakes the specialization constants into the module, then folds them and removes the code they
+    // make dead.
+    FreezeSpecializations,
+};
+
 #pragma pack(push, 1)
 struct CrossCompileInfo
 {
@@ -129,9 +143,39 @@ struct CrossCompileInfo
     InteropArray<uint32_t> VertexShader;
     InteropArray<uint32_t> FragmentShader;
     InteropArray<uint32_t> ComputeShader;
+    // When set, the reflection data lists only the bindings in use, as SparseBindings, instead of dense
+    // ResourceLayouts padded with unused elements.
+    Bool32 SparseResourceLayouts;
+    SpirvOptimization Optimization;
+    // When set, the generated text has no comments or optional whitespace, and internal identifiers are
+    // shortened. Resource, vertex input and stage interface names are kept.
+    Bool32 MinifyOutput;
+    // When set, vertex outputs which the fragment shader never reads are removed along with the code that
+    // computes them, and the remaining interface is given consecutive locations.
+    Bool32 PruneStageInterface;
 };
 #pragma pack(pop)
 
+// A bitwise copy of an interop struct whose arrays point at memory owned by someone else, such as a
+// mapped file. The copy is cleared before it is destroyed so that InteropArray leaves that memory alone.
+template <typename T>
+struct Borrowed
+{
+    T Value;
+
+    Borrowed() {}
+
+    explicit Borrowed(const T &source)
+    {
+        memcpy(static_cast<void *>(&Value), &source, sizeof(T));
+    }
+
+    ~Borrowed()
+    {
+        memset(static_cast<void *>(&Value), 0, sizeof(T));
+    }
+};
+
 #pragma pack(push, 1)
 struct MacroDefinition
 {
@@ -150,6 +194,14 @@ struct GlslCompileInfo
     shaderc_shader_kind Kind;
     Bool32 Debug;
     InteropArray<MacroDefinition> Macros;
+    InteropArray<InteropArray<char>> IncludeDirectories;
+};
+
+// Options shared by every compilation of a GlslCompilerSession.
+struct GlslSessionInfo
+{
+    Bool32 Debug;
+    InteropArray<MacroDefinition> Macros;
 };
 #pragma pack(pop)
 
@@ -244,31 +296,112 @@ struct ResourceLayoutDescription
     InteropArray<ResourceElementDescription> ResourceElements;
 };
 
+// A resource element together with the slot it is bound to.
+struct SparseResourceBinding
+{
+    uint32_t Set;
+    uint32_t Binding;
+    ResourceElementDescription Element;
+};
+
 struct ReflectionInfo
 {
     InteropArray<VertexElementDescription> VertexElements;
     InteropArray<ResourceLayoutDescription> ResourceLayouts;
+    // Sorted by set, then binding. Only filled in when SparseResourceLayouts was requested, in which case
+    // ResourceLayouts is empty.
+    InteropArray<SparseResourceBinding> SparseBindings;
 };
 
+// Results are laid out in a single block by CreateResult (ResultBuilder.hpp) and must be released with
+// DestroyResult. None of the arrays inside a result own their memory.
 struct CompilationResult
 {
     Bool32 Succeeded;
     InteropArray<InteropArray<uint8_t>> DataBuffers;
     ReflectionInfo Reflection;
+    // Fingerprint of the input SPIR-V modules, which ignores debug-only instructions. Zero when unknown.
+    Hash128 Fingerprint;
 
     CompilationResult()
     {
         Succeeded.Value = 0;
-        DataBuffers.Count = 0;
-        DataBuffers.Data = nullptr;
+        Fingerprint = Hash128();
     }
 
-    CompilationResult(const std::string& errorMessage)
-    {
-        Succeeded.Value = 0;
-        DataBuffers.Resize(1);
-        DataBuffers[0].CopyFrom(static_cast<uint32_t>(errorMessage.length()), (uint8_t*)(errorMessage.c_str()));
-    }
+    ~CompilationResult() = delete;
+};
+
+typedef void (*OutputWriteCallback)(void *userData, uint32_t bufferIndex, const uint8_t *data, uint32_t size);
+
+// Destination for generated shader text. Each output buffer is delivered whole and in buffer order; calls
+// are never made concurrently but may come from a worker thread. When Callback is null the text is written
+// to FileDescriptor instead.
+struct OutputSink
+{
+    OutputWriteCallback Callback;
+    void *UserData;
+    int32_t FileDescriptor;
+};
+
+struct CacheStatistics
+{
+    uint64_t Hits;
+    uint64_t Misses;
+    uint64_t Evictions;
+    uint32_t EntryCount;
+    uint32_t Capacity;
+};
+
+struct PhaseStatistics
+{
+    uint64_t Nanoseconds;
+    uint64_t Calls;
+    uint64_t Bytes;
+};
+
+// Indexed by CompilePhase: GLSL compilation, SPIR-V parsing, resource collection, binding remapping,
+// emission, result marshaling and SPIR-V optimization.
+static const uint32_t CompilePhaseCount = 7;
+
+struct CompileStatistics
+{
+    uint64_t CallCount;
+    PhaseStatistics Phases[CompilePhaseCount];
+};
+
+struct VariantStageSource
+{
+    shaderc_shader_kind Kind;
+    InteropArray<char> SourceText;
+    InteropArray<char> FileName;
+};
+
+// A GLSL vertex-fragment pair or compute shader compiled under every combination of macro axis values.
+// Each axis option is a single macro definition; an option with an empty name leaves the axis undefined.
+struct VariantMatrixInfo
+{
+    InteropArray<VariantStageSource> Stages;
+    Bool32 Debug;
+    InteropArray<MacroDefinition> Macros;
+    InteropArray<InteropArray<MacroDefinition>> Axes;
+    InteropArray<InteropArray<char>> IncludeDirectories;
+    Bool32 FixClipSpaceZ;
+    Bool32 InvertY;
+    Bool32 NormalizeResourceNames;
+    InteropArray<SpecializationConstant> Specializations;
+    InteropArray<CrossCompileTarget> Targets;
+};
+
+// Permutations are numbered with the last axis varying fastest. Permutations whose SPIR-V is identical
+// share one entry in Variants. Each successful variant holds the SPIR-V of every stage, the stage texts
+// of every target, target-major, the paths of the files #include'd by any of its permutations and the
+// reflection data. If the matrix itself is invalid, PermutationVariants is empty and Variants holds a
+// single failed result.
+struct VariantMatrixResult
+{
+    InteropArray<uint32_t> PermutationVariants;
+    InteropArray<CompilationResult *> Variants;
 };
 #pragma pack(pop)
 } // namespace Veldrid
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include "MappedFile.hpp"
+#include <stdexcept>
+#include <stdio.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Veldrid
+{
+#ifdef _WIN32
+std::wstring Utf8ToWide(const std::string &text)
+{
+    if (text.empty())
+    {
+        return std::wstring();
+    }
+
+    int length = MultiByteToWideChar(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), nullptr, 0);
+    std::wstring wide(static_cast<size_t>(length), L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), &wide[0], length);
+    return wide;
+}
+
+NativePath ToNativePath(const std::string &path)
+{
+    return Utf8ToWide(path);
+}
+
+bool RenameFile(const std::string &from, const std::string &to)
+{
+    return _wrename(Utf8ToWide(from).c_str(), Utf8ToWide(to).c_str()) == 0;
+}
+
+bool RemoveFile(const std::string &path)
+{
+    return _wremove(Utf8ToWide(path).c_str()) == 0;
+}
+
+MappedFile::MappedFile(const std::string &path)
+{
+    _file = CreateFileW(
+        Utf8ToWide(path).c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr);
+    if (_file == INVALID_HANDLE_VALUE)
+    {
+        _file = nullptr;
+        throw std::runtime_error("Unable to open file \"" + path + "\".");
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(_file, &size))
+    {
+        CloseHandle(_file);
+        throw std::runtime_error("Unable to get the size of file \"" + path + "\".");
+    }
+
+    _size = static_cast<size_t>(size.QuadPart);
+    if (_size == 0)
+    {
+        return;
+    }
+
+    _mapping = CreateFileMappingW(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void *view = _mapping != nullptr ? MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (view == nullptr)
+    {
+        if (_mapping != nullptr)
+        {
+            CloseHandle(_mapping);
+        }
+        CloseHandle(_file);
+        throw std::runtime_error("Unable to map file \"" + path + "\".");
+    }
+
+    _data = static_cast<const uint8_t *>(view);
+}
+
+MappedFile::~MappedFile()
+{
+    if (_data != nullptr)
+    {
+        UnmapViewOfFile(_data);
+    }
+    if (_mapping != nullptr)
+    {
+        CloseHandle(_mapping);
+    }
+    if (_file != nullptr)
+    {
+        CloseHandle(_file);
+    }
+}
+#else
+NativePath ToNativePath(const std::string &path)
+{
+    return path;
+}
+
+bool RenameFile(const std::string &from, const std::string &to)
+{
+    return rename(from.c_str(), to.c_str()) == 0;
+}
+
+bool RemoveFile(const std::string &path)
+{
+    return remove(path.c_str()) == 0;
+}
+
+MappedFile::MappedFile(const std::string &path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Unable to open file \"" + path + "\".");
+    }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0)
+    {
+        close(fd);
+        throw std::runtime_error("Unable to get the size of file \"" + path + "\".");
+    }
+
+    _size = static_cast<size_t>(fileStat.st_size);
+    if (_size > 0)
+    {
+        void *view = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view == MAP_FAILED)
+        {
+            close(fd);
+            throw std::runtime_error("Unable to map file \"" + path + "\".");
+        }
+
+        _data = static_cast<const uint8_t *>(view);
+    }
+
+    // The mapping stays valid after the descriptor is closed.
+    close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if (_data != nullptr)
+    {
+        munmap(const_cast<uint8_t *>(_data), _size);
+    }
+}
+#endif
+} // namespace Veldrid
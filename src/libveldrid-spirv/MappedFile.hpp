@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+namespace Veldrid
+{
+#ifdef _WIN32
+// Converts a UTF-8 path to the UTF-16 expected by the wide Windows file functions.
+std::wstring Utf8ToWide(const std::string &text);
+#endif
+
+// A UTF-8 path in the form the standard file streams and C file functions expect: UTF-16 on Windows, where
+// narrow paths are read in the ANSI code page, and unchanged elsewhere.
+#ifdef _WIN32
+typedef std::wstring NativePath;
+#else
+typedef std::string NativePath;
+#endif
+NativePath ToNativePath(const std::string &path);
+
+// rename and remove for UTF-8 paths. Both return true on success.
+bool RenameFile(const std::string &from, const std::string &to);
+bool RemoveFile(const std::string &path);
+
+// A read-only view of a whole file, backed by a memory mapping. The path is UTF-8 encoded. Throws
+// std::runtime_error if the file cannot be opened or mapped.
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string &path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const uint8_t *GetData() const { return _data; }
+    size_t GetSize() const { return _size; }
+
+private:
+    const uint8_t *_data = nullptr;
+    size_t _size = 0;
+#ifdef _WIN32
+    void *_file = nullptr;
+    void *_mapping = nullptr;
+#endif
+};
+} // namespace Veldrid
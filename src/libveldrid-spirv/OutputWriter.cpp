@@ -0,0 +1,78 @@
+#include "OutputWriter.hpp"
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace Veldrid
+{
+OutputWriter::OutputWriter(uint32_t bufferCount, const OutputSink *sink)
+    : _sink(sink), _texts(bufferCount), _ready(bufferCount)
+{
+}
+
+void OutputWriter::Submit(uint32_t index, std::string &&text)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _texts[index] = std::move(text);
+    _ready[index] = true;
+    if (_sink == nullptr)
+    {
+        return;
+    }
+
+    while (_nextIndex < _texts.size() && _ready[_nextIndex])
+    {
+        Write(_texts[_nextIndex], _nextIndex);
+        std::string().swap(_texts[_nextIndex]);
+        _nextIndex++;
+    }
+}
+
+std::vector<ByteSpan> OutputWriter::GetDataBuffers() const
+{
+    if (_sink != nullptr)
+    {
+        return std::vector<ByteSpan>();
+    }
+
+    std::vector<ByteSpan> ret(_texts.size());
+    for (size_t i = 0; i < _texts.size(); i++)
+    {
+        ret[i].Data = _texts[i].data();
+        ret[i].Size = _texts[i].size();
+    }
+
+    return ret;
+}
+
+void OutputWriter::Write(const std::string &text, uint32_t index)
+{
+    if (_sink->Callback != nullptr)
+    {
+        _sink->Callback(_sink->UserData, index, reinterpret_cast<const uint8_t *>(text.data()), static_cast<uint32_t>(text.size()));
+        return;
+    }
+
+    const char *data = text.data();
+    size_t remaining = text.size();
+    while (remaining > 0)
+    {
+#ifdef _WIN32
+        int written = _write(_sink->FileDescriptor, data, static_cast<unsigned int>(remaining));
+#else
+        ssize_t written = write(_sink->FileDescriptor, data, remaining);
+#endif
+        if (written <= 0)
+        {
+            throw std::runtime_error("Unable to write the generated shader text to the output file descriptor.");
+        }
+
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+}
+} // namespace Veldrid
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "InteropStructs.hpp"
+#include "ResultBuilder.hpp"
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Veldrid
+{
+// Receives the generated text of each output buffer as soon as its stage has been emitted. Without a
+// sink the texts are kept until the result is built. With a sink each text is written out in buffer
+// order and released straight away, so only the text of stages that finished out of order is held.
+class OutputWriter
+{
+public:
+    OutputWriter(uint32_t bufferCount, const OutputSink *sink);
+
+    void Submit(uint32_t index, std::string &&text);
+
+    // The data buffers for the CompilationResult. When streaming, the texts have already been handed to
+    // the sink and there are none.
+    std::vector<ByteSpan> GetDataBuffers() const;
+
+private:
+    void Write(const std::string &text, uint32_t index);
+
+    const OutputSink *_sink;
+    std::mutex _mutex;
+    std::vector<std::string> _texts;
+    std::vector<bool> _ready;
+    uint32_t _nextIndex = 0;
+};
+} // namespace Veldrid
@@ -0,0 +1,255 @@
+#include "PhaseTimer.hpp"
+#include "Cancellation.hpp"
+#include "MappedFile.hpp"
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace Veldrid
+{
+static const uint32_t PhaseCount = static_cast<uint32_t>(CompilePhase::Count);
+// Spans beyond this are dropped, which bounds the memory of a trace left running by accident.
+static const size_t MaxTraceEvents = 1 << 20;
+
+struct PhaseCounters
+{
+    std::atomic<bool> Enabled;
+    std::atomic<bool> Tracing;
+    std::atomic<uint64_t> CallCount;
+    std::atomic<uint64_t> Nanoseconds[PhaseCount];
+    std::atomic<uint64_t> Calls[PhaseCount];
+    std::atomic<uint64_t> Bytes[PhaseCount];
+};
+
+struct TraceEvent
+{
+    const char *Name;
+    uint32_t ThreadID;
+    uint64_t Start; // Nanoseconds since the trace began.
+    uint64_t Duration;
+    uint64_t Bytes;
+};
+
+struct TraceRecorder
+{
+    std::mutex Mutex;
+    std::chrono::steady_clock::time_point Origin;
+    std::vector<TraceEvent> Events;
+    uint64_t DroppedCount = 0;
+};
+
+// Zero-initialized, as it has static storage duration.
+static PhaseCounters &GetCounters()
+{
+    static PhaseCounters counters;
+    return counters;
+}
+
+static TraceRecorder &GetTraceRecorder()
+{
+    static TraceRecorder recorder;
+    return recorder;
+}
+
+static uint32_t GetTraceThreadID()
+{
+    static std::atomic<uint32_t> nextID(1);
+    thread_local uint32_t id = nextID.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+static uint64_t ToNanoseconds(std::chrono::steady_clock::duration duration)
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+}
+
+static void RecordTraceEvent(
+    const char *name,
+    std::chrono::steady_clock::time_point start,
+    std::chrono::steady_clock::duration duration,
+    uint64_t bytes)
+{
+    uint32_t threadID = GetTraceThreadID();
+    TraceRecorder &recorder = GetTraceRecorder();
+    std::lock_guard<std::mutex> lock(recorder.Mutex);
+    if (!GetCounters().Tracing.load(std::memory_order_relaxed) || start < recorder.Origin)
+    {
+        return;
+    }
+
+    if (recorder.Events.size() >= MaxTraceEvents)
+    {
+        recorder.DroppedCount += 1;
+        return;
+    }
+
+    recorder.Events.push_back({ name, threadID, ToNanoseconds(start - recorder.Origin), ToNanoseconds(duration), bytes });
+}
+
+const char *GetPhaseName(CompilePhase phase)
+{
+    static const char *const Names[PhaseCount] =
+    {
+        "glslCompile",
+        "parse",
+        "collectResources",
+        "remapBindings",
+        "emit",
+        "marshal",
+        "optimize",
+    };
+
+    uint32_t index = static_cast<uint32_t>(phase);
+    return index < PhaseCount ? Names[index] : "unknown";
+}
+
+void SetPhaseTimingEnabled(bool enabled)
+{
+    GetCounters().Enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool IsPhaseTimingEnabled()
+{
+    return GetCounters().Enabled.load(std::memory_order_relaxed);
+}
+
+void GetPhaseTimings(CompileStatistics &stats)
+{
+    PhaseCounters &counters = GetCounters();
+    stats.CallCount = counters.CallCount.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < PhaseCount; i++)
+    {
+        stats.Phases[i].Nanoseconds = counters.Nanoseconds[i].load(std::memory_order_relaxed);
+        stats.Phases[i].Calls = counters.Calls[i].load(std::memory_order_relaxed);
+        stats.Phases[i].Bytes = counters.Bytes[i].load(std::memory_order_relaxed);
+    }
+}
+
+void ResetPhaseTimings()
+{
+    PhaseCounters &counters = GetCounters();
+    counters.CallCount.store(0, std::memory_order_relaxed);
+    for (uint32_t i = 0; i < PhaseCount; i++)
+    {
+        counters.Nanoseconds[i].store(0, std::memory_order_relaxed);
+        counters.Calls[i].store(0, std::memory_order_relaxed);
+        counters.Bytes[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void BeginPhaseTrace()
+{
+    TraceRecorder &recorder = GetTraceRecorder();
+    std::lock_guard<std::mutex> lock(recorder.Mutex);
+    recorder.Origin = std::chrono::steady_clock::now();
+    recorder.Events.clear();
+    recorder.DroppedCount = 0;
+    GetCounters().Tracing.store(true, std::memory_order_relaxed);
+    SetPhaseTimingEnabled(true);
+}
+
+void EndPhaseTrace(const std::string &path)
+{
+    std::vector<TraceEvent> events;
+    uint64_t droppedCount;
+    {
+        TraceRecorder &recorder = GetTraceRecorder();
+        std::lock_guard<std::mutex> lock(recorder.Mutex);
+        GetCounters().Tracing.store(false, std::memory_order_relaxed);
+        events.swap(recorder.Events);
+        droppedCount = recorder.DroppedCount;
+    }
+
+    std::ofstream file(ToNativePath(path).c_str());
+    if (!file)
+    {
+        throw std::runtime_error("Unable to open the trace file " + path + ".");
+    }
+
+    // Timestamps are in microseconds; three decimals keep nanosecond precision.
+    file << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":" << droppedCount << "},\"traceEvents\":[";
+    file.setf(std::ios::fixed);
+    file.precision(3);
+    for (size_t i = 0; i < events.size(); i++)
+    {
+        const TraceEvent &event = events[i];
+        file << (i == 0 ? "\n" : ",\n");
+        file << "{\"name\":\"" << event.Name << "\",\"cat\":\"veldrid-spirv\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+             << event.ThreadID << ",\"ts\":" << event.Start / 1000.0 << ",\"dur\":" << event.Duration / 1000.0
+             << ",\"args\":{\"bytes\":" << event.Bytes << "}}";
+    }
+    file << "\n]}\n";
+    if (!file)
+    {
+        throw std::runtime_error("Unable to write the trace file " + path + ".");
+    }
+}
+
+PhaseTimer::PhaseTimer(CompilePhase phase)
+{
+    Start(phase);
+}
+
+void PhaseTimer::Start(CompilePhase phase)
+{
+    // Marshalling also builds the error results of failed and cancelled compilations, so it must not throw.
+    if (phase != CompilePhase::Marshal)
+    {
+        ThrowIfCancelled();
+    }
+
+    _phase = phase;
+    _bytes = 0;
+    _running = IsPhaseTimingEnabled();
+    if (_running)
+    {
+        _start = std::chrono::steady_clock::now();
+    }
+}
+
+void PhaseTimer::Switch(CompilePhase phase)
+{
+    Stop();
+    Start(phase);
+}
+
+void PhaseTimer::Stop()
+{
+    if (!_running)
+    {
+        return;
+    }
+
+    _running = false;
+    std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - _start;
+    uint32_t index = static_cast<uint32_t>(_phase);
+    PhaseCounters &counters = GetCounters();
+    counters.Nanoseconds[index].fetch_add(ToNanoseconds(elapsed), std::memory_order_relaxed);
+    counters.Calls[index].fetch_add(1, std::memory_order_relaxed);
+    counters.Bytes[index].fetch_add(_bytes, std::memory_order_relaxed);
+    if (counters.Tracing.load(std::memory_order_relaxed))
+    {
+        RecordTraceEvent(GetPhaseName(_phase), _start, elapsed, _bytes);
+    }
+}
+
+CallTimer::CallTimer(const char *name)
+    : _name(name), _running(IsPhaseTimingEnabled())
+{
+    if (_running)
+    {
+        GetCounters().CallCount.fetch_add(1, std::memory_order_relaxed);
+        _start = std::chrono::steady_clock::now();
+    }
+}
+
+CallTimer::~CallTimer()
+{
+    if (_running && GetCounters().Tracing.load(std::memory_order_relaxed))
+    {
+        RecordTraceEvent(_name, _start, std::chrono::steady_clock::now() - _start, 0);
+    }
+}
+} // namespace Veldrid
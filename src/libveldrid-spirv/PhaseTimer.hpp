@@ -0,0 +1,81 @@
+#pragma once
+
+#include "InteropStructs.hpp"
+#include <chrono>
+#include <stdint.h>
+#include <string>
+
+namespace Veldrid
+{
+enum class CompilePhase : uint32_t
+{
+    GlslCompile,
+    Parse,
+    CollectResources,
+    RemapBindings,
+    Emit,
+    Marshal,
+    Optimize,
+    Count,
+};
+
+static_assert(static_cast<uint32_t>(CompilePhase::Count) == CompilePhaseCount, "CompileStatistics is out of date.");
+
+const char *GetPhaseName(CompilePhase phase);
+
+// Phase timing is off by default; a disabled PhaseTimer only checks a flag. The totals are process-wide
+// and summed over all threads.
+void SetPhaseTimingEnabled(bool enabled);
+bool IsPhaseTimingEnabled();
+void GetPhaseTimings(CompileStatistics &stats);
+void ResetPhaseTimings();
+
+// While a trace is being recorded, every call and phase is also kept as a span. EndPhaseTrace writes them
+// as Chrome trace event JSON, which chrome://tracing and Perfetto can load, and discards them. Recording a
+// trace turns phase timing on.
+void BeginPhaseTrace();
+void EndPhaseTrace(const std::string &path);
+
+// Attributes the time between its construction and destruction to a phase. Switch() ends the current
+// phase and starts the next one, for functions which run several phases in sequence. Starting a phase
+// throws CompilationCancelled if the current compilation was cancelled.
+class PhaseTimer
+{
+public:
+    explicit PhaseTimer(CompilePhase phase);
+    ~PhaseTimer() { Stop(); }
+
+    PhaseTimer(const PhaseTimer &) = delete;
+    PhaseTimer &operator=(const PhaseTimer &) = delete;
+
+    // Adds to the number of bytes processed by the current phase.
+    void AddBytes(uint64_t bytes) { _bytes += bytes; }
+    void Switch(CompilePhase phase);
+    void Stop();
+
+private:
+    void Start(CompilePhase phase);
+
+    bool _running;
+    CompilePhase _phase;
+    uint64_t _bytes;
+    std::chrono::steady_clock::time_point _start;
+};
+
+// Counts one call of an exported entry point and, while tracing, records it as a span enclosing the
+// phases it runs. The name must be a string literal.
+class CallTimer
+{
+public:
+    explicit CallTimer(const char *name);
+    ~CallTimer();
+
+    CallTimer(const CallTimer &) = delete;
+    CallTimer &operator=(const CallTimer &) = delete;
+
+private:
+    const char *_name;
+    bool _running;
+    std::chrono::steady_clock::time_point _start;
+};
+} // namespace Veldrid
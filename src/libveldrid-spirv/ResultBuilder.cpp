@@ -0,0 +1,225 @@
+#include "ResultBuilder.hpp"
+#include "PhaseTimer.hpp"
+#include <new>
+#include <stdlib.h>
+
+namespace Veldrid
+{
+static const size_t TableAlignment = 8;
+
+static size_t AlignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// Hands out consecutive pieces of a single block. The same sequence of calls is used to size the block
+// and then to fill it.
+class ArenaLayout
+{
+public:
+    explicit ArenaLayout(uint8_t *base) : _base(base) {}
+
+    void *Allocate(size_t size, size_t alignment)
+    {
+        _offset = AlignUp(_offset, alignment);
+        void *ret = _base + _offset;
+        _offset += size;
+        return ret;
+    }
+
+    template <typename T>
+    T *AllocateArray(size_t count)
+    {
+        T *ret = static_cast<T *>(Allocate(count * sizeof(T), TableAlignment));
+        for (size_t i = 0; i < count; i++)
+        {
+            new (&ret[i]) T();
+        }
+        return ret;
+    }
+
+    size_t GetOffset() const { return _offset; }
+
+private:
+    uint8_t *_base;
+    size_t _offset = 0;
+};
+
+template <typename T>
+static void SetArray(InteropArray<T> &array, T *data, size_t count)
+{
+    array.Count = static_cast<uint32_t>(count);
+    array.Data = count > 0 ? data : nullptr;
+}
+
+static void CopyString(ArenaLayout &arena, InteropArray<char> &target, const std::string &value)
+{
+    char *data = static_cast<char *>(arena.Allocate(value.size(), 1));
+    memcpy(data, value.data(), value.size());
+    SetArray(target, data, value.size());
+}
+
+static void CopyElement(ArenaLayout &arena, ResourceElementDescription &target, const ResourceElementInfo &source)
+{
+    CopyString(arena, target.Name, source.Name);
+    target.Kind = source.Kind;
+    target.Stages = source.Stages;
+    target.Options = source.Options;
+}
+
+static size_t MeasureResult(const ByteSpan *dataBuffers, uint32_t dataBufferCount, const ReflectionData &reflection)
+{
+    size_t elementCount = 0;
+    for (auto &layout : reflection.ResourceLayouts)
+    {
+        elementCount += layout.size();
+    }
+
+    size_t size = AlignUp(sizeof(CompilationResult), TableAlignment);
+    size += AlignUp(dataBufferCount * sizeof(InteropArray<uint8_t>), TableAlignment);
+    size += AlignUp(reflection.VertexElements.size() * sizeof(VertexElementDescription), TableAlignment);
+    size += AlignUp(reflection.ResourceLayouts.size() * sizeof(ResourceLayoutDescription), TableAlignment);
+    size += AlignUp(elementCount * sizeof(ResourceElementDescription), TableAlignment);
+    size += AlignUp(reflection.SparseBindings.size() * sizeof(SparseResourceBinding), TableAlignment);
+
+    for (uint32_t i = 0; i < dataBufferCount; i++)
+    {
+        size += AlignUp(dataBuffers[i].Size, TableAlignment);
+    }
+    for (auto &element : reflection.VertexElements)
+    {
+        size += element.Name.size();
+    }
+    for (auto &layout : reflection.ResourceLayouts)
+    {
+        for (auto &element : layout)
+        {
+            size += element.Name.size();
+        }
+    }
+    for (auto &binding : reflection.SparseBindings)
+    {
+        size += binding.Element.Name.size();
+    }
+
+    return size;
+}
+
+CompilationResult *CreateResult(const ByteSpan *dataBuffers, uint32_t dataBufferCount, const ReflectionData *reflection)
+{
+    PhaseTimer timer(CompilePhase::Marshal);
+    static const ReflectionData emptyReflection;
+    const ReflectionData &refl = reflection != nullptr ? *reflection : emptyReflection;
+
+    size_t elementCount = 0;
+    for (auto &layout : refl.ResourceLayouts)
+    {
+        elementCount += layout.size();
+    }
+
+    size_t size = MeasureResult(dataBuffers, dataBufferCount, refl);
+    timer.AddBytes(size);
+    uint8_t *block = static_cast<uint8_t *>(malloc(size));
+    if (block == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    ArenaLayout arena(block);
+    CompilationResult *result = arena.AllocateArray<CompilationResult>(1);
+    InteropArray<uint8_t> *buffers = arena.AllocateArray<InteropArray<uint8_t>>(dataBufferCount);
+    VertexElementDescription *vertexElements =
+        arena.AllocateArray<VertexElementDescription>(refl.VertexElements.size());
+    ResourceLayoutDescription *layouts = arena.AllocateArray<ResourceLayoutDescription>(refl.ResourceLayouts.size());
+    ResourceElementDescription *elements = arena.AllocateArray<ResourceElementDescription>(elementCount);
+    SparseResourceBinding *sparseBindings = arena.AllocateArray<SparseResourceBinding>(refl.SparseBindings.size());
+
+    result->Succeeded = true;
+    SetArray(result->DataBuffers, buffers, dataBufferCount);
+    SetArray(result->Reflection.VertexElements, vertexElements, refl.VertexElements.size());
+    SetArray(result->Reflection.ResourceLayouts, layouts, refl.ResourceLayouts.size());
+    SetArray(result->Reflection.SparseBindings, sparseBindings, refl.SparseBindings.size());
+
+    // Buffer contents come first in the pool so that they keep the table alignment.
+    for (uint32_t i = 0; i < dataBufferCount; i++)
+    {
+        uint8_t *data = static_cast<uint8_t *>(arena.Allocate(dataBuffers[i].Size, TableAlignment));
+        memcpy(data, dataBuffers[i].Data, dataBuffers[i].Size);
+        buffers[i].Count = static_cast<uint32_t>(dataBuffers[i].Size);
+        buffers[i].Data = data;
+    }
+
+    for (size_t i = 0; i < refl.VertexElements.size(); i++)
+    {
+        const VertexElementInfo &source = refl.VertexElements[i];
+        CopyString(arena, vertexElements[i].Name, source.Name);
+        vertexElements[i].Semantic = source.Semantic;
+        vertexElements[i].Format = source.Format;
+        vertexElements[i].Offset = source.Offset;
+    }
+
+    ResourceElementDescription *nextElement = elements;
+    for (size_t i = 0; i < refl.ResourceLayouts.size(); i++)
+    {
+        const std::vector<ResourceElementInfo> &sourceLayout = refl.ResourceLayouts[i];
+        SetArray(layouts[i].ResourceElements, nextElement, sourceLayout.size());
+        for (const ResourceElementInfo &source : sourceLayout)
+        {
+            CopyElement(arena, *nextElement, source);
+            nextElement++;
+        }
+    }
+
+    for (size_t i = 0; i < refl.SparseBindings.size(); i++)
+    {
+        const SparseBindingInfo &source = refl.SparseBindings[i];
+        sparseBindings[i].Set = source.Set;
+        sparseBindings[i].Binding = source.Binding;
+        CopyElement(arena, sparseBindings[i].Element, source.Element);
+    }
+
+    assert(arena.GetOffset() <= size);
+    return result;
+}
+
+CompilationResult *CreateResult(const std::vector<std::string> &dataBuffers, const ReflectionData &reflection)
+{
+    std::vector<ByteSpan> spans(dataBuffers.size());
+    for (size_t i = 0; i < dataBuffers.size(); i++)
+    {
+        spans[i].Data = dataBuffers[i].data();
+        spans[i].Size = dataBuffers[i].size();
+    }
+
+    return CreateResult(spans.data(), static_cast<uint32_t>(spans.size()), &reflection);
+}
+
+CompilationResult *CreateErrorResult(const std::string &errorMessage)
+{
+    ByteSpan message = { errorMessage.data(), errorMessage.size() };
+    CompilationResult *result = CreateResult(&message, 1, nullptr);
+    result->Succeeded = false;
+    return result;
+}
+
+CompilationResult *CreateErrorResult(const std::string &errorMessage, const std::vector<std::string> &includedFiles)
+{
+    std::vector<ByteSpan> dataBuffers;
+    dataBuffers.reserve(1 + includedFiles.size());
+    dataBuffers.push_back({ errorMessage.data(), errorMessage.size() });
+    for (const std::string &path : includedFiles)
+    {
+        dataBuffers.push_back({ path.data(), path.size() });
+    }
+
+    CompilationResult *result = CreateResult(dataBuffers.data(), static_cast<uint32_t>(dataBuffers.size()), nullptr);
+    result->Succeeded = false;
+    return result;
+}
+
+void DestroyResult(CompilationResult *result)
+{
+    // Nothing inside the block owns memory of its own, so no destructors need to run.
+    free(result);
+}
+} // namespace Veldrid
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "InteropStructs.hpp"
+#include <string>
+#include <vector>
+
+namespace Veldrid
+{
+struct VertexElementInfo
+{
+    std::string Name;
+    VertexElementSemantic Semantic = VertexElementSemantic::Position;
+    VertexElementFormat Format = VertexElementFormat::Float1;
+    uint32_t Offset = 0;
+};
+
+struct ResourceElementInfo
+{
+    std::string Name;
+    ResourceKind Kind = ResourceKind::UniformBuffer;
+    ShaderStages Stages = ShaderStages::None;
+    uint32_t Options = 0;
+};
+
+struct SparseBindingInfo
+{
+    uint32_t Set = 0;
+    uint32_t Binding = 0;
+    ResourceElementInfo Element;
+};
+
+// Reflection data gathered during compilation, before it is flattened into a CompilationResult.
+struct ReflectionData
+{
+    std::vector<VertexElementInfo> VertexElements;
+    std::vector<std::vector<ResourceElementInfo>> ResourceLayouts;
+    std::vector<SparseBindingInfo> SparseBindings;
+};
+
+struct ByteSpan
+{
+    const void *Data;
+    size_t Size;
+};
+
+// Builds a successful CompilationResult in a single allocation. The result header is followed by the
+// DataBuffers table, the reflection tables and finally a pool holding the buffer contents and all
+// names. Every InteropArray in the result points into the same block, which is released as a whole by
+// DestroyResult.
+CompilationResult *CreateResult(const ByteSpan *dataBuffers, uint32_t dataBufferCount, const ReflectionData *reflection);
+CompilationResult *CreateResult(const std::vector<std::string> &dataBuffers, const ReflectionData &reflection);
+CompilationResult *CreateErrorResult(const std::string &errorMessage);
+// Builds a failed CompilationResult whose message is followed by the paths of the include files read before
+// the error, one per data buffer, so that callers can still track what the failed compilation depended on.
+CompilationResult *CreateErrorResult(const std::string &errorMessage, const std::vector<std::string> &includedFiles);
+void DestroyResult(CompilationResult *result);
+} // namespace Veldrid
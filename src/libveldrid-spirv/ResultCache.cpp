@@ -0,0 +1,178 @@
+#include "ResultCache.hpp"
+#include "ResultBuilder.hpp"
+
+namespace Veldrid
+{
+static void AppendArray(std::vector<uint32_t> &words, const InteropArray<uint32_t> &array)
+{
+    words.push_back(array.Count);
+    words.insert(words.end(), array.Data, array.Data + array.Count);
+}
+
+ResultCacheKey CreateCacheKey(const CrossCompileInfo &info)
+{
+    ResultCacheKey key;
+    std::vector<uint32_t> &words = key.Words;
+    words.reserve(
+        12
+        + info.Specializations.Count * 3
+        + info.VertexShader.Count
+        + info.FragmentShader.Count
+        + info.ComputeShader.Count);
+
+    words.push_back(info.Target);
+    words.push_back(info.FixClipSpaceZ.Value);
+    words.push_back(info.InvertY.Value);
+    words.push_back(info.NormalizeResourceNames.Value);
+    words.push_back(info.SparseResourceLayouts.Value);
+    words.push_back(static_cast<uint32_t>(info.Optimization));
+    words.push_back(info.MinifyOutput.Value);
+    words.push_back(info.PruneStageInterface.Value);
+
+    words.push_back(info.Specializations.Count);
+    for (uint32_t i = 0; i < info.Specializations.Count; i++)
+    {
+        const SpecializationConstant &specialization = info.Specializations[i];
+        words.push_back(specialization.ID);
+        words.push_back(static_cast<uint32_t>(specialization.Constant));
+        words.push_back(static_cast<uint32_t>(specialization.Constant >> 32));
+    }
+
+    AppendArray(words, info.VertexShader);
+    AppendArray(words, info.FragmentShader);
+    AppendArray(words, info.ComputeShader);
+
+    key.Hash = HashBytes(words.data(), words.size() * sizeof(uint32_t));
+    return key;
+}
+
+ResultCache::~ResultCache()
+{
+    for (auto &it : _referenceCounts)
+    {
+        DestroyResult(const_cast<CompilationResult *>(it.first));
+    }
+}
+
+void ResultCache::SetCapacity(uint32_t capacity)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _capacity = capacity;
+    EvictToCapacity();
+}
+
+bool ResultCache::IsEnabled()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _capacity > 0;
+}
+
+void ResultCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto &entry : _entries)
+    {
+        ReleaseReference(entry.Result);
+    }
+
+    _entries.clear();
+    _lookup.clear();
+    _hits = 0;
+    _misses = 0;
+    _evictions = 0;
+}
+
+void ResultCache::GetStatistics(CacheStatistics &stats)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    stats.Hits = _hits;
+    stats.Misses = _misses;
+    stats.Evictions = _evictions;
+    stats.EntryCount = static_cast<uint32_t>(_entries.size());
+    stats.Capacity = _capacity;
+}
+
+CompilationResult *ResultCache::Find(const ResultCacheKey &key)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _lookup.find(key);
+    if (it == _lookup.end())
+    {
+        _misses += 1;
+        return nullptr;
+    }
+
+    _hits += 1;
+    _entries.splice(_entries.begin(), _entries, it->second);
+    CompilationResult *result = it->second->Result;
+    _referenceCounts[result] += 1;
+    return result;
+}
+
+CompilationResult *ResultCache::Insert(ResultCacheKey &&key, CompilationResult *result)
+{
+    if (!result->Succeeded)
+    {
+        return result;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_capacity == 0)
+    {
+        return result;
+    }
+
+    auto pair = _lookup.emplace(std::move(key), _entries.end());
+    if (!pair.second)
+    {
+        // Another thread finished the same compilation first; keep the caller's copy private.
+        return result;
+    }
+
+    _entries.push_front(Entry { &pair.first->first, result });
+    pair.first->second = _entries.begin();
+    _referenceCounts[result] = 2; // One for the cache, one for the caller.
+    EvictToCapacity();
+    return result;
+}
+
+bool ResultCache::Release(CompilationResult *result)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_referenceCounts.find(result) == _referenceCounts.end())
+    {
+        return false;
+    }
+
+    ReleaseReference(result);
+    return true;
+}
+
+void ResultCache::EvictToCapacity()
+{
+    while (_entries.size() > _capacity)
+    {
+        Entry &entry = _entries.back();
+        _lookup.erase(_lookup.find(*entry.Key));
+        ReleaseReference(entry.Result);
+        _entries.pop_back();
+        _evictions += 1;
+    }
+}
+
+void ResultCache::ReleaseReference(CompilationResult *result)
+{
+    auto it = _referenceCounts.find(result);
+    if (--it->second == 0)
+    {
+        _referenceCounts.erase(it);
+        DestroyResult(result);
+    }
+}
+
+ResultCache &GetCrossCompileCache()
+{
+    static ResultCache cache;
+    return cache;
+}
+} // namespace Veldrid
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "InteropStructs.hpp"
+#include "Hashing.hpp"
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Veldrid
+{
+struct ResultCacheKey
+{
+    std::vector<uint32_t> Words;
+    Hash128 Hash;
+
+    bool operator==(const ResultCacheKey &other) const { return Hash == other.Hash && Words == other.Words; }
+};
+
+struct ResultCacheKeyHasher
+{
+    size_t operator()(const ResultCacheKey &key) const { return static_cast<size_t>(key.Hash.Low); }
+};
+
+ResultCacheKey CreateCacheKey(const CrossCompileInfo &info);
+
+// A size-bounded LRU cache of successful CompilationResults. Results handed out by the cache are
+// shared between callers and reference-counted; they must be returned through Release() rather
+// than deleted directly.
+class ResultCache
+{
+public:
+    ~ResultCache();
+
+    void SetCapacity(uint32_t capacity);
+    bool IsEnabled();
+    void Clear();
+    void GetStatistics(CacheStatistics &stats);
+
+    // Returns an acquired reference to the cached result for the given key, or nullptr on a miss.
+    CompilationResult *Find(const ResultCacheKey &key);
+    // Stores the given result and returns it with an acquired reference. Failed results are not stored.
+    CompilationResult *Insert(ResultCacheKey &&key, CompilationResult *result);
+    // Returns false if the result is not owned by the cache, in which case the caller must free it.
+    bool Release(CompilationResult *result);
+
+private:
+    struct Entry
+    {
+        const ResultCacheKey *Key; // Owned by _lookup.
+        CompilationResult *Result;
+    };
+
+    void EvictToCapacity();
+    void ReleaseReference(CompilationResult *result);
+
+    std::mutex _mutex;
+    uint32_t _capacity = 0;
+    std::list<Entry> _entries; // Most recently used first.
+    std::unordered_map<ResultCacheKey, std::list<Entry>::iterator, ResultCacheKeyHasher> _lookup;
+    std::unordered_map<const CompilationResult *, uint32_t> _referenceCounts;
+    uint64_t _hits = 0;
+    uint64_t _misses = 0;
+    uint64_t _evictions = 0;
+};
+
+ResultCache &GetCrossCompileCache();
+} // namespace Veldrid
@@ -0,0 +1,423 @@
+#include "ShaderBundle.hpp"
+#include "BundleCompression.hpp"
+#include "CrossCompile.hpp"
+#include <fstream>
+#include <stdexcept>
+
+namespace Veldrid
+{
+static const size_t TableAlignment = 8;
+
+static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static uint32_t GetSlotCount(size_t entryCount)
+{
+    // At most half full, so that probe sequences stay short.
+    uint32_t slotCount = 1;
+    while (slotCount < entryCount * 2)
+    {
+        slotCount *= 2;
+    }
+    return slotCount;
+}
+
+ShaderBundleWriter::PendingBlob ShaderBundleWriter::CreateBlob(
+    uint32_t target,
+    ShaderStages stage,
+    const uint8_t *data,
+    size_t size) const
+{
+    PendingBlob blob;
+    blob.Record = ShaderBundleBlob();
+    blob.Record.Target = target;
+    blob.Record.Stage = static_cast<uint32_t>(stage);
+    blob.Record.Encoding = ShaderBundleEncoding::Stored;
+    blob.Record.DecodedSize = size;
+    if (_compress && size > 0)
+    {
+        blob.Data = CompressBlock(data, size);
+        if (blob.Data.size() < size)
+        {
+            blob.Record.Encoding = ShaderBundleEncoding::Compressed;
+            blob.Record.Size = blob.Data.size();
+            return blob;
+        }
+    }
+
+    blob.Data.assign(data, data + size);
+    blob.Record.Size = size;
+    return blob;
+}
+
+uint32_t ShaderBundleWriter::AddString(const char *data, size_t size)
+{
+    if (_strings.size() + size > UINT32_MAX)
+    {
+        throw std::runtime_error("The shader bundle string pool is too large.");
+    }
+
+    uint32_t offset = static_cast<uint32_t>(_strings.size());
+    _strings.append(data, size);
+    return offset;
+}
+
+void ShaderBundleWriter::AddVariant(
+    const std::string &key,
+    const CrossCompileInfo &info,
+    const CrossCompileTarget *targets,
+    uint32_t targetCount,
+    const CompilationResult &result)
+{
+    uint32_t stageCount = GetStageCount(info);
+    const InteropArray<uint32_t> *modules[2] = { &info.VertexShader, &info.FragmentShader };
+    ShaderStages stages[2] = { ShaderStages::Vertex, ShaderStages::Fragment };
+    if (stageCount == 1)
+    {
+        modules[0] = &info.ComputeShader;
+        stages[0] = ShaderStages::Compute;
+    }
+    if (stageCount == 0 || result.DataBuffers.Count != stageCount * targetCount)
+    {
+        throw std::runtime_error("The compilation result does not match the given shaders and targets.");
+    }
+
+    // Compression happens outside the lock; only the bookkeeping is serialized.
+    PendingVariant variant;
+    for (uint32_t stage = 0; stage < stageCount; stage++)
+    {
+        variant.Blobs.push_back(CreateBlob(
+            ShaderBundleSpirvTarget,
+            stages[stage],
+            reinterpret_cast<const uint8_t *>(modules[stage]->Data),
+            modules[stage]->SizeInBytes()));
+    }
+    for (uint32_t target = 0; target < targetCount; target++)
+    {
+        for (uint32_t stage = 0; stage < stageCount; stage++)
+        {
+            const InteropArray<uint8_t> &text = result.DataBuffers[target * stageCount + stage];
+            variant.Blobs.push_back(CreateBlob(targets[target], stages[stage], text.Data, text.Count));
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_variants.find(key) != _variants.end())
+    {
+        throw std::runtime_error("The shader bundle already contains a variant named \"" + key + "\".");
+    }
+
+    const ReflectionInfo &reflection = result.Reflection;
+    for (uint32_t i = 0; i < reflection.VertexElements.Count; i++)
+    {
+        const VertexElementDescription &source = reflection.VertexElements[i];
+        ShaderBundleVertexElement element = ShaderBundleVertexElement();
+        element.NameOffset = AddString(source.Name.Data, source.Name.Count);
+        element.NameLength = source.Name.Count;
+        element.Semantic = source.Semantic;
+        element.Format = source.Format;
+        element.Offset = source.Offset;
+        variant.VertexElements.push_back(element);
+    }
+
+    auto addResourceElement = [&](uint32_t set, uint32_t binding, const ResourceElementDescription &source)
+    {
+        ShaderBundleResourceElement element = ShaderBundleResourceElement();
+        element.Set = set;
+        element.Binding = binding;
+        element.NameOffset = AddString(source.Name.Data, source.Name.Count);
+        element.NameLength = source.Name.Count;
+        element.Kind = source.Kind;
+        element.Stages = source.Stages;
+        element.Options = source.Options;
+        variant.ResourceElements.push_back(element);
+    };
+    for (uint32_t set = 0; set < reflection.ResourceLayouts.Count; set++)
+    {
+        const ResourceLayoutDescription &layout = reflection.ResourceLayouts[set];
+        for (uint32_t binding = 0; binding < layout.ResourceElements.Count; binding++)
+        {
+            addResourceElement(set, binding, layout.ResourceElements[binding]);
+        }
+    }
+    for (uint32_t i = 0; i < reflection.SparseBindings.Count; i++)
+    {
+        const SparseResourceBinding &binding = reflection.SparseBindings[i];
+        addResourceElement(binding.Set, binding.Binding, binding.Element);
+    }
+
+    ShaderBundleEntry &entry = variant.Record;
+    entry = ShaderBundleEntry();
+    entry.KeyHash = HashBytes(key.data(), key.size());
+    entry.KeyOffset = AddString(key.data(), key.size());
+    entry.KeyLength = static_cast<uint32_t>(key.size());
+    entry.ResourceLayoutCount = reflection.ResourceLayouts.Count;
+    entry.SparseResourceLayouts = info.SparseResourceLayouts;
+    _variants.emplace(key, std::move(variant));
+}
+
+template <typename T>
+static void CopyTable(std::vector<uint8_t> &file, uint64_t offset, const std::vector<T> &table)
+{
+    if (!table.empty())
+    {
+        memcpy(file.data() + offset, table.data(), table.size() * sizeof(T));
+    }
+}
+
+void ShaderBundleWriter::Write(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::vector<uint32_t> slots(GetSlotCount(_variants.size()), 0);
+    std::vector<ShaderBundleEntry> entries;
+    std::vector<ShaderBundleBlob> blobs;
+    std::vector<ShaderBundleVertexElement> vertexElements;
+    std::vector<ShaderBundleResourceElement> resourceElements;
+    for (auto &it : _variants)
+    {
+        PendingVariant &variant = it.second;
+        ShaderBundleEntry entry = variant.Record;
+        entry.FirstBlob = static_cast<uint32_t>(blobs.size());
+        entry.BlobCount = static_cast<uint32_t>(variant.Blobs.size());
+        entry.FirstVertexElement = static_cast<uint32_t>(vertexElements.size());
+        entry.VertexElementCount = static_cast<uint32_t>(variant.VertexElements.size());
+        entry.FirstResourceElement = static_cast<uint32_t>(resourceElements.size());
+        entry.ResourceElementCount = static_cast<uint32_t>(variant.ResourceElements.size());
+
+        uint32_t slot = static_cast<uint32_t>(entry.KeyHash.Low) & (static_cast<uint32_t>(slots.size()) - 1);
+        while (slots[slot] != 0)
+        {
+            slot = (slot + 1) & (static_cast<uint32_t>(slots.size()) - 1);
+        }
+        slots[slot] = static_cast<uint32_t>(entries.size()) + 1;
+
+        entries.push_back(entry);
+        for (PendingBlob &blob : variant.Blobs)
+        {
+            blobs.push_back(blob.Record);
+        }
+        vertexElements.insert(vertexElements.end(), variant.VertexElements.begin(), variant.VertexElements.end());
+        resourceElements.insert(resourceElements.end(), variant.ResourceElements.begin(), variant.ResourceElements.end());
+    }
+
+    ShaderBundleHeader header = ShaderBundleHeader();
+    header.Magic = ShaderBundleMagic;
+    header.Version = ShaderBundleVersion;
+    header.SlotCount = static_cast<uint32_t>(slots.size());
+    header.EntryCount = static_cast<uint32_t>(entries.size());
+    header.BlobCount = static_cast<uint32_t>(blobs.size());
+    header.VertexElementCount = static_cast<uint32_t>(vertexElements.size());
+    header.ResourceElementCount = static_cast<uint32_t>(resourceElements.size());
+    header.SlotsOffset = AlignUp(sizeof(ShaderBundleHeader), TableAlignment);
+    header.EntriesOffset = AlignUp(header.SlotsOffset + slots.size() * sizeof(uint32_t), TableAlignment);
+    header.BlobsOffset = AlignUp(header.EntriesOffset + entries.size() * sizeof(ShaderBundleEntry), TableAlignment);
+    header.VertexElementsOffset = AlignUp(header.BlobsOffset + blobs.size() * sizeof(ShaderBundleBlob), TableAlignment);
+    header.ResourceElementsOffset = AlignUp(
+        header.VertexElementsOffset + vertexElements.size() * sizeof(ShaderBundleVertexElement),
+        TableAlignment);
+    header.StringsOffset = AlignUp(
+        header.ResourceElementsOffset + resourceElements.size() * sizeof(ShaderBundleResourceElement),
+        TableAlignment);
+    header.StringsSize = _strings.size();
+
+    // Blob contents keep the table alignment, so that SPIR-V can be used as words straight from the mapping.
+    uint64_t offset = header.StringsOffset + header.StringsSize;
+    for (ShaderBundleBlob &blob : blobs)
+    {
+        offset = AlignUp(offset, TableAlignment);
+        blob.Offset = offset;
+        offset += blob.Size;
+    }
+    header.FileSize = offset;
+
+    std::vector<uint8_t> file(static_cast<size_t>(header.FileSize), 0);
+    memcpy(file.data(), &header, sizeof(header));
+    CopyTable(file, header.SlotsOffset, slots);
+    CopyTable(file, header.EntriesOffset, entries);
+    CopyTable(file, header.BlobsOffset, blobs);
+    CopyTable(file, header.VertexElementsOffset, vertexElements);
+    CopyTable(file, header.ResourceElementsOffset, resourceElements);
+    memcpy(file.data() + header.StringsOffset, _strings.data(), _strings.size());
+    size_t blobIndex = 0;
+    for (auto &it : _variants)
+    {
+        for (PendingBlob &blob : it.second.Blobs)
+        {
+            if (!blob.Data.empty())
+            {
+                memcpy(file.data() + blobs[blobIndex].Offset, blob.Data.data(), blob.Data.size());
+            }
+            blobIndex++;
+        }
+    }
+
+    std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream stream(ToNativePath(temporaryPath).c_str(), std::ios::binary | std::ios::trunc);
+        stream.write(reinterpret_cast<const char *>(file.data()), file.size());
+        if (!stream.good())
+        {
+            stream.close();
+            RemoveFile(temporaryPath);
+            throw std::runtime_error("Unable to write shader bundle \"" + path + "\".");
+        }
+    }
+
+    // rename does not replace existing files on Windows.
+    RemoveFile(path);
+    if (!RenameFile(temporaryPath, path))
+    {
+        RemoveFile(temporaryPath);
+        throw std::runtime_error("Unable to write shader bundle \"" + path + "\".");
+    }
+}
+
+static bool IsValidTable(const ShaderBundleHeader &header, uint64_t offset, uint64_t count, size_t recordSize)
+{
+    return offset % TableAlignment == 0 && offset <= header.FileSize && count <= (header.FileSize - offset) / recordSize;
+}
+
+static bool IsValidRange(uint32_t first, uint32_t count, uint32_t tableCount)
+{
+    return first <= tableCount && count <= tableCount - first;
+}
+
+ShaderBundle::ShaderBundle(const std::string &path) : _file(path)
+{
+    const uint8_t *base = _file.GetData();
+    _header = reinterpret_cast<const ShaderBundleHeader *>(base);
+    if (_file.GetSize() < sizeof(ShaderBundleHeader)
+        || _header->Magic != ShaderBundleMagic
+        || _header->Version != ShaderBundleVersion
+        || _header->FileSize != _file.GetSize()
+        || _header->SlotCount == 0
+        || (_header->SlotCount & (_header->SlotCount - 1)) != 0
+        || !IsValidTable(*_header, _header->SlotsOffset, _header->SlotCount, sizeof(uint32_t))
+        || !IsValidTable(*_header, _header->EntriesOffset, _header->EntryCount, sizeof(ShaderBundleEntry))
+        || !IsValidTable(*_header, _header->BlobsOffset, _header->BlobCount, sizeof(ShaderBundleBlob))
+        || !IsValidTable(
+            *_header, _header->VertexElementsOffset, _header->VertexElementCount, sizeof(ShaderBundleVertexElement))
+        || !IsValidTable(
+            *_header, _header->ResourceElementsOffset, _header->ResourceElementCount, sizeof(ShaderBundleResourceElement))
+        || !IsValidTable(*_header, _header->StringsOffset, _header->StringsSize, 1))
+    {
+        throw std::runtime_error("File \"" + path + "\" is not a valid shader bundle.");
+    }
+
+    _slots = reinterpret_cast<const uint32_t *>(base + _header->SlotsOffset);
+    _entries = reinterpret_cast<const ShaderBundleEntry *>(base + _header->EntriesOffset);
+    _blobs = reinterpret_cast<const ShaderBundleBlob *>(base + _header->BlobsOffset);
+    _vertexElements = reinterpret_cast<const ShaderBundleVertexElement *>(base + _header->VertexElementsOffset);
+    _resourceElements = reinterpret_cast<const ShaderBundleResourceElement *>(base + _header->ResourceElementsOffset);
+    _strings = reinterpret_cast<const char *>(base + _header->StringsOffset);
+}
+
+// Entries are only checked when they are looked up, so that opening a bundle does not touch every page.
+bool ShaderBundle::IsValidEntry(const ShaderBundleEntry &entry) const
+{
+    uint64_t stringsSize = _header->StringsSize;
+    auto isValidString = [stringsSize](uint32_t offset, uint32_t length)
+    {
+        return offset <= stringsSize && length <= stringsSize - offset;
+    };
+
+    if (!isValidString(entry.KeyOffset, entry.KeyLength)
+        || !IsValidRange(entry.FirstBlob, entry.BlobCount, _header->BlobCount)
+        || !IsValidRange(entry.FirstVertexElement, entry.VertexElementCount, _header->VertexElementCount)
+        || !IsValidRange(entry.FirstResourceElement, entry.ResourceElementCount, _header->ResourceElementCount))
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < entry.BlobCount; i++)
+    {
+        const ShaderBundleBlob &blob = _blobs[entry.FirstBlob + i];
+        if (blob.Offset > _header->FileSize || blob.Size > _header->FileSize - blob.Offset)
+        {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < entry.VertexElementCount; i++)
+    {
+        const ShaderBundleVertexElement &element = _vertexElements[entry.FirstVertexElement + i];
+        if (!isValidString(element.NameOffset, element.NameLength))
+        {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < entry.ResourceElementCount; i++)
+    {
+        const ShaderBundleResourceElement &element = _resourceElements[entry.FirstResourceElement + i];
+        if (!isValidString(element.NameOffset, element.NameLength))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ShaderBundle::Find(const char *key, size_t keyLength, ShaderBundleVariant &variant) const
+{
+    Hash128 hash = HashBytes(key, keyLength);
+    uint32_t mask = _header->SlotCount - 1;
+    uint32_t slot = static_cast<uint32_t>(hash.Low) & mask;
+    for (uint32_t probe = 0; probe < _header->SlotCount; probe++)
+    {
+        uint32_t index = _slots[slot];
+        if (index == 0 || index > _header->EntryCount)
+        {
+            return false;
+        }
+
+        const ShaderBundleEntry &entry = _entries[index - 1];
+        if (entry.KeyHash == hash
+            && entry.KeyLength == keyLength
+            && IsValidEntry(entry)
+            && memcmp(_strings + entry.KeyOffset, key, keyLength) == 0)
+        {
+            variant.Base = _file.GetData();
+            variant.Entry = &entry;
+            variant.Blobs = _blobs + entry.FirstBlob;
+            variant.VertexElements = _vertexElements + entry.FirstVertexElement;
+            variant.ResourceElements = _resourceElements + entry.FirstResourceElement;
+            variant.Strings = _strings;
+            return true;
+        }
+
+        slot = (slot + 1) & mask;
+    }
+
+    return false;
+}
+
+bool ShaderBundle::ReadBlob(const ShaderBundleBlob &blob, uint8_t *destination, size_t size) const
+{
+    if (blob.DecodedSize != size)
+    {
+        return false;
+    }
+
+    const uint8_t *data = _file.GetData() + blob.Offset;
+    switch (blob.Encoding)
+    {
+    case ShaderBundleEncoding::Stored:
+        if (blob.Size != size)
+        {
+            return false;
+        }
+        if (size > 0)
+        {
+            memcpy(destination, data, size);
+        }
+        return true;
+    case ShaderBundleEncoding::Compressed:
+        return DecompressBlock(data, static_cast<size_t>(blob.Size), destination, size);
+    default:
+        return false;
+    }
+}
+} // namespace Veldrid
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "InteropStructs.hpp"
+#include "MappedFile.hpp"
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Veldrid
+{
+// Shader bundles hold the SPIR-V, the generated shader text and the reflection data of many variants in
+// one file, so that they can be loaded with a single mapping. Every table is stored 8-byte aligned and in
+// the exact layout of the records below; a reader uses them in place. Offsets are from the start of the
+// file unless noted otherwise. The file starts with a ShaderBundleHeader, followed by the directory slots,
+// the entry, blob, vertex element and resource element tables, the string pool and the blob contents.
+static const uint32_t ShaderBundleMagic = 0x42505356; // "VSPB"
+static const uint32_t ShaderBundleVersion = 1;
+
+// The Target of the blobs holding SPIR-V.
+static const uint32_t ShaderBundleSpirvTarget = 0xFFFFFFFF;
+
+#pragma pack(push, 1)
+struct ShaderBundleHeader
+{
+    uint32_t Magic;
+    uint32_t Version;
+    uint64_t FileSize;
+    // Open-addressed hash table of entry indices plus one, indexed by the low bits of the key hash and
+    // probed linearly. Zero marks an empty slot. SlotCount is a power of two.
+    uint64_t SlotsOffset;
+    uint32_t SlotCount;
+    uint32_t EntryCount;
+    uint64_t EntriesOffset;
+    uint64_t BlobsOffset;
+    uint32_t BlobCount;
+    uint32_t VertexElementCount;
+    uint64_t VertexElementsOffset;
+    uint64_t ResourceElementsOffset;
+    uint32_t ResourceElementCount;
+    uint32_t Reserved;
+    uint64_t StringsOffset;
+    uint64_t StringsSize;
+};
+
+// One variant, looked up by its key. Ranges index the blob, vertex element and resource element tables;
+// names are offsets into the string pool.
+struct ShaderBundleEntry
+{
+    Hash128 KeyHash;
+    uint32_t KeyOffset;
+    uint32_t KeyLength;
+    uint32_t FirstBlob;
+    uint32_t BlobCount;
+    uint32_t FirstVertexElement;
+    uint32_t VertexElementCount;
+    uint32_t FirstResourceElement;
+    uint32_t ResourceElementCount;
+    // Without sparse layouts, the resource elements of set N, binding M describe element M of layout N.
+    uint32_t ResourceLayoutCount;
+    Bool32 SparseResourceLayouts;
+};
+
+enum class ShaderBundleEncoding : uint32_t
+{
+    Stored,
+    // BundleCompression.hpp
+    Compressed,
+};
+
+struct ShaderBundleBlob
+{
+    // A CrossCompileTarget, or ShaderBundleSpirvTarget.
+    uint32_t Target;
+    uint32_t Stage;
+    ShaderBundleEncoding Encoding;
+    uint32_t Reserved;
+    uint64_t Offset;
+    uint64_t Size;
+    uint64_t DecodedSize;
+};
+
+struct ShaderBundleVertexElement
+{
+    uint32_t NameOffset;
+    uint32_t NameLength;
+    VertexElementSemantic Semantic;
+    VertexElementFormat Format;
+    uint16_t Reserved;
+    uint32_t Offset;
+};
+
+struct ShaderBundleResourceElement
+{
+    uint32_t Set;
+    uint32_t Binding;
+    uint32_t NameOffset;
+    uint32_t NameLength;
+    ResourceKind Kind;
+    ShaderStages Stages;
+    uint16_t Reserved;
+    uint32_t Options;
+};
+
+// The tables of one variant, pointing straight into the mapped bundle. Blob offsets are relative to Base.
+struct ShaderBundleVariant
+{
+    const uint8_t *Base;
+    const ShaderBundleEntry *Entry;
+    const ShaderBundleBlob *Blobs;
+    const ShaderBundleVertexElement *VertexElements;
+    const ShaderBundleResourceElement *ResourceElements;
+    const char *Strings;
+};
+#pragma pack(pop)
+
+// Collects compiled variants in memory and writes them out as a bundle. Variants may be added from
+// several threads at once.
+class ShaderBundleWriter
+{
+public:
+    explicit ShaderBundleWriter(bool compress) : _compress(compress) {}
+
+    // Adds the SPIR-V stages of the given info and the stage texts and reflection data of a successful
+    // compilation of it for the given targets. Throws std::runtime_error if the key is already in use.
+    void AddVariant(
+        const std::string &key,
+        const CrossCompileInfo &info,
+        const CrossCompileTarget *targets,
+        uint32_t targetCount,
+        const CompilationResult &result);
+
+    // Writes to a temporary file next to the given path, then renames it into place.
+    void Write(const std::string &path);
+
+private:
+    struct PendingBlob
+    {
+        ShaderBundleBlob Record;
+        std::vector<uint8_t> Data;
+    };
+
+    struct PendingVariant
+    {
+        ShaderBundleEntry Record;
+        std::vector<PendingBlob> Blobs;
+        std::vector<ShaderBundleVertexElement> VertexElements;
+        std::vector<ShaderBundleResourceElement> ResourceElements;
+    };
+
+    PendingBlob CreateBlob(uint32_t target, ShaderStages stage, const uint8_t *data, size_t size) const;
+    uint32_t AddString(const char *data, size_t size);
+
+    bool _compress;
+    std::mutex _mutex;
+    std::map<std::string, PendingVariant> _variants;
+    std::string _strings;
+};
+
+// A memory-mapped bundle. Opening only validates the header and table bounds; lookups hash the key and
+// return views into the mapping. Throws std::runtime_error if the file is not a valid bundle.
+class ShaderBundle
+{
+public:
+    explicit ShaderBundle(const std::string &path);
+
+    uint32_t GetVariantCount() const { return _header->EntryCount; }
+    bool Find(const char *key, size_t keyLength, ShaderBundleVariant &variant) const;
+    // Copies the decoded contents of a blob of this bundle. Returns false if the destination does not
+    // have exactly the decoded size or the blob is corrupt.
+    bool ReadBlob(const ShaderBundleBlob &blob, uint8_t *destination, size_t size) const;
+
+private:
+    bool IsValidEntry(const ShaderBundleEntry &entry) const;
+
+    MappedFile _file;
+    const ShaderBundleHeader *_header;
+    const uint32_t *_slots;
+    const ShaderBundleEntry *_entries;
+    const ShaderBundleBlob *_blobs;
+    const ShaderBundleVertexElement *_vertexElements;
+    const ShaderBundleResourceElement *_resourceElements;
+    const char *_strings;
+};
+} // namespace Veldrid
@@ -0,0 +1,307 @@
+#include "ShaderMinifier.hpp"
+#include <unordered_map>
+
+using namespace spirv_cross;
+
+namespace Veldrid
+{
+void ClearInternalNames(ParsedIR &ir)
+{
+    for (auto id : ir.ids_for_type[TypeVariable])
+    {
+        if (ir.ids[id].get<SPIRVariable>().storage == spv::StorageClassFunction)
+        {
+            ir.set_name(id, "");
+        }
+    }
+
+    for (auto id : ir.ids_for_type[TypeFunction])
+    {
+        if (ir.entry_points.find(id) == ir.entry_points.end())
+        {
+            ir.set_name(id, "");
+        }
+    }
+}
+
+enum class TokenKind
+{
+    Identifier,
+    Number,
+    String,
+    Punctuation,
+    Space,
+    Newline,
+    LineContinuation,
+};
+
+struct Token
+{
+    TokenKind Kind;
+    size_t Start;
+    size_t Length;
+};
+
+static bool IsIdentifierStart(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+static bool IsDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static bool IsIdentifierChar(char c)
+{
+    return IsIdentifierStart(c) || IsDigit(c);
+}
+
+// Characters which would form a different token if two of them were joined, as in "- -" or "/ *".
+static bool IsOperatorChar(char c)
+{
+    switch (c)
+    {
+    case '+': case '-': case '*': case '/': case '%': case '<': case '>': case '=':
+    case '&': case '|': case '^': case '!': case '~': case ':': case '?':
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool NeedsSeparator(char left, char right)
+{
+    bool leftWord = IsIdentifierChar(left) || left == '.';
+    bool rightWord = IsIdentifierChar(right) || right == '.';
+    return (leftWord && rightWord) || (IsOperatorChar(left) && IsOperatorChar(right));
+}
+
+// Comments are reported as Space, or as Newline if a block comment spans lines.
+static Token NextToken(const std::string &text, size_t position)
+{
+    Token token = { TokenKind::Punctuation, position, 1 };
+    size_t end = position;
+    char c = text[position];
+    if (c == '\n')
+    {
+        token.Kind = TokenKind::Newline;
+        return token;
+    }
+    if (c == ' ' || c == '\t' || c == '\r')
+    {
+        while (end < text.size() && (text[end] == ' ' || text[end] == '\t' || text[end] == '\r'))
+        {
+            end++;
+        }
+        token.Kind = TokenKind::Space;
+    }
+    else if (c == '\\' && position + 1 < text.size() && text[position + 1] == '\n')
+    {
+        token.Kind = TokenKind::LineContinuation;
+        end = position + 2;
+    }
+    else if (c == '/' && position + 1 < text.size() && text[position + 1] == '/')
+    {
+        end = text.find('\n', position);
+        end = end == std::string::npos ? text.size() : end;
+        token.Kind = TokenKind::Space;
+    }
+    else if (c == '/' && position + 1 < text.size() && text[position + 1] == '*')
+    {
+        end = text.find("*/", position + 2);
+        end = end == std::string::npos ? text.size() : end + 2;
+        bool multiline = text.find('\n', position) < end;
+        token.Kind = multiline ? TokenKind::Newline : TokenKind::Space;
+    }
+    else if (c == '"')
+    {
+        end = position + 1;
+        while (end < text.size() && text[end] != '"' && text[end] != '\n')
+        {
+            end += text[end] == '\\' ? 2 : 1;
+        }
+        end = end < text.size() ? end + 1 : text.size();
+        token.Kind = TokenKind::String;
+    }
+    else if (IsIdentifierStart(c))
+    {
+        while (end < text.size() && IsIdentifierChar(text[end]))
+        {
+            end++;
+        }
+        token.Kind = TokenKind::Identifier;
+    }
+    else if (IsDigit(c) || (c == '.' && position + 1 < text.size() && IsDigit(text[position + 1])))
+    {
+        bool hex = c == '0' && position + 1 < text.size() && (text[position + 1] == 'x' || text[position + 1] == 'X');
+        while (end < text.size())
+        {
+            char n = text[end];
+            bool exponentSign = !hex && (n == '+' || n == '-') && (text[end - 1] == 'e' || text[end - 1] == 'E');
+            if (!IsIdentifierChar(n) && n != '.' && !exponentSign)
+            {
+                break;
+            }
+            end++;
+        }
+        token.Kind = TokenKind::Number;
+    }
+    else
+    {
+        return token;
+    }
+
+    token.Length = end - position;
+    return token;
+}
+
+// The identifiers SPIRV-Cross makes up for unnamed ids: "_" followed by digits, possibly in several
+// underscore-separated groups.
+static bool IsGeneratedName(const char *name, size_t length)
+{
+    if (length < 2 || name[0] != '_' || !IsDigit(name[1]))
+    {
+        return false;
+    }
+
+    for (size_t i = 2; i < length; i++)
+    {
+        if (!IsDigit(name[i]) && name[i] != '_')
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// "_a" ... "_z", "_a0" ... "_az", and so on. Names never start with "_" and an upper-case letter, which
+// C++ reserves.
+static std::string GetShortName(uint32_t index)
+{
+    static const char Letters[] = "abcdefghijklmnopqrstuvwxyz";
+    static const char Characters[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+    std::string name = "_";
+    name += Letters[index % 26];
+    index /= 26;
+    while (index > 0)
+    {
+        index -= 1;
+        name += Characters[index % 36];
+        index /= 36;
+    }
+    return name;
+}
+
+std::string MinifyShaderText(const std::string &text, const std::unordered_set<std::string> &keepNames)
+{
+    std::vector<Token> tokens;
+    std::unordered_set<std::string> usedNames;
+    for (size_t position = 0; position < text.size();)
+    {
+        Token token = NextToken(text, position);
+        if (token.Kind == TokenKind::Identifier)
+        {
+            usedNames.emplace(text, token.Start, token.Length);
+        }
+        tokens.push_back(token);
+        position += token.Length;
+    }
+
+    std::unordered_map<std::string, std::string> renames;
+    uint32_t nextName = 0;
+    std::string ret;
+    ret.reserve(text.size() / 2);
+    bool lineStart = true;
+    bool inDirective = false;
+    bool pendingSpace = false;
+    for (const Token &token : tokens)
+    {
+        switch (token.Kind)
+        {
+        case TokenKind::Space:
+            pendingSpace = true;
+            continue;
+        case TokenKind::Newline:
+            if (inDirective)
+            {
+                ret += '\n';
+                inDirective = false;
+            }
+            pendingSpace = true;
+            lineStart = true;
+            continue;
+        case TokenKind::LineContinuation:
+            if (inDirective)
+            {
+                ret += "\\\n";
+            }
+            pendingSpace = true;
+            continue;
+        default:
+            break;
+        }
+
+        char first = text[token.Start];
+        if (lineStart && token.Kind == TokenKind::Punctuation && first == '#')
+        {
+            if (!ret.empty() && ret.back() != '\n')
+            {
+                ret += '\n';
+            }
+            inDirective = true;
+        }
+        else if (pendingSpace && !ret.empty() && ret.back() != '\n' && (inDirective || NeedsSeparator(ret.back(), first)))
+        {
+            // Whitespace is kept as is inside directives, where "#define A (x)" and "#define A(x)" differ.
+            ret += ' ';
+        }
+        pendingSpace = false;
+        lineStart = false;
+
+        const char *tokenText = text.data() + token.Start;
+        if (token.Kind != TokenKind::Identifier || !IsGeneratedName(tokenText, token.Length))
+        {
+            ret.append(tokenText, token.Length);
+            continue;
+        }
+
+        std::string name(tokenText, token.Length);
+        if (keepNames.find(name) != keepNames.end())
+        {
+            ret += name;
+            continue;
+        }
+
+        auto it = renames.find(name);
+        if (it == renames.end())
+        {
+            std::string shortName = GetShortName(nextName);
+            while (usedNames.find(shortName) != usedNames.end() || keepNames.find(shortName) != keepNames.end())
+            {
+                shortName = GetShortName(++nextName);
+            }
+
+            // Short names only grow, so the first one that does not help means the same for every later name.
+            if (shortName.size() < name.size())
+            {
+                nextName++;
+            }
+            else
+            {
+                shortName = name;
+            }
+            it = renames.emplace(name, shortName).first;
+        }
+        ret += it->second;
+    }
+
+    if (inDirective)
+    {
+        ret += '\n';
+    }
+
+    return ret;
+}
+} // namespace Veldrid
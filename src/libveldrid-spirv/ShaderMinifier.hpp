@@ -0,0 +1,18 @@
+#pragma once
+
+#include "spirv_cross.hpp"
+#include <string>
+#include <unordered_set>
+
+namespace Veldrid
+{
+// Drops the debug names of function-local variables, function parameters and functions other than the
+// entry points, so that SPIRV-Cross gives them generated "_<id>" names instead. None of them are visible
+// outside the shader.
+void ClearInternalNames(spirv_cross::ParsedIR &ir);
+
+// Removes comments and all whitespace that is not needed to separate tokens, and renames every generated
+// "_<id>" identifier that is not in keepNames to the shortest unused name. Preprocessor directives stay on
+// lines of their own.
+std::string MinifyShaderText(const std::string &text, const std::unordered_set<std::string> &keepNames);
+} // namespace Veldrid
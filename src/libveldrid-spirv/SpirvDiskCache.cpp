@@ -0,0 +1,120 @@
+#include "SpirvDiskCache.hpp"
+#include "MappedFile.hpp"
+#include <atomic>
+#include <fstream>
+
+#ifdef _WIN32
+#include <process.h>
+#define GetProcessId _getpid
+#else
+#include <unistd.h>
+#define GetProcessId getpid
+#endif
+
+namespace Veldrid
+{
+static const uint32_t SpirvMagic = 0x07230203;
+
+void SpirvDiskCache::SetDirectory(const std::string &directory)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _directory = directory;
+    if (!_directory.empty() && _directory.back() != '/' && _directory.back() != '\\')
+    {
+        _directory += '/';
+    }
+}
+
+bool SpirvDiskCache::IsEnabled()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return !_directory.empty();
+}
+
+bool SpirvDiskCache::Load(const Hash128 &key, std::vector<uint32_t> &spirv)
+{
+    std::string path = GetPath(key);
+    if (path.empty())
+    {
+        return false;
+    }
+
+    std::ifstream file(ToNativePath(path).c_str(), std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        return false;
+    }
+
+    std::streamoff size = file.tellg();
+    if (size < static_cast<std::streamoff>(sizeof(uint32_t)) || size % sizeof(uint32_t) != 0)
+    {
+        return false;
+    }
+
+    spirv.resize(static_cast<size_t>(size) / sizeof(uint32_t));
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(spirv.data()), size);
+    return file.good() && spirv[0] == SpirvMagic;
+}
+
+void SpirvDiskCache::Store(const Hash128 &key, const uint32_t *words, size_t wordCount)
+{
+    static std::atomic<uint32_t> nextTemporaryId(0);
+
+    // Failures are ignored: the cache only ever saves work, and the next compilation will try again.
+    std::string path = GetPath(key);
+    if (path.empty())
+    {
+        return;
+    }
+
+    std::string temporaryPath = path + "." + std::to_string(GetProcessId()) + "-" + std::to_string(nextTemporaryId++) + ".tmp";
+    {
+        std::ofstream file(ToNativePath(temporaryPath).c_str(), std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            return;
+        }
+
+        file.write(reinterpret_cast<const char *>(words), wordCount * sizeof(uint32_t));
+        if (!file.good())
+        {
+            file.close();
+            RemoveFile(temporaryPath);
+            return;
+        }
+    }
+
+    if (!RenameFile(temporaryPath, path))
+    {
+        // Another writer got there first (rename does not replace files on Windows); its copy is identical.
+        RemoveFile(temporaryPath);
+    }
+}
+
+std::string SpirvDiskCache::GetPath(const Hash128 &key)
+{
+    static const char HexDigits[] = "0123456789abcdef";
+    char name[33];
+    for (int i = 0; i < 32; i++)
+    {
+        uint64_t half = i < 16 ? key.High : key.Low;
+        name[i] = HexDigits[(half >> (60 - (i % 16) * 4)) & 0xF];
+    }
+    name[32] = '\0';
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_directory.empty())
+    {
+        return std::string();
+    }
+
+    return _directory + name + ".spv";
+}
+
+SpirvDiskCache &GetSpirvDiskCache()
+{
+    static SpirvDiskCache cache;
+    return cache;
+}
+} // namespace Veldrid
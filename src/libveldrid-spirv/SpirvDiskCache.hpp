@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Hashing.hpp"
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Veldrid
+{
+// A directory of compiled SPIR-V modules, one file per key. Files are written to a temporary name and
+// renamed into place, so several processes may share the same directory. The directory must already
+// exist; an empty path disables the cache.
+class SpirvDiskCache
+{
+public:
+    void SetDirectory(const std::string &directory);
+    bool IsEnabled();
+
+    bool Load(const Hash128 &key, std::vector<uint32_t> &spirv);
+    void Store(const Hash128 &key, const uint32_t *words, size_t wordCount);
+
+private:
+    std::string GetPath(const Hash128 &key);
+
+    std::mutex _mutex;
+    std::string _directory;
+};
+
+SpirvDiskCache &GetSpirvDiskCache();
+} // namespace Veldrid
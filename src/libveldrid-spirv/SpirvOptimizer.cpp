@@ -0,0 +1,256 @@
+#include "SpirvOptimizer.hpp"
+#include "BuildFeatures.hpp"
+#include "PhaseTimer.hpp"
+#ifndef VD_NO_OPTIMIZER
+#include "spirv-tools/optimizer.hpp"
+#endif
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Veldrid
+{
+#ifndef VD_NO_OPTIMIZER
+static const size_t HeaderWordCount = 5;
+
+enum : uint32_t
+{
+    OpTypeBool = 20,
+    OpTypeInt = 21,
+    OpTypeFloat = 22,
+    OpSpecConstantTrue = 48,
+    OpSpecConstantFalse = 49,
+    OpSpecConstant = 50,
+    OpDecorate = 71,
+    DecorationSpecId = 1,
+};
+
+// Built-in vertex outputs which are consumed by fixed-function stages rather than the fragment shader.
+static const uint32_t FixedFunctionBuiltIns[] =
+{
+    0, // Position
+    1, // PointSize
+    3, // ClipDistance
+    4, // CullDistance
+    9, // Layer
+    10, // ViewportIndex
+};
+
+static spv_target_env GetTargetEnvironment(uint32_t version)
+{
+    switch ((version >> 8) & 0xFF)
+    {
+    case 0: return SPV_ENV_UNIVERSAL_1_0;
+    case 1: return SPV_ENV_UNIVERSAL_1_1;
+    case 2: return SPV_ENV_UNIVERSAL_1_2;
+    case 3: return SPV_ENV_UNIVERSAL_1_3;
+    case 4: return SPV_ENV_UNIVERSAL_1_4;
+    default: return SPV_ENV_UNIVERSAL_1_5;
+    }
+}
+
+// SPIRV-Tools takes specialization values as bit patterns of the constant's own width, so the width of
+// each SpecId is looked up in the module: SpecId decoration -> constant -> type.
+static std::unordered_map<uint32_t, std::vector<uint32_t>> GetSpecializationValues(
+    const uint32_t *words,
+    size_t wordCount,
+    const InteropArray<SpecializationConstant> &specializations)
+{
+    std::unordered_map<uint32_t, uint32_t> specIDs; // Constant ID -> SpecId
+    std::unordered_map<uint32_t, uint32_t> constantTypes; // Constant ID -> type ID
+    std::unordered_map<uint32_t, uint32_t> typeWidths; // Type ID -> width in bits; zero for bools
+    size_t position = HeaderWordCount;
+    while (position < wordCount)
+    {
+        uint32_t instructionWordCount = words[position] >> 16;
+        uint32_t opcode = words[position] & 0xFFFF;
+        if (instructionWordCount == 0 || instructionWordCount > wordCount - position)
+        {
+            throw std::runtime_error("The SPIR-V module is not valid.");
+        }
+
+        const uint32_t *operands = &words[position + 1];
+        uint32_t operandCount = instructionWordCount - 1;
+        switch (opcode)
+        {
+        case OpDecorate:
+            if (operandCount >= 3 && operands[1] == DecorationSpecId)
+            {
+                specIDs[operands[0]] = operands[2];
+            }
+            break;
+        case OpTypeBool:
+            if (operandCount >= 1)
+            {
+                typeWidths[operands[0]] = 0;
+            }
+            break;
+        case OpTypeInt:
+        case OpTypeFloat:
+            if (operandCount >= 2)
+            {
+                typeWidths[operands[0]] = operands[1];
+            }
+            break;
+        case OpSpecConstantTrue:
+        case OpSpecConstantFalse:
+        case OpSpecConstant:
+            if (operandCount >= 2)
+            {
+                constantTypes[operands[1]] = operands[0];
+            }
+            break;
+        }
+
+        position += instructionWordCount;
+    }
+
+    std::unordered_map<uint32_t, uint32_t> specWidths; // SpecId -> width in bits
+    for (auto &it : specIDs)
+    {
+        auto type = constantTypes.find(it.first);
+        if (type != constantTypes.end())
+        {
+            auto width = typeWidths.find(type->second);
+            specWidths[it.second] = width != typeWidths.end() ? width->second : 32;
+        }
+    }
+
+    std::unordered_map<uint32_t, std::vector<uint32_t>> ret;
+    for (uint32_t i = 0; i < specializations.Count; i++)
+    {
+        const SpecializationConstant &specialization = specializations[i];
+        auto width = specWidths.find(specialization.ID);
+        if (width == specWidths.end())
+        {
+            continue;
+        }
+
+        std::vector<uint32_t> &value = ret[specialization.ID];
+        if (width->second == 0)
+        {
+            value.push_back(specialization.Constant != 0 ? 1 : 0);
+        }
+        else
+        {
+            value.push_back(static_cast<uint32_t>(specialization.Constant));
+            if (width->second > 32)
+            {
+                value.push_back(static_cast<uint32_t>(specialization.Constant >> 32));
+            }
+        }
+    }
+
+    return ret;
+}
+
+static std::vector<uint32_t> RunPasses(
+    const uint32_t *words,
+    size_t wordCount,
+    const std::function<void(spvtools::Optimizer &)> &registerPasses)
+{
+    if (wordCount < HeaderWordCount)
+    {
+        throw std::runtime_error("The SPIR-V module is not valid.");
+    }
+
+    spvtools::Optimizer optimizer(GetTargetEnvironment(words[1]));
+    std::string messages;
+    optimizer.SetMessageConsumer(
+        [&messages](spv_message_level_t level, const char *, const spv_position_t &, const char *message)
+        {
+            if (level <= SPV_MSG_ERROR)
+            {
+                messages += message;
+                messages += "\n";
+            }
+        });
+
+    registerPasses(optimizer);
+
+    std::vector<uint32_t> optimized;
+    if (!optimizer.Run(words, wordCount, &optimized))
+    {
+        throw std::runtime_error("SPIR-V optimization failed: " + messages);
+    }
+
+    return optimized;
+}
+
+std::vector<uint32_t> OptimizeSpirv(
+    const uint32_t *words,
+    size_t wordCount,
+    SpirvOptimization optimization,
+    const InteropArray<SpecializationConstant> &specializations)
+{
+    PhaseTimer timer(CompilePhase::Optimize);
+    timer.AddBytes(wordCount * sizeof(uint32_t));
+    std::vector<uint32_t> optimized = RunPasses(words, wordCount, [&](spvtools::Optimizer &optimizer)
+    {
+        switch (optimization)
+        {
+        case SpirvOptimization::Performance:
+            optimizer.RegisterPerformancePasses();
+            break;
+        case SpirvOptimization::Size:
+            optimizer.RegisterSizePasses();
+            break;
+        case SpirvOptimization::FreezeSpecializations:
+            optimizer.RegisterPass(spvtools::CreateSetSpecConstantDefaultValuePass(
+                GetSpecializationValues(words, wordCount, specializations)));
+            optimizer.RegisterPass(spvtools::CreateFreezeSpecConstantValuePass());
+            optimizer.RegisterPass(spvtools::CreateFoldSpecConstantOpAndCompositePass());
+            optimizer.RegisterPass(spvtools::CreateDeadBranchElimPass());
+            optimizer.RegisterPass(spvtools::CreateEliminateDeadFunctionsPass());
+            optimizer.RegisterPass(spvtools::CreateAggressiveDCEPass());
+            optimizer.RegisterPass(spvtools::CreateEliminateDeadConstantPass());
+            break;
+        default:
+            throw std::runtime_error("Invalid SpirvOptimization.");
+        }
+    });
+
+    timer.AddBytes(optimized.size() * sizeof(uint32_t));
+    return optimized;
+}
+
+std::vector<uint32_t> PruneVertexOutputs(
+    const uint32_t *vsWords,
+    size_t vsWordCount,
+    const uint32_t *fsWords,
+    size_t fsWordCount)
+{
+    PhaseTimer timer(CompilePhase::Optimize);
+    timer.AddBytes((vsWordCount + fsWordCount) * sizeof(uint32_t));
+    std::unordered_set<uint32_t> liveLocations;
+    std::unordered_set<uint32_t> liveBuiltIns(std::begin(FixedFunctionBuiltIns), std::end(FixedFunctionBuiltIns));
+    RunPasses(fsWords, fsWordCount, [&](spvtools::Optimizer &optimizer)
+    {
+        optimizer.RegisterPass(spvtools::CreateAnalyzeLiveInputPass(&liveLocations, &liveBuiltIns));
+    });
+
+    std::vector<uint32_t> pruned = RunPasses(vsWords, vsWordCount, [&](spvtools::Optimizer &optimizer)
+    {
+        optimizer.RegisterPass(spvtools::CreateEliminateDeadOutputStoresPass(&liveLocations, &liveBuiltIns));
+        // Keeps the vertex inputs, which the reflection data describes, but drops the outputs left unused.
+        optimizer.RegisterPass(spvtools::CreateAggressiveDCEPass(true, true));
+    });
+
+    timer.AddBytes(pruned.size() * sizeof(uint32_t));
+    return pruned;
+}
+#else
+std::vector<uint32_t> OptimizeSpirv(
+    const uint32_t *, size_t, SpirvOptimization, const InteropArray<SpecializationConstant> &)
+{
+    ThrowFeatureUnavailable("SPIR-V optimization");
+}
+
+std::vector<uint32_t> PruneVertexOutputs(const uint32_t *, size_t, const uint32_t *, size_t)
+{
+    ThrowFeatureUnavailable("Stage interface pruning");
+}
+#endif
+} // namespace Veldrid
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "InteropStructs.hpp"
+#include <vector>
+
+namespace Veldrid
+{
+// Runs the given optimization over a SPIR-V module and returns the optimized module. The specialization
+// constants are only used by SpirvOptimization::FreezeSpecializations. Throws if the module is invalid
+// or the optimizer fails.
+std::vector<uint32_t> OptimizeSpirv(
+    const uint32_t *words,
+    size_t wordCount,
+    SpirvOptimization optimization,
+    const InteropArray<SpecializationConstant> &specializations);
+
+// Removes the outputs of a vertex shader which the given fragment shader never reads, together with the
+// code that only computes them, and returns the pruned vertex shader. Built-in outputs used by
+// fixed-function stages, such as the position, are kept.
+std::vector<uint32_t> PruneVertexOutputs(
+    const uint32_t *vsWords,
+    size_t vsWordCount,
+    const uint32_t *fsWords,
+    size_t fsWordCount);
+} // namespace Veldrid
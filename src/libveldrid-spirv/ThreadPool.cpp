@@ -0,0 +1,205 @@
+#include "ThreadPool.hpp"
+#include "Cancellation.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace Veldrid
+{
+ThreadPool::ThreadPool(uint32_t threadCount)
+{
+    for (uint32_t i = 0; i < threadCount; i++)
+    {
+        _threads.emplace_back([this]() { WorkerMain(); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+
+    _taskAvailable.notify_all();
+    for (auto &thread : _threads)
+    {
+        thread.join();
+    }
+}
+
+bool ThreadPool::IsWorkerThread() const
+{
+    std::thread::id current = std::this_thread::get_id();
+    for (const auto &thread : _threads)
+    {
+        if (thread.get_id() == current)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::Enqueue(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _tasks.push_back(std::move(task));
+    }
+
+    _taskAvailable.notify_one();
+}
+
+void ThreadPool::WorkerMain()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _taskAvailable.wait(lock, [this]() { return _stopping || !_tasks.empty(); });
+            if (_tasks.empty())
+            {
+                return;
+            }
+
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+        }
+
+        task();
+    }
+}
+
+struct ParallelForState
+{
+    uint32_t Count;
+    std::function<void(uint32_t)> Body;
+    const std::atomic<bool> *Cancellation;
+    std::atomic<uint32_t> NextIndex { 0 };
+    uint32_t CompletedCount = 0;
+    std::exception_ptr Error;
+    std::mutex Mutex;
+    std::condition_variable Finished;
+
+    // Claims and runs iterations until none are left.
+    void Work()
+    {
+        uint32_t index;
+        while ((index = NextIndex.fetch_add(1)) < Count)
+        {
+            std::exception_ptr error;
+            try
+            {
+                Body(index);
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(Mutex);
+            if (error && !Error)
+            {
+                Error = error;
+            }
+            if (++CompletedCount == Count)
+            {
+                Finished.notify_all();
+            }
+        }
+    }
+};
+
+void ThreadPool::ParallelFor(uint32_t count, const std::function<void(uint32_t)> &body)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    auto state = std::make_shared<ParallelForState>();
+    state->Count = count;
+    state->Body = body;
+    state->Cancellation = GetCancellationFlag();
+
+    // Helpers that start after all iterations were claimed exit immediately. They hold their own
+    // reference to the state, so the caller never has to wait for them to be scheduled.
+    uint32_t helperCount = std::min(count - 1, GetThreadCount());
+    for (uint32_t i = 0; i < helperCount; i++)
+    {
+        Enqueue([state]()
+        {
+            CancellationScope scope(state->Cancellation);
+            state->Work();
+        });
+    }
+
+    state->Work();
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(state->Mutex);
+        state->Finished.wait(lock, [&state]() { return state->CompletedCount == state->Count; });
+        error = std::move(state->Error);
+    }
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+static std::mutex s_workerPoolMutex;
+static std::shared_ptr<ThreadPool> s_workerPool;
+
+static void DestroyPool(ThreadPool *pool)
+{
+    if (pool->IsWorkerThread())
+    {
+        // The worker finishes its current task and then exits once the destructor asks it to stop.
+        std::thread([pool]() { delete pool; }).detach();
+    }
+    else
+    {
+        delete pool;
+    }
+}
+
+static std::shared_ptr<ThreadPool> CreatePool(uint32_t threadCount)
+{
+    return std::shared_ptr<ThreadPool>(new ThreadPool(threadCount), DestroyPool);
+}
+
+static uint32_t GetDefaultThreadCount()
+{
+    uint32_t count = std::thread::hardware_concurrency();
+    return count == 0 ? 1 : count;
+}
+
+std::shared_ptr<ThreadPool> GetWorkerPool()
+{
+    std::lock_guard<std::mutex> lock(s_workerPoolMutex);
+    if (!s_workerPool)
+    {
+        s_workerPool = CreatePool(GetDefaultThreadCount());
+    }
+
+    return s_workerPool;
+}
+
+void SetWorkerPoolThreadCount(uint32_t threadCount)
+{
+    std::shared_ptr<ThreadPool> previous;
+    {
+        std::lock_guard<std::mutex> lock(s_workerPoolMutex);
+        previous = std::move(s_workerPool);
+        s_workerPool = CreatePool(threadCount == 0 ? GetDefaultThreadCount() : threadCount);
+    }
+
+    // Joins the old workers outside of the lock once the last in-flight batch releases the pool.
+    previous.reset();
+}
+} // namespace Veldrid
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Veldrid
+{
+class ThreadPool
+{
+public:
+    explicit ThreadPool(uint32_t threadCount);
+    ~ThreadPool();
+
+    uint32_t GetThreadCount() const { return static_cast<uint32_t>(_threads.size()); }
+    bool IsWorkerThread() const;
+    void Enqueue(std::function<void()> task);
+
+    // Runs body(i) for every i in [0, count), spreading the work across the pool. The calling thread
+    // takes part in the work, so this is safe to call from a worker thread. The first exception thrown
+    // by body is rethrown on the calling thread once all started iterations have finished. Every
+    // iteration runs under the cancellation flag of the calling thread.
+    void ParallelFor(uint32_t count, const std::function<void(uint32_t)> &body);
+
+private:
+    void WorkerMain();
+
+    std::vector<std::thread> _threads;
+    std::deque<std::function<void()>> _tasks;
+    std::mutex _mutex;
+    std::condition_variable _taskAvailable;
+    bool _stopping = false;
+};
+
+// The process-wide pool used by the batch exports. It is created on first use with one thread per
+// hardware thread. If the last reference to a pool is released on one of its own workers, the pool is
+// destroyed on a separate thread, since a worker cannot join itself.
+std::shared_ptr<ThreadPool> GetWorkerPool();
+// Replaces the process-wide pool. A count of zero selects one thread per hardware thread. Work already
+// submitted to the previous pool is allowed to finish.
+void SetWorkerPoolThreadCount(uint32_t threadCount);
+} // namespace Veldrid
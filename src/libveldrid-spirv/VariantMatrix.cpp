@@ -0,0 +1,327 @@
+#include "VariantMatrix.hpp"
+#include "BuildFeatures.hpp"
+#include "CrossCompile.hpp"
+#include "Fingerprint.hpp"
+#include "GlslCompiler.hpp"
+#include "Hashing.hpp"
+#include "ThreadPool.hpp"
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Veldrid
+{
+static const uint64_t MaxPermutationCount = 1 << 20;
+
+struct ResultDeleter
+{
+    void operator()(CompilationResult *result) const { DestroyResult(result); }
+};
+
+typedef std::unique_ptr<CompilationResult, ResultDeleter> ResultPointer;
+
+static uint32_t GetPermutationCount(const VariantMatrixInfo &info)
+{
+    uint64_t count = 1;
+    for (uint32_t i = 0; i < info.Axes.Count; i++)
+    {
+        if (info.Axes[i].Count == 0)
+        {
+            throw std::runtime_error("Macro axis " + std::to_string(i) + " has no values.");
+        }
+
+        count *= info.Axes[i].Count;
+        if (count > MaxPermutationCount)
+        {
+            throw std::runtime_error("The variant matrix has too many permutations.");
+        }
+    }
+
+    return static_cast<uint32_t>(count);
+}
+
+#ifndef VD_NO_GLSL_FRONTEND
+// Compiles every stage of one permutation and hashes the resulting SPIR-V.
+static Hash128 CompilePermutation(
+    const VariantMatrixInfo &info,
+    GlslCompilerSession &session,
+    uint32_t permutation,
+    ResultPointer *stageResults)
+{
+    std::vector<MacroDefinition> macros;
+    macros.reserve(info.Axes.Count);
+    uint32_t remaining = permutation;
+    for (uint32_t i = info.Axes.Count; i-- > 0;)
+    {
+        const InteropArray<MacroDefinition> &axis = info.Axes[i];
+        const MacroDefinition &value = axis[remaining % axis.Count];
+        remaining /= axis.Count;
+        if (value.NameLength > 0)
+        {
+            macros.push_back(value);
+        }
+    }
+
+    Hasher128 hasher;
+    for (uint32_t stage = 0; stage < info.Stages.Count; stage++)
+    {
+        const VariantStageSource &source = info.Stages[stage];
+        Borrowed<GlslCompileInfo> compileInfo;
+        compileInfo.Value.SourceText.Count = source.SourceText.Count;
+        compileInfo.Value.SourceText.Data = source.SourceText.Data;
+        compileInfo.Value.FileName.Count = source.FileName.Count;
+        compileInfo.Value.FileName.Data = source.FileName.Data;
+        compileInfo.Value.Kind = source.Kind;
+        compileInfo.Value.Debug = false;
+        compileInfo.Value.Macros.Count = static_cast<uint32_t>(macros.size());
+        compileInfo.Value.Macros.Data = macros.data();
+        compileInfo.Value.IncludeDirectories.Count = info.IncludeDirectories.Count;
+        compileInfo.Value.IncludeDirectories.Data = info.IncludeDirectories.Data;
+
+        stageResults[stage].reset(session.Compile(compileInfo.Value));
+        const InteropArray<uint8_t> &spirv = stageResults[stage]->DataBuffers[0];
+        hasher.UpdateValue(spirv.Count);
+        hasher.Update(spirv.Data, spirv.Count);
+    }
+
+    return hasher.Finish();
+}
+
+static bool IsSucceeded(const ResultPointer *stageResults, uint32_t stageCount)
+{
+    for (uint32_t stage = 0; stage < stageCount; stage++)
+    {
+        if (!stageResults[stage]->Succeeded)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool HasSameSpirv(const ResultPointer *first, const ResultPointer *second, uint32_t stageCount)
+{
+    for (uint32_t stage = 0; stage < stageCount; stage++)
+    {
+        const InteropArray<uint8_t> &a = first[stage]->DataBuffers[0];
+        const InteropArray<uint8_t> &b = second[stage]->DataBuffers[0];
+        if (a.Count != b.Count || memcmp(a.Data, b.Data, a.Count) != 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Collects the files included by the stages of one permutation, skipping those already in the list.
+static void AddIncludedFiles(
+    const ResultPointer *stageResults,
+    uint32_t stageCount,
+    std::vector<std::string> &includedFiles,
+    std::unordered_set<std::string> &includedFileSet)
+{
+    for (uint32_t stage = 0; stage < stageCount; stage++)
+    {
+        const InteropArray<InteropArray<uint8_t>> &buffers = stageResults[stage]->DataBuffers;
+        for (uint32_t i = 1; i < buffers.Count; i++)
+        {
+            std::string path(reinterpret_cast<const char *>(buffers[i].Data), buffers[i].Count);
+            if (includedFileSet.insert(path).second)
+            {
+                includedFiles.push_back(std::move(path));
+            }
+        }
+    }
+}
+
+static CompilationResult *CrossCompileVariant(
+    const VariantMatrixInfo &info,
+    const ResultPointer *stageResults,
+    std::vector<std::string> &includedFiles)
+{
+    uint32_t stageCount = info.Stages.Count;
+    for (uint32_t stage = 0; stage < stageCount; stage++)
+    {
+        if (!stageResults[stage]->Succeeded)
+        {
+            const InteropArray<uint8_t> &message = stageResults[stage]->DataBuffers[0];
+            return CreateErrorResult(
+                std::string(reinterpret_cast<const char *>(message.Data), message.Count),
+                includedFiles);
+        }
+    }
+
+    Borrowed<CrossCompileInfo> crossCompileInfo;
+    CrossCompileInfo &ccInfo = crossCompileInfo.Value;
+    ccInfo.FixClipSpaceZ = info.FixClipSpaceZ;
+    ccInfo.InvertY = info.InvertY;
+    ccInfo.NormalizeResourceNames = info.NormalizeResourceNames;
+    ccInfo.SparseResourceLayouts = false;
+    ccInfo.Optimization = SpirvOptimization::None;
+    ccInfo.MinifyOutput = false;
+    ccInfo.PruneStageInterface = false;
+    ccInfo.Specializations.Count = info.Specializations.Count;
+    ccInfo.Specializations.Data = info.Specializations.Data;
+    InteropArray<uint32_t> *stageArrays[2] =
+    {
+        stageCount == 2 ? &ccInfo.VertexShader : &ccInfo.ComputeShader,
+        &ccInfo.FragmentShader
+    };
+
+    uint32_t targetCount = info.Targets.Count;
+    uint32_t includeIndex = stageCount * (1 + targetCount);
+    OutputWriter output(includeIndex + static_cast<uint32_t>(includedFiles.size()), nullptr);
+    for (uint32_t stage = 0; stage < stageCount; stage++)
+    {
+        const InteropArray<uint8_t> &spirv = stageResults[stage]->DataBuffers[0];
+        stageArrays[stage]->Count = spirv.Count / sizeof(uint32_t);
+        stageArrays[stage]->Data = reinterpret_cast<uint32_t *>(spirv.Data);
+        output.Submit(stage, std::string(reinterpret_cast<const char *>(spirv.Data), spirv.Count));
+    }
+
+    std::vector<CompileJob> jobs(targetCount);
+    for (uint32_t i = 0; i < targetCount; i++)
+    {
+        jobs[i].Target = info.Targets[i];
+        jobs[i].Specializations = &ccInfo.Specializations;
+    }
+
+    ReflectionData reflection;
+    if (targetCount > 0)
+    {
+        ccInfo.Target = info.Targets[0];
+        CompileJobs(ccInfo, jobs.data(), targetCount, output, stageCount, reflection);
+    }
+
+    for (size_t i = 0; i < includedFiles.size(); i++)
+    {
+        output.Submit(includeIndex + static_cast<uint32_t>(i), std::move(includedFiles[i]));
+    }
+
+    std::vector<ByteSpan> dataBuffers = output.GetDataBuffers();
+    CompilationResult *result = CreateResult(dataBuffers.data(), static_cast<uint32_t>(dataBuffers.size()), &reflection);
+    result->Fingerprint = FingerprintStages(ccInfo);
+    return result;
+}
+#endif
+
+VariantMatrixResult *RunVariantMatrix(const VariantMatrixInfo &info)
+{
+    std::unique_ptr<VariantMatrixResult> ret(new VariantMatrixResult());
+    try
+    {
+        uint32_t stageCount = info.Stages.Count;
+        if (stageCount != 1 && stageCount != 2)
+        {
+            throw std::runtime_error("A variant matrix needs either a vertex-fragment pair or a compute shader.");
+        }
+
+        uint32_t permutationCount = GetPermutationCount(info);
+
+#ifdef VD_NO_GLSL_FRONTEND
+        (void)permutationCount;
+        ThrowFeatureUnavailable("GLSL compilation");
+#else
+        Borrowed<GlslSessionInfo> sessionInfo;
+        sessionInfo.Value.Debug = info.Debug;
+        sessionInfo.Value.Macros.Count = info.Macros.Count;
+        sessionInfo.Value.Macros.Data = info.Macros.Data;
+        GlslCompilerSession session(sessionInfo.Value);
+
+        std::vector<ResultPointer> stageResults(permutationCount * stageCount);
+        std::vector<Hash128> hashes(permutationCount);
+        std::shared_ptr<ThreadPool> pool = GetWorkerPool();
+        pool->ParallelFor(permutationCount, [&](uint32_t p)
+        {
+            hashes[p] = CompilePermutation(info, session, p, &stageResults[p * stageCount]);
+        });
+
+        // Failed permutations are never merged, so that each keeps its own error message.
+        std::vector<uint32_t> variantPermutations;
+        std::unordered_multimap<uint64_t, uint32_t> variantsByHash;
+        ret->PermutationVariants = InteropArray<uint32_t>(permutationCount);
+        for (uint32_t p = 0; p < permutationCount; p++)
+        {
+            const ResultPointer *results = &stageResults[p * stageCount];
+            uint32_t variant = static_cast<uint32_t>(variantPermutations.size());
+            if (IsSucceeded(results, stageCount))
+            {
+                auto range = variantsByHash.equal_range(hashes[p].Low);
+                for (auto it = range.first; it != range.second; ++it)
+                {
+                    uint32_t candidate = variantPermutations[it->second];
+                    if (hashes[candidate] == hashes[p]
+                        && HasSameSpirv(&stageResults[candidate * stageCount], results, stageCount))
+                    {
+                        variant = it->second;
+                        break;
+                    }
+                }
+
+                if (variant == variantPermutations.size())
+                {
+                    variantsByHash.emplace(hashes[p].Low, variant);
+                }
+            }
+
+            if (variant == variantPermutations.size())
+            {
+                variantPermutations.push_back(p);
+            }
+            ret->PermutationVariants[p] = variant;
+        }
+
+        // A variant depends on the includes of every permutation merged into it, since a change to any of them
+        // may make that permutation differ again.
+        uint32_t variantCount = static_cast<uint32_t>(variantPermutations.size());
+        std::vector<std::vector<std::string>> includedFiles(variantCount);
+        std::vector<std::unordered_set<std::string>> includedFileSets(variantCount);
+        for (uint32_t p = 0; p < permutationCount; p++)
+        {
+            uint32_t variant = ret->PermutationVariants[p];
+            AddIncludedFiles(&stageResults[p * stageCount], stageCount, includedFiles[variant], includedFileSets[variant]);
+        }
+
+        ret->Variants = InteropArray<CompilationResult *>(variantCount);
+        memset(ret->Variants.Data, 0, variantCount * sizeof(CompilationResult *));
+        pool->ParallelFor(variantCount, [&](uint32_t v)
+        {
+            const ResultPointer *results = &stageResults[variantPermutations[v] * stageCount];
+            try
+            {
+                ret->Variants[v] = CrossCompileVariant(info, results, includedFiles[v]);
+            }
+            catch (const std::exception &e)
+            {
+                ret->Variants[v] = CreateErrorResult(e.what(), includedFiles[v]);
+            }
+        });
+#endif
+    }
+    catch (const std::exception &e)
+    {
+        DestroyVariantMatrixResult(ret.release());
+        ret.reset(new VariantMatrixResult());
+        ret->Variants = InteropArray<CompilationResult *>(1);
+        ret->Variants[0] = CreateErrorResult(e.what());
+    }
+
+    return ret.release();
+}
+
+void DestroyVariantMatrixResult(VariantMatrixResult *result)
+{
+    for (uint32_t i = 0; i < result->Variants.Count; i++)
+    {
+        if (result->Variants[i] != nullptr)
+        {
+            DestroyResult(result->Variants[i]);
+        }
+    }
+
+    delete result;
+}
+} // namespace Veldrid
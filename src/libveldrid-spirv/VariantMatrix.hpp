@@ -0,0 +1,11 @@
+#pragma once
+
+#include "InteropStructs.hpp"
+
+namespace Veldrid
+{
+// Runs GLSL-to-SPIR-V for every permutation in parallel, collapses permutations with byte-identical
+// SPIR-V, and cross-compiles each distinct module once for all targets.
+VariantMatrixResult *RunVariantMatrix(const VariantMatrixInfo &info);
+void DestroyVariantMatrixResult(VariantMatrixResult *result);
+} // namespace Veldrid
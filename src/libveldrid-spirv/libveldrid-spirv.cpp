@@ -3,11 +3,36 @@
 
 #include "libveldrid-spirv.hpp"
 #include "InteropStructs.hpp"
+#include "BuildFeatures.hpp"
+#include "GlslCompiler.hpp"
+#include "IncludeResolver.hpp"
+#include "MappedFile.hpp"
+#include "OutputWriter.hpp"
+#include "PhaseTimer.hpp"
+#include "CrossCompile.hpp"
+#include "CompileClient.hpp"
+#include "CompileTask.hpp"
+#include "Fingerprint.hpp"
+#include "ResultBuilder.hpp"
+#include "ResultCache.hpp"
+#include "ShaderBundle.hpp"
+#include "ShaderMinifier.hpp"
+#include "SpirvDiskCache.hpp"
+#include "SpirvOptimizer.hpp"
+#include "ThreadPool.hpp"
+#include "VariantMatrix.hpp"
+#include <algorithm>
 #include <fstream>
+#ifndef VD_NO_HLSL
 #include "spirv_hlsl.hpp"
+#endif
 #include "spirv_glsl.hpp"
+#ifndef VD_NO_MSL
 #include "spirv_msl.hpp"
+#endif
+#include "spirv_parser.hpp"
 #include <map>
+#include <unordered_map>
 #include <sstream>
 #include "shaderc.hpp"
 #include <iostream>
@@ -16,7 +41,7 @@ using namespace spirv_cross;
 
 namespace Veldrid
 {
-void ReflectVertexInfo(const Compiler& compiler, const ShaderResources& resources, ReflectionInfo& info);
+void ReflectVertexInfo(const Compiler& compiler, const ShaderResources& resources, ReflectionData& info);
 
 struct BindingInfo
 {
@@ -182,13 +207,84 @@ uint32_t GetResourceIndex(
     }
 }
 
-Compiler *GetCompiler(std::vector<uint32_t> spirvBytes, const CrossCompileInfo &info)
+ParsedIR ParseSpirv(const uint32_t *words, size_t wordCount)
 {
-    switch (info.Target)
+    PhaseTimer timer(CompilePhase::Parse);
+    timer.AddBytes(wordCount * sizeof(uint32_t));
+    Parser parser(words, wordCount);
+    parser.parse();
+    return std::move(parser.get_parsed_ir());
+}
+
+ParsedIR ParseSpirv(const InteropArray<uint32_t> &spirv)
+{
+    return ParseSpirv(spirv.Data, spirv.Count);
+}
+
+// Runs the requested optimizer recipe over a module, if any, and parses the result.
+ParsedIR PrepareModule(
+    const CrossCompileInfo &info,
+    const InteropArray<uint32_t> &spirv,
+    const InteropArray<SpecializationConstant> &specializations)
+{
+    if (info.Optimization == SpirvOptimization::None)
+    {
+        return ParseSpirv(spirv);
+    }
+
+    std::vector<uint32_t> optimized = OptimizeSpirv(spirv.Data, spirv.Count, info.Optimization, specializations);
+    return ParseSpirv(optimized.data(), optimized.size());
+}
+
+// Prepares the module of every stage. For a vertex-fragment pair with PruneStageInterface set, the vertex
+// outputs the fragment shader never reads are pruned once both modules have been optimized.
+void PrepareStageModules(
+    const CrossCompileInfo &info,
+    const InteropArray<uint32_t> *const *inputs,
+    uint32_t stageCount,
+    const InteropArray<SpecializationConstant> &specializations,
+    ParsedIR *modules)
+{
+    if (stageCount != 2 || !info.PruneStageInterface)
+    {
+        for (uint32_t stage = 0; stage < stageCount; stage++)
+        {
+            modules[stage] = PrepareModule(info, *inputs[stage], specializations);
+        }
+        return;
+    }
+
+    std::vector<uint32_t> words[2];
+    for (uint32_t stage = 0; stage < 2; stage++)
+    {
+        const InteropArray<uint32_t> &spirv = *inputs[stage];
+        words[stage] = info.Optimization == SpirvOptimization::None
+            ? std::vector<uint32_t>(spirv.Data, spirv.Data + spirv.Count)
+            : OptimizeSpirv(spirv.Data, spirv.Count, info.Optimization, specializations);
+    }
+
+    words[0] = PruneVertexOutputs(words[0].data(), words[0].size(), words[1].data(), words[1].size());
+    for (uint32_t stage = 0; stage < 2; stage++)
+    {
+        modules[stage] = ParseSpirv(words[stage].data(), words[stage].size());
+    }
+}
+
+Compiler *GetCompiler(ParsedIR ir, CrossCompileTarget target, const CrossCompileInfo &info)
+{
+    if (info.MinifyOutput)
+    {
+        ClearInternalNames(ir);
+    }
+
+    switch (target)
     {
     case HLSL:
     {
-        auto ret = new CompilerHLSL(spirvBytes);
+#ifdef VD_NO_HLSL
+        ThrowFeatureUnavailable("HLSL output");
+#else
+        auto ret = new CompilerHLSL(std::move(ir));
         CompilerHLSL::Options opts = {};
         opts.shader_model = 50;
         opts.point_size_compat = true;
@@ -198,21 +294,22 @@ Compiler *GetCompiler(std::vector<uint32_t> spirvBytes, const CrossCompileInfo &
         commonOpts.vertex.fixup_clipspace = info.FixClipSpaceZ;
         ret->set_common_options(commonOpts);
         return ret;
+#endif
     }
     case GLSL:
     case ESSL:
     {
-        auto ret = new CompilerGLSL(spirvBytes);
+        auto ret = new CompilerGLSL(std::move(ir));
         CompilerGLSL::Options opts = {};
-        opts.es = info.Target == ESSL;
+        opts.es = target == ESSL;
         opts.enable_420pack_extension = false;
         if (info.ComputeShader.Count > 0)
         {
-            opts.version = info.Target == GLSL ? 430 : 310;
+            opts.version = target == GLSL ? 430 : 310;
         }
         else
         {
-            opts.version = info.Target == GLSL ? 330 : 300;
+            opts.version = target == GLSL ? 330 : 300;
         }
         opts.vertex.fixup_clipspace = info.FixClipSpaceZ;
         opts.vertex.flip_vert_y = info.InvertY;
@@ -221,7 +318,10 @@ Compiler *GetCompiler(std::vector<uint32_t> spirvBytes, const CrossCompileInfo &
     }
     case MSL:
     {
-        auto ret = new CompilerMSL(spirvBytes);
+#ifdef VD_NO_MSL
+        ThrowFeatureUnavailable("MSL output");
+#else
+        auto ret = new CompilerMSL(std::move(ir));
         CompilerMSL::Options opts = {};
         ret->set_msl_options(opts);
         CompilerGLSL::Options commonOpts;
@@ -229,122 +329,331 @@ Compiler *GetCompiler(std::vector<uint32_t> spirvBytes, const CrossCompileInfo &
         commonOpts.vertex.fixup_clipspace = info.FixClipSpaceZ;
         ret->set_common_options(commonOpts);
         return ret;
+#endif
     }
     default:
         throw std::runtime_error("Invalid OutputKind.");
     }
 }
 
-void SetSpecializations(spirv_cross::Compiler *compiler, const CrossCompileInfo &info)
+void SetSpecializations(spirv_cross::Compiler *compiler, const InteropArray<SpecializationConstant> &specializations)
 {
-    auto specConstants = compiler->get_specialization_constants();
-    for (uint32_t i = 0; i < info.Specializations.Count; i++)
+    if (specializations.Count == 0)
     {
-        uint32_t constID = info.Specializations[i].ID;
-        uint32_t varID = 0;
+        return;
+    }
+
+    std::unordered_map<uint32_t, uint32_t> varIDs;
+    for (auto &constant : compiler->get_specialization_constants())
+    {
+        varIDs[constant.constant_id] = constant.id;
+    }
+
+    for (uint32_t i = 0; i < specializations.Count; i++)
+    {
+        auto it = varIDs.find(specializations[i].ID);
+        if (it != varIDs.end())
+        {
+            auto &constVar = compiler->get_constant(it->second);
+            constVar.m.c[0].r[0].u64 = specializations[i].Constant;
+        }
+    }
+}
+
+// Flattens the collected resources into a table sorted by set, then binding.
+std::vector<SparseBindingInfo> CreateBindingTable(const std::map<BindingInfo, ResourceInfo> &resources, bool compute)
+{
+    std::vector<SparseBindingInfo> ret;
+    ret.reserve(resources.size());
+    for (auto &it : resources)
+    {
+        ShaderStages stages = ShaderStages::None;
+        if (it.second.IDs[0] != 0)
+        {
+            if (compute) { stages = stages | ShaderStages::Compute; }
+            else { stages = stages | ShaderStages::Vertex; }
+        }
+        if (it.second.IDs[1] != 0)
+        {
+            stages = stages | ShaderStages::Fragment;
+        }
+
+        SparseBindingInfo binding;
+        binding.Set = it.first.Set;
+        binding.Binding = it.first.Binding;
+        binding.Element.Name = it.second.Name;
+        binding.Element.Kind = it.second.Kind;
+        binding.Element.Stages = stages;
+        binding.Element.Options = 0;
+        ret.push_back(std::move(binding));
+    }
+
+    return ret;
+}
 
-        for (auto &constant : specConstants)
+// Expands a sorted binding table into one layout per set, from set 0 to the highest set used. Each layout
+// holds an element for every binding up to its highest one; the gaps are marked "Unused".
+std::vector<std::vector<ResourceElementInfo>> CreateResourceLayoutArray(const std::vector<SparseBindingInfo> &bindings)
+{
+    uint32_t setCount = bindings.empty() ? 1 : bindings.back().Set + 1;
+    std::vector<std::vector<ResourceElementInfo>> ret(setCount);
+    for (size_t i = 0; i < bindings.size(); i++)
+    {
+        // The last binding of each set is its highest one.
+        bool lastInSet = i + 1 == bindings.size() || bindings[i + 1].Set != bindings[i].Set;
+        if (lastInSet)
         {
-            if (constant.constant_id == constID)
+            std::vector<ResourceElementInfo> &layout = ret[bindings[i].Set];
+            layout.resize(bindings[i].Binding + 1);
+            for (ResourceElementInfo &element : layout)
             {
-                varID = constant.id;
+                element.Options = 2; // "Unused"
             }
         }
+    }
+
+    for (const SparseBindingInfo &binding : bindings)
+    {
+        ret[binding.Set][binding.Binding] = binding.Element;
+    }
+
+    return ret;
+}
+
+void SetResourceLayouts(
+    ReflectionData &reflection,
+    const std::map<BindingInfo, ResourceInfo> &resources,
+    bool compute,
+    bool sparse)
+{
+    std::vector<SparseBindingInfo> bindings = CreateBindingTable(resources, compute);
+    if (sparse)
+    {
+        reflection.SparseBindings = std::move(bindings);
+    }
+    else
+    {
+        reflection.ResourceLayouts = CreateResourceLayoutArray(bindings);
+    }
+}
+
+void AddStageResources(
+    ShaderResources &resources,
+    Compiler *compiler,
+    std::map<BindingInfo, ResourceInfo> &allResources,
+    const uint32_t idIndex,
+    bool normalizeResourceNames)
+{
+    AddResources(resources.uniform_buffers, compiler, allResources, idIndex, normalizeResourceNames);
+    AddResources(resources.storage_buffers, compiler, allResources, idIndex, normalizeResourceNames, false, true);
+    AddResources(resources.separate_images, compiler, allResources, idIndex, normalizeResourceNames, true, false);
+    AddResources(resources.storage_images, compiler, allResources, idIndex, normalizeResourceNames, true, true);
+    AddResources(resources.separate_samplers, compiler, allResources, idIndex, normalizeResourceNames);
+}
 
-        if (varID != 0)
+// The names other code binds to: resources and their block types, stage inputs and outputs, and the
+// combined image samplers built for GLSL.
+std::unordered_set<std::string> GetInterfaceNames(const Compiler *compiler, const ShaderResources &resources)
+{
+    std::unordered_set<std::string> names;
+    auto addName = [&](uint32_t id)
+    {
+        const std::string &name = compiler->get_name(id);
+        names.insert(name.empty() ? compiler->get_fallback_name(id) : name);
+    };
+
+    const SmallVector<Resource> *lists[] =
+    {
+        &resources.uniform_buffers, &resources.storage_buffers, &resources.stage_inputs, &resources.stage_outputs,
+        &resources.storage_images, &resources.sampled_images, &resources.push_constant_buffers,
+        &resources.separate_images, &resources.separate_samplers,
+    };
+    for (const SmallVector<Resource> *list : lists)
+    {
+        for (const Resource &resource : *list)
         {
-            auto &constVar = compiler->get_constant(varID);
-            constVar.m.c[0].r[0].u64 = info.Specializations[i].Constant;
+            addName(resource.id);
+            addName(resource.base_type_id);
         }
     }
+    for (auto &remap : compiler->get_combined_image_samplers())
+    {
+        addName(remap.combined_id);
+    }
+
+    return names;
 }
 
-InteropArray<ResourceLayoutDescription> CreateResourceLayoutArray(
-    std::map<BindingInfo, ResourceInfo> resources,
-    bool compute)
+// The number of consecutive locations taken up by an interface variable of the given type.
+uint32_t GetLocationCount(const Compiler &compiler, const SPIRType &type)
 {
-    uint32_t currentSet = 0;
-    std::vector<uint32_t> setSizes(1);
-    for (auto& it : resources)
+    uint32_t count = 0;
+    if (type.basetype == SPIRType::Struct)
     {
-        uint32_t set = it.first.Set;
-        if (setSizes.size() <= set)
+        for (uint32_t memberType : type.member_types)
         {
-            setSizes.resize(set + 1);
+            count += GetLocationCount(compiler, compiler.get_type(memberType));
         }
-        setSizes[set] = std::max(setSizes[set], it.first.Binding + 1);
+    }
+    else
+    {
+        // 64-bit vectors with more than two components take two locations each.
+        bool wide = type.width == 64 && type.vecsize > 2;
+        count = type.columns * (wide ? 2 : 1);
     }
 
-    uint32_t setCount = setSizes.size();
-    InteropArray<ResourceLayoutDescription> ret(setCount);
+    for (size_t i = 0; i < type.array.size(); i++)
+    {
+        count *= type.array_size_literal[i] ? type.array[i] : compiler.evaluate_constant_u32(type.array[i]);
+    }
+
+    return count;
+}
 
-    for (uint32_t i = 0; i < setCount; i++)
+// Links the interface between the vertex outputs, as pruned by PruneVertexOutputs, and the fragment
+// inputs. Fragment inputs which are never read are hidden, since nothing writes them any longer. The
+// remaining variables of both stages are then moved to consecutive locations from zero, keeping their
+// order and any sharing of locations between component-packed variables.
+void LinkStageInterface(
+    Compiler &vsCompiler,
+    const ShaderResources &vsResources,
+    Compiler &fsCompiler,
+    const ShaderResources &fsResources)
+{
+    std::unordered_set<VariableID> activeVariables = fsCompiler.get_active_interface_variables();
+    std::unordered_set<VariableID> enabledVariables = activeVariables;
+    const SmallVector<Resource> *fsLists[] =
+    {
+        &fsResources.uniform_buffers,
+        &fsResources.storage_buffers,
+        &fsResources.stage_outputs,
+        &fsResources.subpass_inputs,
+        &fsResources.storage_images,
+        &fsResources.sampled_images,
+        &fsResources.atomic_counters,
+        &fsResources.acceleration_structures,
+        &fsResources.push_constant_buffers,
+        &fsResources.separate_images,
+        &fsResources.separate_samplers,
+    };
+    for (const SmallVector<Resource> *list : fsLists)
     {
-        ret[i].ResourceElements.Resize(setSizes[i]);
-        for (uint32_t j = 0; j < setSizes[i]; j++)
+        for (const Resource &resource : *list)
         {
-            ret[i].ResourceElements[j].Name = InteropArray<char>();
-            ret[i].ResourceElements[j].Kind = ResourceKind::UniformBuffer;
-            ret[i].ResourceElements[j].Stages = ShaderStages::None;
-            ret[i].ResourceElements[j].Options = 2; // "Unused"
+            enabledVariables.insert(resource.id);
         }
     }
+    fsCompiler.set_enabled_interface_variables(std::move(enabledVariables));
 
-    for (auto& it : resources)
+    std::vector<std::pair<Compiler *, const Resource *>> variables;
+    for (const Resource &output : vsResources.stage_outputs)
     {
-        ShaderStages stages = ShaderStages::None;
-        if (it.second.IDs[0] != 0)
+        variables.emplace_back(&vsCompiler, &output);
+    }
+    for (const Resource &input : fsResources.stage_inputs)
+    {
+        if (activeVariables.count(input.id) != 0)
         {
-            if (compute) { stages = stages | ShaderStages::Compute; }
-            else { stages = stages | ShaderStages::Vertex; }
+            variables.emplace_back(&fsCompiler, &input);
         }
-        if (it.second.IDs[1] != 0)
+    }
+
+    // Locations of block members are left alone.
+    std::map<uint32_t, uint32_t> locationCounts; // First location -> number of locations
+    for (auto &variable : variables)
+    {
+        if (!variable.first->has_decoration(variable.second->id, spv::Decoration::DecorationLocation))
         {
-            stages = stages | ShaderStages::Fragment;
+            return;
         }
 
-        ret[it.first.Set].ResourceElements[it.first.Binding].Name.CopyFrom(it.second.Name.length(), it.second.Name.c_str());
-        ret[it.first.Set].ResourceElements[it.first.Binding].Kind = it.second.Kind;
-        ret[it.first.Set].ResourceElements[it.first.Binding].Stages = stages;
-        ret[it.first.Set].ResourceElements[it.first.Binding].Options = 0;
+        uint32_t location = variable.first->get_decoration(variable.second->id, spv::Decoration::DecorationLocation);
+        uint32_t count = GetLocationCount(*variable.first, variable.first->get_type(variable.second->type_id));
+        locationCounts[location] = std::max(locationCounts[location], count);
     }
 
-    return ret;
+    std::map<uint32_t, uint32_t> newLocations;
+    uint32_t rangeStart = 0;
+    uint32_t rangeEnd = 0;
+    uint32_t newRangeStart = 0;
+    for (auto &it : locationCounts)
+    {
+        if (it.first >= rangeEnd)
+        {
+            newRangeStart += rangeEnd - rangeStart;
+            rangeStart = it.first;
+            rangeEnd = it.first;
+        }
+
+        newLocations[it.first] = newRangeStart + it.first - rangeStart;
+        rangeEnd = std::max(rangeEnd, it.first + it.second);
+    }
+
+    for (auto &variable : variables)
+    {
+        uint32_t location = variable.first->get_decoration(variable.second->id, spv::Decoration::DecorationLocation);
+        variable.first->set_decoration(variable.second->id, spv::Decoration::DecorationLocation, newLocations[location]);
+    }
 }
 
-CompilationResult *CompileVertexFragment(const CrossCompileInfo &info)
+std::string EmitStageText(Compiler *compiler, const ShaderResources &resources, CrossCompileTarget target, bool minify)
 {
-    std::vector<uint32_t> vsBytes(
-        info.VertexShader.Data,
-        info.VertexShader.Data + info.VertexShader.Count);
-    Compiler *vsCompiler = GetCompiler(vsBytes, info);
+    PhaseTimer timer(CompilePhase::Emit);
+    std::string text = compiler->compile();
+    timer.AddBytes(text.size());
+
+    bool usesStorageResource = resources.storage_buffers.size() > 0 || resources.storage_images.size() > 0;
+    if ((target == GLSL || target == ESSL) && usesStorageResource)
+    {
+        std::string key = target == GLSL ? "#version 330" : "#version 300";
+        size_t position = text.find(key);
+        if (position != std::string::npos)
+        {
+            text.replace(position, key.length(), target == GLSL ? "#version 430" : "#version 310");
+        }
+    }
+
+    if (minify)
+    {
+        text = MinifyShaderText(text, GetInterfaceNames(compiler, resources));
+    }
 
-    std::vector<uint32_t> fsBytes(
-        info.FragmentShader.Data,
-        info.FragmentShader.Data + info.FragmentShader.Count);
-    Compiler *fsCompiler = GetCompiler(fsBytes, info);
+    return text;
+}
 
-    SetSpecializations(vsCompiler, info);
-    SetSpecializations(fsCompiler, info);
+void CompileVertexFragment(
+    const CrossCompileInfo &info,
+    const CompileJob &job,
+    ParsedIR vsIR,
+    ParsedIR fsIR,
+    OutputWriter &output,
+    uint32_t firstOutput,
+    ReflectionData *reflection)
+{
+    CrossCompileTarget target = job.Target;
+    PhaseTimer timer(CompilePhase::Parse);
+    std::unique_ptr<Compiler> vsCompiler(GetCompiler(std::move(vsIR), target, info));
+    std::unique_ptr<Compiler> fsCompiler(GetCompiler(std::move(fsIR), target, info));
 
+    SetSpecializations(vsCompiler.get(), *job.Specializations);
+    SetSpecializations(fsCompiler.get(), *job.Specializations);
+
+    timer.Switch(CompilePhase::CollectResources);
     ShaderResources vsResources = vsCompiler->get_shader_resources();
     ShaderResources fsResources = fsCompiler->get_shader_resources();
 
     std::map<BindingInfo, ResourceInfo> allResources;
 
-    AddResources(vsResources.uniform_buffers, vsCompiler, allResources, 0, info.NormalizeResourceNames);
-    AddResources(vsResources.storage_buffers, vsCompiler, allResources, 0, info.NormalizeResourceNames, false, true);
-    AddResources(vsResources.separate_images, vsCompiler, allResources, 0, info.NormalizeResourceNames, true, false);
-    AddResources(vsResources.storage_images, vsCompiler, allResources, 0, info.NormalizeResourceNames, true, true);
-    AddResources(vsResources.separate_samplers, vsCompiler, allResources, 0, info.NormalizeResourceNames);
+    AddStageResources(vsResources, vsCompiler.get(), allResources, 0, info.NormalizeResourceNames);
+    AddStageResources(fsResources, fsCompiler.get(), allResources, 1, info.NormalizeResourceNames);
 
-    AddResources(fsResources.uniform_buffers, fsCompiler, allResources, 1, info.NormalizeResourceNames);
-    AddResources(fsResources.storage_buffers, fsCompiler, allResources, 1, info.NormalizeResourceNames, false, true);
-    AddResources(fsResources.separate_images, fsCompiler, allResources, 1, info.NormalizeResourceNames, true, false);
-    AddResources(fsResources.storage_images, fsCompiler, allResources, 1, info.NormalizeResourceNames, true, true);
-    AddResources(fsResources.separate_samplers, fsCompiler, allResources, 1, info.NormalizeResourceNames);
+    timer.Switch(CompilePhase::RemapBindings);
+    if (info.PruneStageInterface)
+    {
+        LinkStageInterface(*vsCompiler, vsResources, *fsCompiler, fsResources);
+    }
 
-    if (info.Target == HLSL || info.Target == MSL)
+    if (target == HLSL || target == MSL)
     {
         uint32_t bufferIndex = 0;
         uint32_t textureIndex = 0;
@@ -352,7 +661,7 @@ CompilationResult *CompileVertexFragment(const CrossCompileInfo &info)
         uint32_t samplerIndex = 0;
         for (auto &it : allResources)
         {
-            uint32_t index = GetResourceIndex(info.Target, it.second.Kind, bufferIndex, textureIndex, uavIndex, samplerIndex);
+            uint32_t index = GetResourceIndex(target, it.second.Kind, bufferIndex, textureIndex, uavIndex, samplerIndex);
 
             uint32_t vsID = it.second.IDs[0];
             if (vsID != 0)
@@ -367,7 +676,7 @@ CompilationResult *CompileVertexFragment(const CrossCompileInfo &info)
         }
     }
 
-    if (info.Target == GLSL || info.Target == ESSL)
+    if (target == GLSL || target == ESSL)
     {
         vsCompiler->build_dummy_sampler_for_combined_images();
         vsCompiler->build_combined_image_samplers();
@@ -398,7 +707,7 @@ CompilationResult *CompileVertexFragment(const CrossCompileInfo &info)
         }
     }
 
-    if (info.Target == ESSL)
+    if (target == ESSL)
     {
         for (auto &uniformBuffer : vsResources.uniform_buffers)
         {
@@ -436,70 +745,49 @@ CompilationResult *CompileVertexFragment(const CrossCompileInfo &info)
         }
     }
 
-    std::string vsText = vsCompiler->compile();
-
-    bool usesStorageResource = vsResources.storage_buffers.size() > 0 || vsResources.storage_images.size() > 0;
-    if (info.Target == GLSL && usesStorageResource)
-    {
-        std::string key = "#version 330";
-        vsText.replace(vsText.find(key), key.length(), "#version 430");
-    }
-    else if (info.Target == ESSL && usesStorageResource)
+    // Everything above mutates both compilers; from here on each stage is emitted from its own
+    // compiler only, so the two stages can be generated concurrently.
+    timer.Stop();
+    Compiler *stageCompilers[2] = { vsCompiler.get(), fsCompiler.get() };
+    const ShaderResources *stageResources[2] = { &vsResources, &fsResources };
+    GetWorkerPool()->ParallelFor(2, [&](uint32_t i)
     {
-        std::string key = "#version 300";
-        vsText.replace(vsText.find(key), key.length(), "#version 310");
-    }
+        output.Submit(
+            firstOutput + i,
+            EmitStageText(stageCompilers[i], *stageResources[i], target, info.MinifyOutput));
+    });
 
-    std::string fsText = fsCompiler->compile();
-
-    usesStorageResource = fsResources.storage_buffers.size() > 0 || fsResources.storage_images.size() > 0;
-    if (info.Target == GLSL && usesStorageResource)
-    {
-        std::string key = "#version 330";
-        fsText.replace(vsText.find(key), key.length(), "#version 430");
-    }
-    else if (info.Target == ESSL && usesStorageResource)
+    if (reflection != nullptr)
     {
-        std::string key = "#version 300";
-        fsText.replace(vsText.find(key), key.length(), "#version 310");
+        timer.Switch(CompilePhase::CollectResources);
+        ReflectVertexInfo(*vsCompiler, vsResources, *reflection);
+        SetResourceLayouts(*reflection, allResources, false, info.SparseResourceLayouts);
     }
-
-    CompilationResult *result = new CompilationResult();
-    result->Succeeded = true;
-
-    result->DataBuffers.Resize(2);
-    result->DataBuffers[0].CopyFrom(static_cast<uint32_t>(vsText.length()), (uint8_t *)vsText.c_str());
-    result->DataBuffers[1].CopyFrom(static_cast<uint32_t>(fsText.length()), (uint8_t *)fsText.c_str());
-
-    ReflectVertexInfo(*vsCompiler, vsResources, result->Reflection);
-    result->Reflection.ResourceLayouts = CreateResourceLayoutArray(allResources, false);
-
-    delete vsCompiler;
-    delete fsCompiler;
-
-    return result;
 }
 
-CompilationResult *CompileCompute(const CrossCompileInfo &info)
+void CompileCompute(
+    const CrossCompileInfo &info,
+    const CompileJob &job,
+    ParsedIR csIR,
+    OutputWriter &output,
+    uint32_t firstOutput,
+    ReflectionData *reflection)
 {
-    std::vector<uint32_t> csBytes(
-        info.ComputeShader.Data,
-        info.ComputeShader.Data + info.ComputeShader.Count);
-    Compiler *csCompiler = GetCompiler(csBytes, info);
+    CrossCompileTarget target = job.Target;
+    PhaseTimer timer(CompilePhase::Parse);
+    std::unique_ptr<Compiler> csCompiler(GetCompiler(std::move(csIR), target, info));
 
-    SetSpecializations(csCompiler, info);
+    SetSpecializations(csCompiler.get(), *job.Specializations);
 
+    timer.Switch(CompilePhase::CollectResources);
     ShaderResources csResources = csCompiler->get_shader_resources();
 
     std::map<BindingInfo, ResourceInfo> allResources;
 
-    AddResources(csResources.uniform_buffers, csCompiler, allResources, 0, info.NormalizeResourceNames);
-    AddResources(csResources.storage_buffers, csCompiler, allResources, 0, info.NormalizeResourceNames, false, true);
-    AddResources(csResources.separate_images, csCompiler, allResources, 0, info.NormalizeResourceNames, true, false);
-    AddResources(csResources.storage_images, csCompiler, allResources, 0, info.NormalizeResourceNames, true, true);
-    AddResources(csResources.separate_samplers, csCompiler, allResources, 0, info.NormalizeResourceNames);
+    AddStageResources(csResources, csCompiler.get(), allResources, 0, info.NormalizeResourceNames);
 
-    if (info.Target == HLSL || info.Target == MSL)
+    timer.Switch(CompilePhase::RemapBindings);
+    if (target == HLSL || target == MSL)
     {
         uint32_t bufferIndex = 0;
         uint32_t textureIndex = 0;
@@ -507,7 +795,7 @@ CompilationResult *CompileCompute(const CrossCompileInfo &info)
         uint32_t samplerIndex = 0;
         for (auto &it : allResources)
         {
-            uint32_t index = GetResourceIndex(info.Target, it.second.Kind, bufferIndex, textureIndex, uavIndex, samplerIndex);
+            uint32_t index = GetResourceIndex(target, it.second.Kind, bufferIndex, textureIndex, uavIndex, samplerIndex);
 
             uint32_t csID = it.second.IDs[0];
             if (csID != 0)
@@ -517,7 +805,7 @@ CompilationResult *CompileCompute(const CrossCompileInfo &info)
         }
     }
 
-    if (info.Target == GLSL || info.Target == ESSL)
+    if (target == GLSL || target == ESSL)
     {
         csCompiler->build_dummy_sampler_for_combined_images();
         csCompiler->build_combined_image_samplers();
@@ -527,7 +815,7 @@ CompilationResult *CompileCompute(const CrossCompileInfo &info)
         }
     }
 
-    if (info.Target == ESSL)
+    if (target == ESSL)
     {
         for (auto &uniformBuffer : csResources.uniform_buffers)
         {
@@ -549,48 +837,209 @@ CompilationResult *CompileCompute(const CrossCompileInfo &info)
         }
     }
 
-    std::string csText = csCompiler->compile();
+    timer.Switch(CompilePhase::Emit);
+    std::string text = csCompiler->compile();
+    timer.AddBytes(text.size());
+    if (info.MinifyOutput)
+    {
+        text = MinifyShaderText(text, GetInterfaceNames(csCompiler.get(), csResources));
+    }
+    timer.Stop();
+    output.Submit(firstOutput, std::move(text));
+
+    if (reflection != nullptr)
+    {
+        timer.Switch(CompilePhase::CollectResources);
+        SetResourceLayouts(*reflection, allResources, true, info.SparseResourceLayouts);
+    }
+}
+
+uint32_t GetStageCount(const CrossCompileInfo &info)
+{
+    if (info.VertexShader.Count > 0 && info.FragmentShader.Count > 0)
+    {
+        return 2;
+    }
+
+    return info.ComputeShader.Count > 0 ? 1 : 0;
+}
+
+void CompileJobs(
+    const CrossCompileInfo &info,
+    const CompileJob *jobs,
+    uint32_t jobCount,
+    OutputWriter &output,
+    uint32_t firstOutput,
+    ReflectionData &reflectionData)
+{
+    uint32_t stageCount = GetStageCount(info);
+    bool vertexFragment = stageCount == 2;
+    const InteropArray<uint32_t> *inputs[2] = { &info.VertexShader, &info.FragmentShader };
+    if (!vertexFragment)
+    {
+        inputs[0] = &info.ComputeShader;
+    }
+
+    // Freezing bakes a job's specialization values into its module, so jobs with their own values
+    // cannot share one.
+    bool perJobModules = info.Optimization == SpirvOptimization::FreezeSpecializations && jobCount > 1;
+    ParsedIR modules[2];
+    if (!perJobModules)
+    {
+        PrepareStageModules(info, inputs, stageCount, *jobs[0].Specializations, modules);
+    }
+
+    GetWorkerPool()->ParallelFor(jobCount, [&](uint32_t j)
+    {
+        // A single job can take ownership of the parsed modules; otherwise each job works on a copy.
+        ParsedIR stageModules[2];
+        if (perJobModules)
+        {
+            PrepareStageModules(info, inputs, stageCount, *jobs[j].Specializations, stageModules);
+        }
+        else
+        {
+            for (uint32_t stage = 0; stage < stageCount; stage++)
+            {
+                if (jobCount == 1)
+                {
+                    stageModules[stage] = std::move(modules[stage]);
+                }
+                else
+                {
+                    stageModules[stage] = modules[stage];
+                }
+            }
+        }
+
+        uint32_t jobOutput = firstOutput + j * stageCount;
+        ReflectionData *reflection = j == 0 ? &reflectionData : nullptr;
+        if (vertexFragment)
+        {
+            CompileVertexFragment(
+                info,
+                jobs[j],
+                std::move(stageModules[0]),
+                std::move(stageModules[1]),
+                output,
+                jobOutput,
+                reflection);
+        }
+        else
+        {
+            CompileCompute(info, jobs[j], std::move(stageModules[0]), output, jobOutput, reflection);
+        }
+    });
+}
+
+// Gathers the same reflection data as a compilation, but only collects resources: nothing is renamed,
+// remapped or emitted. Any of the vertex, fragment and compute stages may be given on their own.
+CompilationResult *ReflectShaders(const CrossCompileInfo &info)
+{
+    const InteropArray<uint32_t> *stageModules[3] = { &info.VertexShader, &info.FragmentShader, &info.ComputeShader };
+    bool compute = info.ComputeShader.Count > 0;
+    if (compute ? info.VertexShader.Count > 0 || info.FragmentShader.Count > 0
+                : info.VertexShader.Count == 0 && info.FragmentShader.Count == 0)
+    {
+        return CreateErrorResult("The given combination of shaders was not valid.");
+    }
 
-    delete csCompiler;
+    std::unique_ptr<Compiler> compilers[3];
+    ShaderResources resources[3];
+    GetWorkerPool()->ParallelFor(3, [&](uint32_t stage)
+    {
+        if (stageModules[stage]->Count > 0)
+        {
+            compilers[stage].reset(new Compiler(PrepareModule(info, *stageModules[stage], info.Specializations)));
+            SetSpecializations(compilers[stage].get(), info.Specializations);
+            PhaseTimer timer(CompilePhase::CollectResources);
+            resources[stage] = compilers[stage]->get_shader_resources();
+        }
+    });
 
-    CompilationResult *result = new CompilationResult();
-    result->Succeeded = true;
-    result->DataBuffers.Resize(1);
-    result->DataBuffers[0].CopyFrom(static_cast<uint32_t>(csText.length()), (uint8_t *)csText.c_str());
+    std::map<BindingInfo, ResourceInfo> allResources;
+    for (uint32_t stage = 0; stage < 3; stage++)
+    {
+        if (compilers[stage] != nullptr)
+        {
+            uint32_t idIndex = stage == 1 ? 1 : 0;
+            AddStageResources(resources[stage], compilers[stage].get(), allResources, idIndex, info.NormalizeResourceNames);
+        }
+    }
 
-    result->Reflection.ResourceLayouts = CreateResourceLayoutArray(allResources, true);
+    ReflectionData reflection;
+    if (compilers[0] != nullptr)
+    {
+        ReflectVertexInfo(*compilers[0], resources[0], reflection);
+    }
+    SetResourceLayouts(reflection, allResources, compute, info.SparseResourceLayouts);
 
+    CompilationResult *result = CreateResult(nullptr, 0, &reflection);
+    result->Fingerprint = FingerprintStages(info);
     return result;
 }
 
-CompilationResult *Compile(const CrossCompileInfo &info)
+// Parses each input module once and emits it for every job. The outputs are stored job-major: all
+// stages of jobs[0], then all stages of jobs[1], and so on. Reflection data is only gathered for the
+// first job. When a sink is given, the outputs are written to it as they are produced and the result
+// has no data buffers.
+CompilationResult *Compile(
+    const CrossCompileInfo &info,
+    const CompileJob *jobs,
+    uint32_t jobCount,
+    const OutputSink *sink = nullptr)
 {
-    if (info.VertexShader.Count > 0 && info.FragmentShader.Count > 0)
+    uint32_t stageCount = GetStageCount(info);
+    if (jobCount == 0 || stageCount == 0)
     {
-        return CompileVertexFragment(info);
+        return CreateErrorResult("The given combination of shaders was not valid.");
     }
-    else if (info.ComputeShader.Count > 0)
+
+    ReflectionData reflectionData;
+    OutputWriter output(stageCount * jobCount, sink);
+    CompileJobs(info, jobs, jobCount, output, 0, reflectionData);
+
+    std::vector<ByteSpan> dataBuffers = output.GetDataBuffers();
+    CompilationResult *result = CreateResult(dataBuffers.data(), static_cast<uint32_t>(dataBuffers.size()), &reflectionData);
+    result->Fingerprint = FingerprintStages(info);
+    return result;
+}
+
+CompilationResult *Compile(
+    const CrossCompileInfo &info,
+    const CrossCompileTarget *targets,
+    uint32_t targetCount,
+    const OutputSink *sink = nullptr)
+{
+    std::vector<CompileJob> jobs(targetCount);
+    for (uint32_t i = 0; i < targetCount; i++)
     {
-        return CompileCompute(info);
+        jobs[i].Target = targets[i];
+        jobs[i].Specializations = &info.Specializations;
     }
 
-    return new CompilationResult("The given combination of shaders was not valid.");
+    return Compile(info, jobs.data(), targetCount, sink);
 }
 
-std::vector<uint32_t> ReadFile(std::string path)
+CompilationResult *Compile(const CrossCompileInfo &info)
 {
-    std::ifstream is(path, std::ios::binary | std::ios::in | std::ios::ate);
-    size_t size = is.tellg();
-    is.seekg(0, std::ios::beg);
-    char *shaderCode = new char[size];
-    is.read(shaderCode, size);
-    is.close();
+    return Compile(info, &info.Target, 1);
+}
 
-    std::vector<uint32_t> ret(size / 4);
-    memcpy(ret.data(), shaderCode, size);
+// Points the array at the words of a mapped SPIR-V file. The array does not take ownership.
+void BorrowSpirvFile(const MappedFile &file, const std::string &path, InteropArray<uint32_t> &spirv)
+{
+    if (file.GetSize() < sizeof(uint32_t) || file.GetSize() % sizeof(uint32_t) != 0)
+    {
+        throw std::runtime_error("File \"" + path + "\" is not a valid SPIR-V module.");
+    }
 
-    delete[] shaderCode;
-    return ret;
+    spirv.Count = static_cast<uint32_t>(file.GetSize() / sizeof(uint32_t));
+    spirv.Data = reinterpret_cast<uint32_t *>(const_cast<uint8_t *>(file.GetData()));
+    if (spirv.Data[0] != 0x07230203)
+    {
+        throw std::runtime_error("File \"" + path + "\" does not start with the SPIR-V magic number.");
+    }
 }
 
 void WriteToFile(const std::string &path, const std::string &text)
@@ -600,85 +1049,518 @@ void WriteToFile(const std::string &path, const std::string &text)
     outFile.close();
 }
 
-CompilationResult *CompileGLSLToSPIRV(
-    const std::string sourceText,
-    shaderc_shader_kind kind,
-    std::string fileName,
-    const shaderc::CompileOptions &options)
+VD_EXPORT CompilationResult *CrossCompile(CrossCompileInfo *info)
 {
-    shaderc::Compiler compiler;
-    shaderc::SpvCompilationResult result = compiler.CompileGlslToSpv(sourceText, kind, fileName.c_str(), options);
+    CallTimer call("CrossCompile");
+    try
+    {
+        CompilationResult *remoteResult = GetCompileClient().CrossCompile(*info);
+        if (remoteResult != nullptr)
+        {
+            return remoteResult;
+        }
+
+        ResultCache &cache = GetCrossCompileCache();
+        if (!cache.IsEnabled())
+        {
+            return Compile(*info);
+        }
 
-    if (result.GetCompilationStatus() != shaderc_compilation_status_success)
+        ResultCacheKey key = CreateCacheKey(*info);
+        CompilationResult *result = cache.Find(key);
+        if (result == nullptr)
+        {
+            result = cache.Insert(std::move(key), Compile(*info));
+        }
+
+        return result;
+    }
+    catch (const std::exception &e)
     {
-        return new CompilationResult(result.GetErrorMessage());
+        return CreateErrorResult(e.what());
     }
+}
 
-    uint32_t length = static_cast<uint32_t>(result.end() - result.begin()) * sizeof(uint32_t);
-    CompilationResult *ret = new CompilationResult();
-    ret->Succeeded = 1;
-    ret->DataBuffers.Resize(1);
-    ret->DataBuffers[0].CopyFrom(length, (uint8_t *)result.begin());
-    return ret;
+// Cross-compiles SPIR-V modules read straight from memory-mapped files. The shader arrays of the given
+// info are ignored; any of the UTF-8 encoded paths may be null.
+VD_EXPORT CompilationResult *CrossCompileFiles(
+    CrossCompileInfo *info,
+    const char *vertexShaderPath,
+    const char *fragmentShaderPath,
+    const char *computeShaderPath)
+{
+    try
+    {
+        Borrowed<CrossCompileInfo> borrowed(*info);
+        const char *paths[3] = { vertexShaderPath, fragmentShaderPath, computeShaderPath };
+        InteropArray<uint32_t> *arrays[3] =
+        {
+            &borrowed.Value.VertexShader,
+            &borrowed.Value.FragmentShader,
+            &borrowed.Value.ComputeShader
+        };
+        std::unique_ptr<MappedFile> files[3];
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            arrays[i]->Count = 0;
+            arrays[i]->Data = nullptr;
+            if (paths[i] != nullptr)
+            {
+                files[i].reset(new MappedFile(paths[i]));
+                BorrowSpirvFile(*files[i], paths[i], *arrays[i]);
+            }
+        }
+
+        return CrossCompile(&borrowed.Value);
+    }
+    catch (const std::exception &e)
+    {
+        return CreateErrorResult(e.what());
+    }
 }
 
-VD_EXPORT CompilationResult *CrossCompile(CrossCompileInfo *info)
+VD_EXPORT CompilationResult *CrossCompileMultiTarget(
+    CrossCompileInfo *info,
+    CrossCompileTarget *targets,
+    uint32_t targetCount)
 {
+    CallTimer call("CrossCompileMultiTarget");
     try
     {
-        return Compile(*info);
+        return Compile(*info, targets, targetCount);
     }
     catch (const std::exception &e)
     {
-        return new CompilationResult(e.what());
+        return CreateErrorResult(e.what());
     }
 }
 
-VD_EXPORT CompilationResult *CompileGlslToSpirv(GlslCompileInfo *info)
+// Emits the modules of the given info once for each specialization set, parsing them only once. The
+// outputs are stored set-major, and the reflection data is that of the first set. The Specializations of
+// the info itself are ignored.
+VD_EXPORT CompilationResult *CrossCompileSpecializations(
+    CrossCompileInfo *info,
+    InteropArray<SpecializationConstant> *specializationSets,
+    uint32_t setCount)
 {
+    CallTimer call("CrossCompileSpecializations");
     try
     {
-        shaderc::CompileOptions options;
+        std::vector<CompileJob> jobs(setCount);
+        for (uint32_t i = 0; i < setCount; i++)
+        {
+            jobs[i].Target = info->Target;
+            jobs[i].Specializations = &specializationSets[i];
+        }
+
+        return Compile(*info, jobs.data(), setCount);
+    }
+    catch (const std::exception &e)
+    {
+        return CreateErrorResult(e.what());
+    }
+}
+
+VD_EXPORT VariantMatrixResult *CompileVariantMatrix(VariantMatrixInfo *info)
+{
+    CallTimer call("CompileVariantMatrix");
+    return RunVariantMatrix(*info);
+}
+
+VD_EXPORT void FreeVariantMatrixResult(VariantMatrixResult *result)
+{
+    DestroyVariantMatrixResult(result);
+}
+
+// Returns only the reflection data of the given shaders, without generating any code. The Target of the
+// info is ignored and the result has no data buffers.
+VD_EXPORT CompilationResult *Reflect(CrossCompileInfo *info)
+{
+    CallTimer call("Reflect");
+    try
+    {
+        return ReflectShaders(*info);
+    }
+    catch (const std::exception &e)
+    {
+        return CreateErrorResult(e.what());
+    }
+}
+
+// Streams the generated shader text to the given sink instead of returning it. The returned result only
+// holds the reflection data and has no data buffers.
+VD_EXPORT CompilationResult *CrossCompileToSink(CrossCompileInfo *info, OutputSink *sink)
+{
+    CallTimer call("CrossCompileToSink");
+    try
+    {
+        return Compile(*info, &info->Target, 1, sink);
+    }
+    catch (const std::exception &e)
+    {
+        return CreateErrorResult(e.what());
+    }
+}
 
-        if (info->Debug)
+VD_EXPORT void CrossCompileBatch(CrossCompileInfo *infos, uint32_t count, CompilationResult **results)
+{
+    std::fill(results, results + count, nullptr);
+    try
+    {
+        std::shared_ptr<ThreadPool> pool = GetWorkerPool();
+        pool->ParallelFor(count, [infos, results](uint32_t i) { results[i] = CrossCompile(&infos[i]); });
+    }
+    catch (const std::exception &e)
+    {
+        for (uint32_t i = 0; i < count; i++)
         {
-            options.SetGenerateDebugInfo();
+            if (results[i] == nullptr)
+            {
+                results[i] = CreateErrorResult(e.what());
+            }
         }
-        else
+    }
+}
+
+VD_EXPORT void SetWorkerThreadCount(uint32_t threadCount)
+{
+    SetWorkerPoolThreadCount(threadCount);
+}
+
+// Forwards CrossCompile and CompileGlslToSpirv calls to the compile server listening on the given Unix
+// domain socket. Calls are compiled locally while the server cannot be reached. A null or empty path
+// turns forwarding off. The initial path comes from the VELDRID_SPIRV_COMPILE_SERVER environment variable.
+VD_EXPORT void SetCompileServer(const char *socketPath)
+{
+    GetCompileClient().SetSocketPath(socketPath != nullptr ? socketPath : "");
+}
+
+VD_EXPORT CompilationResult *CompileGlslToSpirv(GlslCompileInfo *info)
+{
+    CallTimer call("CompileGlslToSpirv");
+    try
+    {
+        CompilationResult *remoteResult = GetCompileClient().CompileGlslToSpirv(*info);
+        if (remoteResult != nullptr)
         {
-            options.SetOptimizationLevel(shaderc_optimization_level_performance);
+            return remoteResult;
         }
 
-        for (uint32_t i = 0; i < info->Macros.Count; i++)
+#ifdef VD_NO_GLSL_FRONTEND
+        ThrowFeatureUnavailable("GLSL compilation");
+#else
+        static ShadercCompilerPool compilers;
+        shaderc::CompileOptions options;
+        SetDebugOption(options, info->Debug);
+        AddMacroDefinitions(options, info->Macros);
+        return CompileGLSLToSPIRV(compilers, *info, options, info->Debug);
+#endif
+    }
+    catch (const std::exception &e)
+    {
+        return CreateErrorResult(e.what());
+    }
+}
+
+// Enables the on-disk SPIR-V cache used by GLSL compilation, stored in the given existing directory. A null
+// or empty path disables it.
+VD_EXPORT void SetGlslCompileCacheDirectory(const char *directory)
+{
+    GetSpirvDiskCache().SetDirectory(directory != nullptr ? directory : "");
+}
+
+// Controls whether #include'd files are memory-mapped instead of read into memory.
+VD_EXPORT void SetIncludeFileMapping(Bool32 enabled)
+{
+    GetIncludeFileCache().SetFileMapping(enabled);
+}
+
+VD_EXPORT void ClearIncludeFileCache()
+{
+    GetIncludeFileCache().Clear();
+}
+
+VD_EXPORT GlslCompilerSession *CreateGlslCompilerSession(GlslSessionInfo *info)
+{
+    try
+    {
+#ifdef VD_NO_GLSL_FRONTEND
+        ThrowFeatureUnavailable("GLSL compilation");
+#else
+        return new GlslCompilerSession(*info);
+#endif
+    }
+    catch (const std::exception &)
+    {
+        return nullptr;
+    }
+}
+
+// Compiles with the session's base options. The Debug flag and macros of the given info are applied on
+// top of them.
+VD_EXPORT CompilationResult *CompileGlslToSpirvWithSession(GlslCompilerSession *session, GlslCompileInfo *info)
+{
+    CallTimer call("CompileGlslToSpirvWithSession");
+    try
+    {
+#ifdef VD_NO_GLSL_FRONTEND
+        ThrowFeatureUnavailable("GLSL compilation");
+#else
+        return session->Compile(*info);
+#endif
+    }
+    catch (const std::exception &e)
+    {
+        return CreateErrorResult(e.what());
+    }
+}
+
+VD_EXPORT void DestroyGlslCompilerSession(GlslCompilerSession *session)
+{
+#ifndef VD_NO_GLSL_FRONTEND
+    delete session;
+#endif
+}
+
+// Copies the given info together with everything it points to, for compilations which outlive the call.
+std::shared_ptr<GlslCompileInfo> CopyGlslCompileInfo(const GlslCompileInfo &info)
+{
+    std::shared_ptr<GlslCompileInfo> copy = std::make_shared<GlslCompileInfo>();
+    copy->SourceText = info.SourceText;
+    copy->FileName = info.FileName;
+    copy->Kind = info.Kind;
+    copy->Debug = info.Debug;
+    copy->Macros = info.Macros;
+    copy->IncludeDirectories = InteropArray<InteropArray<char>>(info.IncludeDirectories.Count);
+    for (uint32_t i = 0; i < info.IncludeDirectories.Count; i++)
+    {
+        copy->IncludeDirectories[i] = info.IncludeDirectories[i];
+    }
+
+    return copy;
+}
+
+// Starts a CrossCompile call on the worker pool and returns straight away. The info and the arrays it
+// points to are copied, so they may be released once this returns. Returns null on failure.
+VD_EXPORT CompileTask *CrossCompileAsync(CrossCompileInfo *info)
+{
+    try
+    {
+        std::shared_ptr<CrossCompileInfo> copy = std::make_shared<CrossCompileInfo>(*info);
+        return new CompileTask([copy]() { return CrossCompile(copy.get()); });
+    }
+    catch (const std::exception &)
+    {
+        return nullptr;
+    }
+}
+
+// The asynchronous form of CompileGlslToSpirv. As with CrossCompileAsync, the info is copied.
+VD_EXPORT CompileTask *CompileGlslToSpirvAsync(GlslCompileInfo *info)
+{
+    try
+    {
+        std::shared_ptr<GlslCompileInfo> copy = CopyGlslCompileInfo(*info);
+        return new CompileTask([copy]() { return CompileGlslToSpirv(copy.get()); });
+    }
+    catch (const std::exception &)
+    {
+        return nullptr;
+    }
+}
+
+VD_EXPORT CompileTaskStatus GetCompileTaskStatus(CompileTask *task)
+{
+    return task->GetStatus();
+}
+
+// Returns true if the task finished within the given number of milliseconds. UINT32_MAX waits for as
+// long as it takes.
+VD_EXPORT Bool32 WaitCompileTask(CompileTask *task, uint32_t timeoutMilliseconds)
+{
+    return task->Wait(timeoutMilliseconds);
+}
+
+VD_EXPORT void CancelCompileTask(CompileTask *task)
+{
+    task->Cancel();
+}
+
+// Returns the result of a finished task, which the caller frees with FreeResult. A cancelled task has an
+// error result. Returns null while the task is still running and once the result was taken.
+VD_EXPORT CompilationResult *TakeCompileTaskResult(CompileTask *task)
+{
+    return task->TakeResult();
+}
+
+// Cancels the task if it is still running. An untaken result is freed once the task has stopped.
+VD_EXPORT void DestroyCompileTask(CompileTask *task)
+{
+    delete task;
+}
+
+VD_EXPORT ShaderBundleWriter *CreateShaderBundleWriter(Bool32 compress)
+{
+    return new ShaderBundleWriter(compress);
+}
+
+// Cross-compiles the given info for every target and adds the outcome to the bundle under the given key.
+// The compilation result is returned as well; it must be freed by the caller.
+VD_EXPORT CompilationResult *AddShaderBundleVariant(
+    ShaderBundleWriter *writer,
+    const char *key,
+    uint32_t keyLength,
+    CrossCompileInfo *info,
+    CrossCompileTarget *targets,
+    uint32_t targetCount)
+{
+    CallTimer call("AddShaderBundleVariant");
+    CompilationResult *result = nullptr;
+    try
+    {
+        result = Compile(*info, targets, targetCount);
+        if (result->Succeeded)
         {
-            const MacroDefinition &macro = info->Macros[i];
-            if (macro.ValueLength == 0)
-            {
-                options.AddMacroDefinition(std::string(macro.Name, macro.NameLength));
-            }
-            else
-            {
-                options.AddMacroDefinition(
-                    std::string(macro.Name, macro.NameLength),
-                    std::string(macro.Value, macro.ValueLength));
-            }
+            writer->AddVariant(std::string(key, keyLength), *info, targets, targetCount, *result);
         }
 
-        return CompileGLSLToSPIRV(
-            std::string(info->SourceText.Data, info->SourceText.Count),
-            info->Kind,
-            std::string(info->FileName.Data, info->FileName.Count),
-            options);
+        return result;
     }
-    catch (std::exception e)
+    catch (const std::exception &e)
+    {
+        if (result != nullptr)
+        {
+            DestroyResult(result);
+        }
+        return CreateErrorResult(e.what());
+    }
+}
+
+// Returns an empty result, or a failed one holding the error message.
+VD_EXPORT CompilationResult *WriteShaderBundle(ShaderBundleWriter *writer, const char *path)
+{
+    try
     {
-        return new CompilationResult(e.what());
+        writer->Write(path);
+        return CreateResult(nullptr, 0, nullptr);
+    }
+    catch (const std::exception &e)
+    {
+        return CreateErrorResult(e.what());
     }
 }
 
+VD_EXPORT void DestroyShaderBundleWriter(ShaderBundleWriter *writer)
+{
+    delete writer;
+}
+
+// Returns null if the file cannot be mapped or is not a valid bundle.
+VD_EXPORT ShaderBundle *OpenShaderBundle(const char *path)
+{
+    try
+    {
+        return new ShaderBundle(path);
+    }
+    catch (const std::exception &)
+    {
+        return nullptr;
+    }
+}
+
+VD_EXPORT uint32_t GetShaderBundleVariantCount(ShaderBundle *bundle)
+{
+    return bundle->GetVariantCount();
+}
+
+// Fills in views of the variant's tables, which stay valid until the bundle is closed.
+VD_EXPORT Bool32 FindShaderBundleVariant(
+    ShaderBundle *bundle,
+    const char *key,
+    uint32_t keyLength,
+    ShaderBundleVariant *variant)
+{
+    return bundle->Find(key, keyLength, *variant);
+}
+
+VD_EXPORT Bool32 ReadShaderBundleBlob(
+    ShaderBundle *bundle,
+    const ShaderBundleBlob *blob,
+    uint8_t *destination,
+    uint64_t size)
+{
+    return bundle->ReadBlob(*blob, destination, static_cast<size_t>(size));
+}
+
+VD_EXPORT void CloseShaderBundle(ShaderBundle *bundle)
+{
+    delete bundle;
+}
+
 VD_EXPORT void FreeResult(CompilationResult *result)
 {
-    delete result;
+    if (!GetCrossCompileCache().Release(result))
+    {
+        DestroyResult(result);
+    }
+}
+
+VD_EXPORT void SetCrossCompileCacheCapacity(uint32_t capacity)
+{
+    GetCrossCompileCache().SetCapacity(capacity);
+}
+
+VD_EXPORT void ClearCrossCompileCache()
+{
+    GetCrossCompileCache().Clear();
+}
+
+VD_EXPORT void GetCrossCompileCacheStatistics(CacheStatistics *stats)
+{
+    GetCrossCompileCache().GetStatistics(*stats);
+}
+
+// Turns the per-phase timers of all compilation entry points on or off. They are off by default.
+VD_EXPORT void SetCompileInstrumentation(Bool32 enabled)
+{
+    SetPhaseTimingEnabled(enabled);
+}
+
+VD_EXPORT void GetCompileStatistics(CompileStatistics *stats)
+{
+    GetPhaseTimings(*stats);
+}
+
+VD_EXPORT void ResetCompileStatistics()
+{
+    ResetPhaseTimings();
+}
+
+// Starts recording every call and phase as a trace span. This turns the per-phase timers on.
+VD_EXPORT void BeginCompileTrace()
+{
+    BeginPhaseTrace();
+}
+
+// Stops recording and writes the spans recorded since BeginCompileTrace to the given path as Chrome trace
+// event JSON. Returns false if the file could not be written.
+VD_EXPORT Bool32 EndCompileTrace(const char *path)
+{
+    try
+    {
+        EndPhaseTrace(path);
+        return true;
+    }
+    catch (const std::exception &)
+    {
+        return false;
+    }
+}
+
+VD_EXPORT Bool32 GetSpirvFingerprint(const uint32_t *words, uint32_t wordCount, Hash128 *fingerprint)
+{
+    *fingerprint = Hash128();
+    return FingerprintSpirv(words, wordCount, *fingerprint);
 }
 
 const VertexElementFormat FloatFormats[] =
@@ -707,7 +1589,7 @@ const VertexElementFormat UIntFormats[] =
         VertexElementFormat::UInt4,
 };
 
-void ReflectVertexInfo(const Compiler &compiler, const ShaderResources &resources, ReflectionInfo &info)
+void ReflectVertexInfo(const Compiler &compiler, const ShaderResources &resources, ReflectionData &info)
 {
     uint32_t elementCount = 0;
     for (const auto &input : resources.stage_inputs)
@@ -716,7 +1598,7 @@ void ReflectVertexInfo(const Compiler &compiler, const ShaderResources &resource
         elementCount = std::max(location + 1, elementCount);
     }
 
-    info.VertexElements = InteropArray<VertexElementDescription>(elementCount);
+    info.VertexElements.resize(elementCount);
 
     for (const auto &input : resources.stage_inputs)
     {
@@ -727,7 +1609,7 @@ void ReflectVertexInfo(const Compiler &compiler, const ShaderResources &resource
         {
             name = compiler.get_fallback_name(input.id);
         }
-        info.VertexElements[location].Name.CopyFrom(name.size(), name.c_str());
+        info.VertexElements[location].Name = name;
         SPIRType baseType = compiler.get_type(input.base_type_id);
         SPIRType type = compiler.get_type(input.type_id);
         switch (baseType.basetype)
@@ -0,0 +1,604 @@
+// veldrid-spirv-bench: measures CrossCompile and CompileGlslToSpirv over a directory of test shaders and
+// a set of generated large shaders, and writes the results as JSON.
+//
+// Usage: veldrid-spirv-bench <shader-directory> [--iterations N] [--scale N] [--output path] [--trace path]
+//
+// The shader directory is searched for "<name>.vert.spv" / "<name>.frag.spv" pairs, "<name>.comp.spv"
+// modules and the matching GLSL sources, as laid out in src/Veldrid.SPIRV.Tests/TestShaders. With --trace,
+// every measured call is also written to the given path as a Chrome trace.
+
+#include "libveldrid-spirv.hpp"
+#include "InteropStructs.hpp"
+#include "PhaseTimer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace Veldrid
+{
+VD_EXPORT CompilationResult *CrossCompile(CrossCompileInfo *info);
+VD_EXPORT CompilationResult *CompileGlslToSpirv(GlslCompileInfo *info);
+VD_EXPORT void FreeResult(CompilationResult *result);
+VD_EXPORT void SetCrossCompileCacheCapacity(uint32_t capacity);
+VD_EXPORT void SetCompileServer(const char *socketPath);
+} // namespace Veldrid
+
+using namespace Veldrid;
+
+// Counts every allocation made through operator new, including those made inside SPIRV-Cross and shaderc,
+// which are linked into this executable.
+static std::atomic<uint64_t> g_allocationCount(0);
+static std::atomic<uint64_t> g_allocatedBytes(0);
+
+void *operator new(size_t size)
+{
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    void *ret = malloc(size > 0 ? size : 1);
+    if (ret == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ret;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *pointer) noexcept
+{
+    free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept
+{
+    free(pointer);
+}
+
+void operator delete[](void *pointer, size_t) noexcept
+{
+    free(pointer);
+}
+
+namespace
+{
+const CrossCompileTarget Targets[] = { HLSL, GLSL, ESSL, MSL };
+const char *const TargetNames[] = { "HLSL", "GLSL", "ESSL", "MSL" };
+
+struct ShaderSet
+{
+    std::string Name;
+    std::vector<uint32_t> VertexShader;
+    std::vector<uint32_t> FragmentShader;
+    std::vector<uint32_t> ComputeShader;
+};
+
+struct GlslSource
+{
+    std::string Name;
+    std::string Text;
+    shaderc_shader_kind Kind;
+};
+
+struct Measurement
+{
+    std::string Name;
+    std::string Operation;
+    std::string Target;
+    uint32_t Iterations = 0;
+    uint64_t InputBytes = 0;
+    uint64_t OutputBytes = 0;
+    std::vector<uint64_t> Samples;
+    uint64_t Allocations = 0;
+    uint64_t AllocatedBytes = 0;
+    CompileStatistics Phases = {};
+    std::string Error;
+};
+
+struct Options
+{
+    std::string ShaderDirectory;
+    std::string OutputPath;
+    std::string TracePath;
+    uint32_t Iterations = 20;
+    uint32_t Scale = 64;
+};
+
+std::string ReadFile(const std::filesystem::path &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Unable to open " + path.string());
+    }
+
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+std::vector<uint32_t> ReadSpirv(const std::filesystem::path &path)
+{
+    std::string bytes = ReadFile(path);
+    std::vector<uint32_t> words(bytes.size() / sizeof(uint32_t));
+    memcpy(words.data(), bytes.data(), words.size() * sizeof(uint32_t));
+    return words;
+}
+
+bool EndsWith(const std::string &value, const std::string &suffix)
+{
+    return value.size() >= suffix.size() && value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+void LoadCorpus(const std::string &directory, std::vector<ShaderSet> &sets, std::vector<GlslSource> &sources)
+{
+    std::map<std::string, ShaderSet> byName;
+    for (const std::filesystem::directory_entry &entry : std::filesystem::directory_iterator(directory))
+    {
+        std::string fileName = entry.path().filename().string();
+        if (EndsWith(fileName, ".vert.spv"))
+        {
+            std::string name = fileName.substr(0, fileName.size() - 9);
+            byName[name].VertexShader = ReadSpirv(entry.path());
+        }
+        else if (EndsWith(fileName, ".frag.spv"))
+        {
+            std::string name = fileName.substr(0, fileName.size() - 9);
+            byName[name].FragmentShader = ReadSpirv(entry.path());
+        }
+        else if (EndsWith(fileName, ".comp.spv"))
+        {
+            std::string name = fileName.substr(0, fileName.size() - 9);
+            byName[name].ComputeShader = ReadSpirv(entry.path());
+        }
+        else if (EndsWith(fileName, ".vert"))
+        {
+            sources.push_back({ fileName, ReadFile(entry.path()), shaderc_vertex_shader });
+        }
+        else if (EndsWith(fileName, ".frag"))
+        {
+            sources.push_back({ fileName, ReadFile(entry.path()), shaderc_fragment_shader });
+        }
+        else if (EndsWith(fileName, ".comp"))
+        {
+            sources.push_back({ fileName, ReadFile(entry.path()), shaderc_compute_shader });
+        }
+    }
+
+    for (auto &it : byName)
+    {
+        ShaderSet &set = it.second;
+        bool vertexFragment = !set.VertexShader.empty() && !set.FragmentShader.empty();
+        if (vertexFragment || !set.ComputeShader.empty())
+        {
+            if (vertexFragment)
+            {
+                set.ComputeShader.clear();
+            }
+            set.Name = it.first;
+            sets.push_back(std::move(set));
+        }
+    }
+
+    std::sort(sources.begin(), sources.end(), [](const GlslSource &a, const GlslSource &b) { return a.Name < b.Name; });
+}
+
+// Generates shaders whose size grows with the scale: one uniform block, texture and interpolant per unit of
+// scale in the graphics pair, and one storage buffer per unit of scale in the compute shader.
+void GenerateSyntheticSources(uint32_t scale, std::vector<GlslSource> &sources)
+{
+    uint32_t interpolants = std::min(scale, 15u);
+    std::ostringstream vs;
+    vs << "#version 450\n";
+    vs << "layout(location = 0) in vec4 Position;\n";
+    for (uint32_t i = 0; i < scale; i++)
+    {
+        vs << "layout(set = 0, binding = " << i << ") uniform Block" << i << " { mat4 Transform" << i << "; vec4 Offset" << i << "; };\n";
+    }
+    for (uint32_t i = 0; i < interpolants; i++)
+    {
+        vs << "layout(location = " << i << ") out vec4 Interpolant" << i << ";\n";
+    }
+    vs << "void main()\n{\n    vec4 position = Position;\n";
+    for (uint32_t i = 0; i < scale; i++)
+    {
+        vs << "    position = Transform" << i << " * position + Offset" << i << ";\n";
+    }
+    for (uint32_t i = 0; i < interpolants; i++)
+    {
+        vs << "    Interpolant" << i << " = position * " << (i + 1) << ".0;\n";
+    }
+    vs << "    gl_Position = position;\n}\n";
+
+    std::ostringstream fs;
+    fs << "#version 450\n";
+    for (uint32_t i = 0; i < interpolants; i++)
+    {
+        fs << "layout(location = " << i << ") in vec4 Interpolant" << i << ";\n";
+    }
+    fs << "layout(set = 1, binding = 0) uniform sampler Sampler;\n";
+    for (uint32_t i = 0; i < scale; i++)
+    {
+        fs << "layout(set = 1, binding = " << (i + 1) << ") uniform texture2D Texture" << i << ";\n";
+    }
+    fs << "layout(location = 0) out vec4 Color;\n";
+    fs << "void main()\n{\n    vec4 color = vec4(0);\n";
+    for (uint32_t i = 0; i < scale; i++)
+    {
+        fs << "    color += texture(sampler2D(Texture" << i << ", Sampler), Interpolant" << (i % interpolants) << ".xy);\n";
+    }
+    fs << "    Color = color;\n}\n";
+
+    std::ostringstream cs;
+    cs << "#version 450\n";
+    cs << "layout(local_size_x = 64) in;\n";
+    for (uint32_t i = 0; i < scale; i++)
+    {
+        cs << "layout(set = 0, binding = " << i << ") buffer Buffer" << i << " { vec4 Data" << i << "[]; };\n";
+    }
+    cs << "void main()\n{\n    uint index = gl_GlobalInvocationID.x;\n    vec4 value = vec4(0);\n";
+    for (uint32_t i = 0; i < scale; i++)
+    {
+        cs << "    value += Data" << i << "[index];\n";
+        cs << "    Data" << i << "[index] = value;\n";
+    }
+    cs << "}\n";
+
+    std::string suffix = "-" + std::to_string(scale);
+    sources.push_back({ "synthetic" + suffix + ".vert", vs.str(), shaderc_vertex_shader });
+    sources.push_back({ "synthetic" + suffix + ".frag", fs.str(), shaderc_fragment_shader });
+    sources.push_back({ "synthetic" + suffix + ".comp", cs.str(), shaderc_compute_shader });
+}
+
+void SetGlslInfo(GlslCompileInfo &info, const GlslSource &source)
+{
+    info.SourceText.Count = static_cast<uint32_t>(source.Text.size());
+    info.SourceText.Data = const_cast<char *>(source.Text.data());
+    info.FileName.Count = static_cast<uint32_t>(source.Name.size());
+    info.FileName.Data = const_cast<char *>(source.Name.data());
+    info.Kind = source.Kind;
+    info.Debug = false;
+}
+
+std::string GetErrorMessage(const CompilationResult *result)
+{
+    if (result->DataBuffers.Count == 0)
+    {
+        return "Unknown error.";
+    }
+
+    const InteropArray<uint8_t> &message = result->DataBuffers[0];
+    return std::string(reinterpret_cast<const char *>(message.Data), message.Count);
+}
+
+uint64_t GetOutputBytes(const CompilationResult *result)
+{
+    uint64_t size = 0;
+    for (uint32_t i = 0; i < result->DataBuffers.Count; i++)
+    {
+        size += result->DataBuffers[i].Count;
+    }
+    return size;
+}
+
+// Runs one warm-up call followed by the measured iterations. Allocation and phase counters are taken
+// over the measured iterations only.
+template <typename TCall>
+Measurement Measure(uint32_t iterations, TCall call)
+{
+    Measurement measurement;
+    measurement.Iterations = iterations;
+
+    CompilationResult *warmUp = call();
+    if (!warmUp->Succeeded)
+    {
+        measurement.Error = GetErrorMessage(warmUp);
+        FreeResult(warmUp);
+        measurement.Iterations = 0;
+        return measurement;
+    }
+    measurement.OutputBytes = GetOutputBytes(warmUp);
+    FreeResult(warmUp);
+
+    ResetPhaseTimings();
+    uint64_t allocationCount = g_allocationCount.load();
+    uint64_t allocatedBytes = g_allocatedBytes.load();
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        CompilationResult *result = call();
+        FreeResult(result);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        measurement.Samples.push_back(
+            static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+    measurement.Allocations = g_allocationCount.load() - allocationCount;
+    measurement.AllocatedBytes = g_allocatedBytes.load() - allocatedBytes;
+    GetPhaseTimings(measurement.Phases);
+    return measurement;
+}
+
+Measurement MeasureCrossCompile(const ShaderSet &set, uint32_t targetIndex, uint32_t iterations)
+{
+    Borrowed<CrossCompileInfo> info;
+    memset(static_cast<void *>(&info.Value), 0, sizeof(CrossCompileInfo));
+    info.Value.Target = Targets[targetIndex];
+    info.Value.FixClipSpaceZ = true;
+    info.Value.InvertY = false;
+    info.Value.NormalizeResourceNames = false;
+    const std::vector<uint32_t> *modules[3] = { &set.VertexShader, &set.FragmentShader, &set.ComputeShader };
+    InteropArray<uint32_t> *arrays[3] = { &info.Value.VertexShader, &info.Value.FragmentShader, &info.Value.ComputeShader };
+    uint64_t inputBytes = 0;
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        arrays[i]->Count = static_cast<uint32_t>(modules[i]->size());
+        arrays[i]->Data = const_cast<uint32_t *>(modules[i]->data());
+        inputBytes += modules[i]->size() * sizeof(uint32_t);
+    }
+
+    Measurement measurement = Measure(iterations, [&]() { return CrossCompile(&info.Value); });
+    measurement.Name = set.Name;
+    measurement.Operation = "CrossCompile";
+    measurement.Target = TargetNames[targetIndex];
+    measurement.InputBytes = inputBytes;
+    return measurement;
+}
+
+Measurement MeasureGlslCompile(const GlslSource &source, uint32_t iterations)
+{
+    Borrowed<GlslCompileInfo> info;
+    memset(static_cast<void *>(&info.Value), 0, sizeof(GlslCompileInfo));
+    SetGlslInfo(info.Value, source);
+
+    Measurement measurement = Measure(iterations, [&]() { return CompileGlslToSpirv(&info.Value); });
+    measurement.Name = source.Name;
+    measurement.Operation = "CompileGlslToSpirv";
+    measurement.InputBytes = source.Text.size();
+    return measurement;
+}
+
+// Compiles the generated sources once so that their SPIR-V can be cross-compiled like the corpus.
+ShaderSet CompileSyntheticSet(const std::string &name, const GlslSource *first, const GlslSource *second)
+{
+    ShaderSet set;
+    set.Name = name;
+    const GlslSource *sources[2] = { first, second };
+    for (const GlslSource *source : sources)
+    {
+        if (source == nullptr)
+        {
+            continue;
+        }
+
+        Borrowed<GlslCompileInfo> info;
+        memset(static_cast<void *>(&info.Value), 0, sizeof(GlslCompileInfo));
+        SetGlslInfo(info.Value, *source);
+        CompilationResult *result = CompileGlslToSpirv(&info.Value);
+        if (!result->Succeeded)
+        {
+            std::string message = GetErrorMessage(result);
+            FreeResult(result);
+            throw std::runtime_error(source->Name + ": " + message);
+        }
+
+        const InteropArray<uint8_t> &spirv = result->DataBuffers[0];
+        std::vector<uint32_t> words(spirv.Count / sizeof(uint32_t));
+        memcpy(words.data(), spirv.Data, words.size() * sizeof(uint32_t));
+        FreeResult(result);
+
+        switch (source->Kind)
+        {
+        case shaderc_vertex_shader: set.VertexShader = std::move(words); break;
+        case shaderc_fragment_shader: set.FragmentShader = std::move(words); break;
+        default: set.ComputeShader = std::move(words); break;
+        }
+    }
+
+    return set;
+}
+
+std::string EscapeJson(const std::string &value)
+{
+    std::string ret;
+    for (char c : value)
+    {
+        switch (c)
+        {
+        case '"': ret += "\\\""; break;
+        case '\\': ret += "\\\\"; break;
+        case '\n': ret += "\\n"; break;
+        case '\r': ret += "\\r"; break;
+        case '\t': ret += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                ret += escaped;
+            }
+            else
+            {
+                ret += c;
+            }
+        }
+    }
+    return ret;
+}
+
+void WriteMeasurement(std::ostream &out, const Measurement &m)
+{
+    out << "    {\n";
+    out << "      \"name\": \"" << EscapeJson(m.Name) << "\",\n";
+    out << "      \"operation\": \"" << m.Operation << "\",\n";
+    if (!m.Target.empty())
+    {
+        out << "      \"target\": \"" << m.Target << "\",\n";
+    }
+    if (!m.Error.empty())
+    {
+        out << "      \"error\": \"" << EscapeJson(m.Error) << "\"\n";
+        out << "    }";
+        return;
+    }
+
+    std::vector<uint64_t> sorted = m.Samples;
+    std::sort(sorted.begin(), sorted.end());
+    uint64_t total = 0;
+    for (uint64_t sample : sorted)
+    {
+        total += sample;
+    }
+    double meanNs = sorted.empty() ? 0.0 : static_cast<double>(total) / sorted.size();
+    double throughput = meanNs > 0.0 ? (m.InputBytes / (1024.0 * 1024.0)) / (meanNs * 1e-9) : 0.0;
+
+    out << "      \"iterations\": " << m.Iterations << ",\n";
+    out << "      \"inputBytes\": " << m.InputBytes << ",\n";
+    out << "      \"outputBytes\": " << m.OutputBytes << ",\n";
+    out << "      \"meanNs\": " << static_cast<uint64_t>(meanNs) << ",\n";
+    out << "      \"minNs\": " << (sorted.empty() ? 0 : sorted.front()) << ",\n";
+    out << "      \"medianNs\": " << (sorted.empty() ? 0 : sorted[sorted.size() / 2]) << ",\n";
+    out << "      \"maxNs\": " << (sorted.empty() ? 0 : sorted.back()) << ",\n";
+    out << "      \"throughputMiBPerSecond\": " << throughput << ",\n";
+    out << "      \"allocationsPerIteration\": " << (m.Iterations > 0 ? m.Allocations / m.Iterations : 0) << ",\n";
+    out << "      \"allocatedBytesPerIteration\": " << (m.Iterations > 0 ? m.AllocatedBytes / m.Iterations : 0) << ",\n";
+    out << "      \"phases\": {";
+    for (uint32_t i = 0; i < static_cast<uint32_t>(CompilePhase::Count); i++)
+    {
+        uint64_t perIteration = m.Iterations > 0 ? m.Phases.Phases[i].Nanoseconds / m.Iterations : 0;
+        out << (i == 0 ? " " : ", ") << "\"" << GetPhaseName(static_cast<CompilePhase>(i)) << "Ns\": " << perIteration;
+    }
+    out << " }\n";
+    out << "    }";
+}
+
+bool ParseOptions(int argc, char **argv, Options &options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--iterations" && hasValue)
+        {
+            options.Iterations = static_cast<uint32_t>(std::max(1, atoi(argv[++i])));
+        }
+        else if (arg == "--scale" && hasValue)
+        {
+            options.Scale = static_cast<uint32_t>(std::max(1, atoi(argv[++i])));
+        }
+        else if (arg == "--output" && hasValue)
+        {
+            options.OutputPath = argv[++i];
+        }
+        else if (arg == "--trace" && hasValue)
+        {
+            options.TracePath = argv[++i];
+        }
+        else if (options.ShaderDirectory.empty() && arg.compare(0, 2, "--") != 0)
+        {
+            options.ShaderDirectory = arg;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return !options.ShaderDirectory.empty();
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        std::cerr << "Usage: veldrid-spirv-bench <shader-directory> [--iterations N] [--scale N] [--output path] [--trace path]" << std::endl;
+        return 2;
+    }
+
+    try
+    {
+        SetCrossCompileCacheCapacity(0);
+        SetCompileServer(nullptr);
+        SetPhaseTimingEnabled(true);
+        if (!options.TracePath.empty())
+        {
+            BeginPhaseTrace();
+        }
+
+        std::vector<ShaderSet> sets;
+        std::vector<GlslSource> sources;
+        LoadCorpus(options.ShaderDirectory, sets, sources);
+
+        std::vector<GlslSource> synthetic;
+        GenerateSyntheticSources(options.Scale, synthetic);
+        std::string syntheticName = "synthetic-" + std::to_string(options.Scale);
+        sets.push_back(CompileSyntheticSet(syntheticName, &synthetic[0], &synthetic[1]));
+        sets.push_back(CompileSyntheticSet(syntheticName + "-compute", &synthetic[2], nullptr));
+        sources.insert(sources.end(), synthetic.begin(), synthetic.end());
+
+        std::vector<Measurement> measurements;
+        for (const ShaderSet &set : sets)
+        {
+            for (uint32_t target = 0; target < sizeof(Targets) / sizeof(Targets[0]); target++)
+            {
+                measurements.push_back(MeasureCrossCompile(set, target, options.Iterations));
+            }
+        }
+        for (const GlslSource &source : sources)
+        {
+            measurements.push_back(MeasureGlslCompile(source, options.Iterations));
+        }
+
+        if (!options.TracePath.empty())
+        {
+            EndPhaseTrace(options.TracePath);
+        }
+
+        std::ofstream file;
+        if (!options.OutputPath.empty())
+        {
+            file.open(options.OutputPath);
+            if (!file)
+            {
+                throw std::runtime_error("Unable to open " + options.OutputPath);
+            }
+        }
+        std::ostream &out = options.OutputPath.empty() ? std::cout : file;
+
+        out << "{\n  \"benchmarks\": [\n";
+        for (size_t i = 0; i < measurements.size(); i++)
+        {
+            WriteMeasurement(out, measurements[i]);
+            out << (i + 1 < measurements.size() ? ",\n" : "\n");
+        }
+        out << "  ]\n}\n";
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
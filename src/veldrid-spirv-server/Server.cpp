@@ -0,0 +1,105 @@
+// veldrid-spirv-server: a long-running compile server for build machines. Processes which load
+// libveldrid-spirv forward their CrossCompile and CompileGlslToSpirv calls to it when they are started
+// with VELDRID_SPIRV_COMPILE_SERVER set to the server's socket path, or after calling SetCompileServer.
+// They then share one warm set of compilers, one worker pool and one result cache.
+//
+// Usage: veldrid-spirv-server <socket-path> [--threads N] [--cache-capacity N] [--glsl-cache directory]
+//
+// The server runs until it receives SIGINT or SIGTERM, and removes its socket file when it exits.
+
+#include "CompileServer.hpp"
+#include "ResultCache.hpp"
+#include "SpirvDiskCache.hpp"
+#include "ThreadPool.hpp"
+#include <iostream>
+#include <signal.h>
+#include <stdlib.h>
+#include <string>
+
+using namespace Veldrid;
+
+namespace
+{
+struct Options
+{
+    std::string SocketPath;
+    std::string GlslCacheDirectory;
+    uint32_t ThreadCount = 0;
+    uint32_t CacheCapacity = 4096;
+};
+
+CompileServer *g_server = nullptr;
+
+void HandleStopSignal(int)
+{
+    if (g_server != nullptr)
+    {
+        g_server->Stop();
+    }
+}
+
+bool ParseOptions(int argc, char **argv, Options &options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--threads" && hasValue)
+        {
+            options.ThreadCount = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--cache-capacity" && hasValue)
+        {
+            options.CacheCapacity = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--glsl-cache" && hasValue)
+        {
+            options.GlslCacheDirectory = argv[++i];
+        }
+        else if (options.SocketPath.empty() && arg.compare(0, 2, "--") != 0)
+        {
+            options.SocketPath = arg;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return !options.SocketPath.empty();
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        std::cerr << "Usage: veldrid-spirv-server <socket-path> [--threads N] [--cache-capacity N] [--glsl-cache directory]" << std::endl;
+        return 2;
+    }
+
+    try
+    {
+        SetWorkerPoolThreadCount(options.ThreadCount);
+        GetCrossCompileCache().SetCapacity(options.CacheCapacity);
+        GetSpirvDiskCache().SetDirectory(options.GlslCacheDirectory);
+
+        CompileServer server(options.SocketPath);
+        g_server = &server;
+        signal(SIGINT, HandleStopSignal);
+        signal(SIGTERM, HandleStopSignal);
+        signal(SIGPIPE, SIG_IGN);
+
+        std::cerr << "Listening on " << options.SocketPath << std::endl;
+        server.Run();
+        g_server = nullptr;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}